@@ -0,0 +1,286 @@
+//
+// Copyright(c) 2015 Gabi Melman.
+// Distributed under the MIT License (http://opensource.org/licenses/MIT)
+//
+
+//
+// async_sweep.cpp : async logger throughput and producer latency across a grid of
+// queue sizes, producer threads, thread pool threads, message sizes and overflow policies.
+// Each configuration is a CSV row, for plotting and for sizing init_thread_pool().
+//
+// Usage: async_sweep [messages=N] [queue=a,b,..] [producers=a,b,..] [pool=a,b,..] [size=a,b,..]
+//                    [policy=block,overrun] [sink=null|file] [out=file.csv]
+//
+#include "spdlog/spdlog.h"
+#include "spdlog/async.h"
+#include "spdlog/sinks/basic_file_sink.h"
+#include "spdlog/sinks/null_sink.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace std::chrono;
+
+struct sweep_config
+{
+    size_t messages = 200000;
+    std::vector<size_t> queue_sizes{1024, 8192, 65536, 1048576};
+    std::vector<size_t> producers{1, 2, 4, 8, 16, 32, 64, 128};
+    std::vector<size_t> pool_threads{1, 2, 4, 8};
+    std::vector<size_t> msg_sizes{16, 64, 256, 1024, 4096};
+    std::vector<spdlog::async_overflow_policy> policies{
+        spdlog::async_overflow_policy::block, spdlog::async_overflow_policy::overrun_oldest};
+    bool file_sink = false;
+    std::string out;
+};
+
+struct sweep_result
+{
+    double elapsed_secs;  // from the first message until the queue has been drained
+    double producer_secs; // until the last producer returned
+    int64_t p50_ns;
+    int64_t p99_ns;
+    int64_t p999_ns;
+    int64_t max_ns;
+    size_t dropped;
+};
+
+static const char *policy_name(spdlog::async_overflow_policy policy)
+{
+    return policy == spdlog::async_overflow_policy::block ? "block" : "overrun_oldest";
+}
+
+static std::vector<size_t> parse_list(const char *s)
+{
+    std::vector<size_t> values;
+    while (*s != '\0')
+    {
+        char *end = nullptr;
+        auto value = std::strtoull(s, &end, 10);
+        if (end == s)
+        {
+            break;
+        }
+        values.push_back(static_cast<size_t>(value));
+        s = *end == ',' ? end + 1 : end;
+    }
+    return values;
+}
+
+static bool parse_args(int argc, char *argv[], sweep_config &config)
+{
+    for (int i = 1; i < argc; ++i)
+    {
+        const char *arg = argv[i];
+        const char *eq = std::strchr(arg, '=');
+        if (eq == nullptr)
+        {
+            return false;
+        }
+        std::string key(arg, eq);
+        const char *value = eq + 1;
+        if (key == "messages")
+        {
+            config.messages = static_cast<size_t>(std::strtoull(value, nullptr, 10));
+        }
+        else if (key == "queue")
+        {
+            config.queue_sizes = parse_list(value);
+        }
+        else if (key == "producers")
+        {
+            config.producers = parse_list(value);
+        }
+        else if (key == "pool")
+        {
+            config.pool_threads = parse_list(value);
+        }
+        else if (key == "size")
+        {
+            config.msg_sizes = parse_list(value);
+        }
+        else if (key == "policy")
+        {
+            config.policies.clear();
+            if (std::strstr(value, "block") != nullptr)
+            {
+                config.policies.push_back(spdlog::async_overflow_policy::block);
+            }
+            if (std::strstr(value, "overrun") != nullptr)
+            {
+                config.policies.push_back(spdlog::async_overflow_policy::overrun_oldest);
+            }
+        }
+        else if (key == "sink")
+        {
+            config.file_sink = std::strcmp(value, "file") == 0;
+        }
+        else if (key == "out")
+        {
+            config.out = value;
+        }
+        else
+        {
+            return false;
+        }
+    }
+    return config.messages > 0 && !config.queue_sizes.empty() && !config.producers.empty() && !config.pool_threads.empty() &&
+           !config.msg_sizes.empty() && !config.policies.empty();
+}
+
+static sweep_result run_one(const sweep_config &config, size_t queue_size, size_t producers, size_t pool_threads, size_t msg_size,
+    spdlog::async_overflow_policy policy)
+{
+    auto tp = std::make_shared<spdlog::details::thread_pool>(queue_size, pool_threads);
+    spdlog::sink_ptr sink;
+    if (config.file_sink)
+    {
+        sink = std::make_shared<spdlog::sinks::basic_file_sink_mt>("logs/async_sweep.log", true);
+    }
+    else
+    {
+        sink = std::make_shared<spdlog::sinks::null_sink_mt>();
+    }
+    auto logger = std::make_shared<spdlog::async_logger>("async_sweep", std::move(sink), tp, policy);
+
+    const std::string payload(msg_size, 'x');
+    const size_t per_thread = (std::max)(config.messages / producers, size_t(1));
+    std::vector<std::vector<int64_t>> latencies(producers);
+    std::atomic<size_t> ready{0};
+    std::atomic<bool> go{false};
+
+    std::vector<std::thread> threads;
+    threads.reserve(producers);
+    for (size_t t = 0; t < producers; ++t)
+    {
+        threads.emplace_back([&, t] {
+            auto &samples = latencies[t];
+            samples.reserve(per_thread);
+            ready.fetch_add(1);
+            while (!go.load(std::memory_order_acquire))
+            {
+                std::this_thread::yield();
+            }
+            for (size_t i = 0; i < per_thread; ++i)
+            {
+                auto start = steady_clock::now();
+                logger->info(payload);
+                samples.push_back(duration_cast<nanoseconds>(steady_clock::now() - start).count());
+            }
+        });
+    }
+
+    while (ready.load() < producers)
+    {
+        std::this_thread::yield();
+    }
+    auto start = steady_clock::now();
+    go.store(true, std::memory_order_release);
+    for (auto &t : threads)
+    {
+        t.join();
+    }
+    auto producers_done = steady_clock::now();
+
+    // the thread pool destructor joins its workers after they drained the queue
+    auto dropped = tp->overrun_counter();
+    logger.reset();
+    tp.reset();
+    auto drained = steady_clock::now();
+
+    std::vector<int64_t> all;
+    all.reserve(per_thread * producers);
+    for (auto &samples : latencies)
+    {
+        all.insert(all.end(), samples.begin(), samples.end());
+    }
+    std::sort(all.begin(), all.end());
+    auto percentile = [&all](double p) { return all[static_cast<size_t>(p * static_cast<double>(all.size() - 1))]; };
+
+    sweep_result result;
+    result.elapsed_secs = duration_cast<duration<double>>(drained - start).count();
+    result.producer_secs = duration_cast<duration<double>>(producers_done - start).count();
+    result.p50_ns = percentile(0.5);
+    result.p99_ns = percentile(0.99);
+    result.p999_ns = percentile(0.999);
+    result.max_ns = all.back();
+    result.dropped = dropped;
+    return result;
+}
+
+int main(int argc, char *argv[])
+{
+    sweep_config config;
+    if (!parse_args(argc, argv, config))
+    {
+        std::fprintf(stderr,
+            "Usage: %s [messages=N] [queue=a,b,..] [producers=a,b,..] [pool=a,b,..] [size=a,b,..] [policy=block,overrun] "
+            "[sink=null|file] [out=file.csv]\n",
+            argv[0]);
+        return EXIT_FAILURE;
+    }
+
+    std::FILE *out = stdout;
+    if (!config.out.empty())
+    {
+        out = std::fopen(config.out.c_str(), "w");
+        if (out == nullptr)
+        {
+            std::perror(config.out.c_str());
+            return EXIT_FAILURE;
+        }
+    }
+
+    try
+    {
+        std::fprintf(out, "queue_size,producers,pool_threads,msg_size,policy,messages,elapsed_secs,msgs_per_sec,producer_msgs_per_sec,"
+                          "p50_ns,p99_ns,p99.9_ns,max_ns,dropped\n");
+        auto runs = config.queue_sizes.size() * config.producers.size() * config.pool_threads.size() * config.msg_sizes.size() *
+                    config.policies.size();
+        size_t run = 0;
+        for (auto queue_size : config.queue_sizes)
+        {
+            for (auto producers : config.producers)
+            {
+                for (auto pool_threads : config.pool_threads)
+                {
+                    for (auto msg_size : config.msg_sizes)
+                    {
+                        for (auto policy : config.policies)
+                        {
+                            std::fprintf(stderr, "[%zu/%zu] queue=%zu producers=%zu pool=%zu size=%zu policy=%s\n", ++run, runs, queue_size,
+                                producers, pool_threads, msg_size, policy_name(policy));
+                            auto r = run_one(config, queue_size, producers, pool_threads, msg_size, policy);
+                            auto messages = (std::max)(config.messages / producers, size_t(1)) * producers;
+                            auto msgs = static_cast<double>(messages);
+                            std::fprintf(out, "%zu,%zu,%zu,%zu,%s,%zu,%.6f,%.0f,%.0f,%lld,%lld,%lld,%lld,%zu\n", queue_size, producers,
+                                pool_threads, msg_size, policy_name(policy), messages, r.elapsed_secs, msgs / r.elapsed_secs,
+                                msgs / r.producer_secs, static_cast<long long>(r.p50_ns), static_cast<long long>(r.p99_ns),
+                                static_cast<long long>(r.p999_ns), static_cast<long long>(r.max_ns), r.dropped);
+                            std::fflush(out);
+                        }
+                    }
+                }
+            }
+        }
+    }
+    catch (std::exception &ex)
+    {
+        std::fprintf(stderr, "Error: %s\n", ex.what());
+        return EXIT_FAILURE;
+    }
+
+    if (out != stdout)
+    {
+        std::fclose(out);
+    }
+    return EXIT_SUCCESS;
+}
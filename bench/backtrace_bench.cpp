@@ -0,0 +1,72 @@
+//
+// Copyright(c) 2015 Gabi Melman.
+// Distributed under the MIT License (http://opensource.org/licenses/MIT)
+//
+
+//
+// backtrace_bench.cpp : cost of storing a message for the backtrace only (below the logger level).
+//
+// eager:    format the message, then copy it into the ring
+// deferred: copy the format string and the arguments into the ring slot, format on dump_backtrace()
+//
+
+#include "benchmark/benchmark.h"
+
+#include "spdlog/spdlog.h"
+#include "spdlog/details/backtracer.h"
+#include "spdlog/sinks/null_sink.h"
+
+#include <string>
+
+static const char *fmt_str = "Hello logger: msg number {}, some text {} and a double {:.3f}";
+
+void bench_eager(benchmark::State &state)
+{
+    spdlog::details::backtracer tracer;
+    tracer.enable(32);
+    std::string text = "some more text";
+    int i = 0;
+    for (auto _ : state)
+    {
+        spdlog::memory_buf_t buf;
+        fmt::format_to(buf, fmt_str, ++i, text, 3.14);
+        spdlog::details::log_msg msg("backtrace", spdlog::level::debug, spdlog::string_view_t(buf.data(), buf.size()));
+        tracer.push_back(msg);
+    }
+}
+
+void bench_deferred(benchmark::State &state)
+{
+    spdlog::details::backtracer tracer;
+    tracer.enable(32);
+    std::string text = "some more text";
+    int i = 0;
+    for (auto _ : state)
+    {
+        spdlog::details::log_msg msg("backtrace", spdlog::level::debug, spdlog::string_view_t{});
+        tracer.push_back_deferred(msg, fmt_str, ++i, text, 3.14);
+    }
+}
+
+// through the logger: level off, backtrace on
+void bench_logger(benchmark::State &state)
+{
+    auto logger = std::make_shared<spdlog::logger>("backtrace", std::make_shared<spdlog::sinks::null_sink_mt>());
+    logger->set_level(spdlog::level::info);
+    logger->enable_backtrace(32);
+    std::string text = "some more text";
+    int i = 0;
+    for (auto _ : state)
+    {
+        logger->debug(fmt_str, ++i, text, 3.14);
+    }
+}
+
+int main(int argc, char *argv[])
+{
+    benchmark::RegisterBenchmark("backtrace/eager", bench_eager);
+    benchmark::RegisterBenchmark("backtrace/deferred", bench_deferred);
+    benchmark::RegisterBenchmark("backtrace/logger_deferred", bench_logger);
+    benchmark::Initialize(&argc, argv);
+    benchmark::RunSpecifiedBenchmarks();
+}
@@ -0,0 +1,86 @@
+#!/usr/bin/env python3
+#
+# Copyright(c) 2015 Gabi Melman.
+# Distributed under the MIT License (http://opensource.org/licenses/MIT)
+#
+# Compare two json outputs of the latency_suite benchmark (or any google benchmark output)
+# and flag the regressions.
+#
+# usage: compare.py <baseline.json> <contender.json> [--threshold 10] [--metrics real_time,p50_ns,p99_ns]
+#
+# A benchmark regresses if one of the metrics grew by more than threshold percent.
+# Exit code is 1 if any regression was found (e.g. to fail a CI job).
+
+import argparse
+import json
+import sys
+
+DEFAULT_METRICS = ['real_time', 'p50_ns', 'p99_ns', 'p99.9_ns', 'max_ns']
+
+
+def load(path):
+    with open(path, 'r') as fp:
+        data = json.load(fp)
+    results = {}
+    for b in data.get('benchmarks', []):
+        # skip the aggregates (mean/median/stddev) of repeated runs, keep the mean
+        if b.get('run_type') == 'aggregate' and b.get('aggregate_name') != 'mean':
+            continue
+        name = b.get('run_name', b['name'])
+        results[name] = b
+    return results
+
+
+def main():
+    parser = argparse.ArgumentParser(description='compare two latency_suite json outputs')
+    parser.add_argument('baseline')
+    parser.add_argument('contender')
+    parser.add_argument('--threshold', type=float, default=10.0, help='regression threshold in percent (default: 10)')
+    parser.add_argument('--metrics', default=','.join(DEFAULT_METRICS), help='comma separated metrics to compare')
+    args = parser.parse_args()
+
+    metrics = [m for m in args.metrics.split(',') if m]
+    baseline = load(args.baseline)
+    contender = load(args.contender)
+
+    name_width = max([len(n) for n in baseline] + [10])
+    header = '{:<{w}}'.format('benchmark', w=name_width) + ''.join(' {:>24}'.format(m) for m in metrics)
+    print(header)
+    print('-' * len(header))
+
+    regressions = []
+    for name, base in baseline.items():
+        other = contender.get(name)
+        if other is None:
+            print('{:<{w}}  (missing in {})'.format(name, args.contender, w=name_width))
+            continue
+        line = '{:<{w}}'.format(name, w=name_width)
+        for metric in metrics:
+            if metric not in base or metric not in other:
+                line += ' {:>24}'.format('-')
+                continue
+            old, new = float(base[metric]), float(other[metric])
+            change = (new - old) / old * 100.0 if old > 0 else 0.0
+            flag = ''
+            if change > args.threshold:
+                flag = ' !'
+                regressions.append((name, metric, old, new, change))
+            line += ' {:>24}'.format('{:.0f}->{:.0f} {:+.1f}%{}'.format(old, new, change, flag))
+        print(line)
+
+    for name in contender:
+        if name not in baseline:
+            print('{:<{w}}  (new)'.format(name, w=name_width))
+
+    print()
+    if regressions:
+        print('{} regression(s) above {:.1f}%:'.format(len(regressions), args.threshold))
+        for name, metric, old, new, change in regressions:
+            print('  {} {}: {:.0f} -> {:.0f} ({:+.1f}%)'.format(name, metric, old, new, change))
+        return 1
+    print('no regression above {:.1f}%'.format(args.threshold))
+    return 0
+
+
+if __name__ == '__main__':
+    sys.exit(main())
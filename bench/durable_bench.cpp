@@ -0,0 +1,90 @@
+//
+// Copyright(c) 2015 Gabi Melman.
+// Distributed under the MIT License (http://opensource.org/licenses/MIT)
+//
+
+//
+// durable_bench.cpp : throughput and per call latency of durable file logging (group commit),
+// for several thread counts and commit windows.
+// with one thread and no window, each message is written and synced alone (fdatasync per message).
+//
+#include "spdlog/spdlog.h"
+#include "spdlog/sinks/basic_file_sink.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <memory>
+#include <thread>
+#include <vector>
+
+using namespace std::chrono;
+
+static void bench_durable(int howmany, size_t threads_count, microseconds window)
+{
+    auto sink = std::make_shared<spdlog::sinks::basic_file_sink_mt>("logs/durable_bench.log", true);
+    sink->enable_durability(window);
+    auto logger = std::make_shared<spdlog::logger>("durable", std::move(sink));
+
+    int per_thread = howmany / static_cast<int>(threads_count);
+    std::vector<std::vector<int64_t>> latencies(threads_count);
+    std::vector<std::thread> threads;
+    auto start = high_resolution_clock::now();
+    for (size_t t = 0; t < threads_count; ++t)
+    {
+        threads.emplace_back([&logger, &latencies, t, per_thread]() {
+            auto &thread_latencies = latencies[t];
+            thread_latencies.reserve(static_cast<size_t>(per_thread));
+            for (int i = 0; i < per_thread; ++i)
+            {
+                auto call_start = high_resolution_clock::now();
+                logger->info("Hello logger: msg number {}, some more text to make the message longer....", i);
+                thread_latencies.push_back(duration_cast<nanoseconds>(high_resolution_clock::now() - call_start).count());
+            }
+        });
+    }
+    for (auto &t : threads)
+    {
+        t.join();
+    }
+    auto elapsed = duration_cast<duration<double>>(high_resolution_clock::now() - start).count();
+
+    std::vector<int64_t> all;
+    for (auto &thread_latencies : latencies)
+    {
+        all.insert(all.end(), thread_latencies.begin(), thread_latencies.end());
+    }
+    std::sort(all.begin(), all.end());
+    auto percentile = [&all](double p) { return all[static_cast<size_t>(p * static_cast<double>(all.size() - 1))] / 1000; };
+    auto msgs = static_cast<double>(per_thread) * static_cast<double>(threads_count);
+    spdlog::info("threads: {:>2}  window: {:>5}us  {:>9.0f} msg/sec  p50: {:>6}us  p99: {:>6}us  max: {:>7}us", threads_count,
+        window.count(), msgs / elapsed, percentile(0.5), percentile(0.99), all.back() / 1000);
+}
+
+int main(int argc, char *argv[])
+{
+    int howmany = argc > 1 ? std::atoi(argv[1]) : 20000;
+    size_t max_threads = argc > 2 ? static_cast<size_t>(std::atol(argv[2])) : 8;
+
+    try
+    {
+        spdlog::info("Usage: {} <message_count> <max_threads>", argv[0]);
+        spdlog::info("{} durable messages per run", howmany);
+        spdlog::info("-----------------------------------------------------------------------------------------");
+
+        for (auto window : {microseconds(0), microseconds(50), microseconds(200)})
+        {
+            for (size_t threads_count = 1; threads_count <= max_threads; threads_count *= 2)
+            {
+                bench_durable(howmany, threads_count, window);
+            }
+        }
+    }
+    catch (std::exception &ex)
+    {
+        spdlog::error(ex.what());
+        return EXIT_FAILURE;
+    }
+    return EXIT_SUCCESS;
+}
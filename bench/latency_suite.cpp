@@ -0,0 +1,349 @@
+//
+// Copyright(c) 2015 Gabi Melman.
+// Distributed under the MIT License (http://opensource.org/licenses/MIT)
+//
+
+//
+// latency_suite.cpp : per call latency percentiles (p50/p99/p99.9/max) of the main logging scenarios.
+//
+// Each call is timed with steady_clock into a histogram, and the percentiles are reported as benchmark counters (in ns).
+// Save the results as json and compare two runs with bench/compare.py:
+//
+//   latency_suite --benchmark_out=before.json --benchmark_out_format=json
+//   latency_suite --benchmark_out=after.json --benchmark_out_format=json
+//   bench/compare.py before.json after.json
+//
+// Use --benchmark_filter=<regex> to run only some of the scenarios.
+//
+
+#include "benchmark/benchmark.h"
+
+#include "spdlog/spdlog.h"
+#include "spdlog/async.h"
+#include "spdlog/sinks/basic_file_sink.h"
+#include "spdlog/sinks/compressed_rotating_file_sink.h"
+#include "spdlog/sinks/daily_file_sink.h"
+#include "spdlog/sinks/interval_file_sink.h"
+#include "spdlog/sinks/null_sink.h"
+#include "spdlog/sinks/rotating_file_sink.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+using std::chrono::steady_clock;
+
+// log-linear histogram of latencies in ns: each power of 2 is split in 32 buckets (at most ~3% error).
+// constant memory however many iterations are run.
+class latency_histogram
+{
+public:
+    static const int sub_bits = 5;
+    static const uint64_t sub_buckets = uint64_t(1) << sub_bits;
+
+    latency_histogram()
+        : counts_(64 * sub_buckets, 0)
+    {}
+
+    void add(uint64_t value)
+    {
+        counts_[index_(value)]++;
+        total_++;
+        max_ = (std::max)(max_, value);
+    }
+
+    void merge(const latency_histogram &other)
+    {
+        for (size_t i = 0; i < counts_.size(); i++)
+        {
+            counts_[i] += other.counts_[i];
+        }
+        total_ += other.total_;
+        max_ = (std::max)(max_, other.max_);
+    }
+
+    // middle of the bucket that contains the given percentile
+    double percentile(double p) const
+    {
+        auto rank = static_cast<uint64_t>(p * static_cast<double>(total_));
+        uint64_t seen = 0;
+        for (size_t i = 0; i < counts_.size(); i++)
+        {
+            seen += counts_[i];
+            if (seen > rank)
+            {
+                return bucket_middle_(i);
+            }
+        }
+        return static_cast<double>(max_);
+    }
+
+    uint64_t max() const
+    {
+        return max_;
+    }
+
+    uint64_t total() const
+    {
+        return total_;
+    }
+
+    void clear()
+    {
+        std::fill(counts_.begin(), counts_.end(), 0);
+        total_ = 0;
+        max_ = 0;
+    }
+
+private:
+    static size_t index_(uint64_t value)
+    {
+        if (value < sub_buckets)
+        {
+            return static_cast<size_t>(value);
+        }
+        int msb = 0;
+        for (auto v = value; v > 1; v >>= 1)
+        {
+            msb++;
+        }
+        auto shift = msb - sub_bits;
+        return static_cast<size_t>((static_cast<uint64_t>(shift + 1) << sub_bits) + ((value >> shift) - sub_buckets));
+    }
+
+    static double bucket_middle_(size_t index)
+    {
+        if (index < sub_buckets)
+        {
+            return static_cast<double>(index);
+        }
+        auto shift = static_cast<int>(index >> sub_bits) - 1;
+        auto low = (sub_buckets + (index & (sub_buckets - 1))) << shift;
+        return static_cast<double>(low) + static_cast<double>((uint64_t(1) << shift) - 1) / 2;
+    }
+
+    std::vector<uint64_t> counts_;
+    uint64_t total_ = 0;
+    uint64_t max_ = 0;
+};
+
+// latencies of all the threads of the running benchmark
+struct latency_samples
+{
+    std::mutex mutex;
+    latency_histogram histogram;
+    int finished_threads = 0;
+};
+
+static latency_samples collected;
+
+// merge the latencies of this thread, and report the percentiles from the last thread to finish
+// (the counters are summed over the threads, so the other threads report zeros).
+static void report_latencies(benchmark::State &state, const latency_histogram &latencies)
+{
+    double p50 = 0, p99 = 0, p999 = 0, max = 0;
+    {
+        std::lock_guard<std::mutex> lock(collected.mutex);
+        collected.histogram.merge(latencies);
+        if (++collected.finished_threads == state.threads() && collected.histogram.total() > 0)
+        {
+            p50 = collected.histogram.percentile(0.5);
+            p99 = collected.histogram.percentile(0.99);
+            p999 = collected.histogram.percentile(0.999);
+            max = static_cast<double>(collected.histogram.max());
+        }
+    }
+    state.counters["p50_ns"] = p50;
+    state.counters["p99_ns"] = p99;
+    state.counters["p99.9_ns"] = p999;
+    state.counters["max_ns"] = max;
+}
+
+static void reset_latencies(benchmark::State &state)
+{
+    // the other threads wait for thread 0 at the start of the benchmark loop
+    if (state.thread_index() == 0)
+    {
+        std::lock_guard<std::mutex> lock(collected.mutex);
+        collected.histogram.clear();
+        collected.finished_threads = 0;
+    }
+}
+
+// time each call of the given function
+template<typename Fun>
+static void measure(benchmark::State &state, Fun &&fun)
+{
+    reset_latencies(state);
+    latency_histogram latencies;
+    int i = 0;
+    for (auto _ : state)
+    {
+        auto start = steady_clock::now();
+        fun(++i);
+        auto end = steady_clock::now();
+        latencies.add(static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count()));
+    }
+    report_latencies(state, latencies);
+}
+
+static void bench_logger(benchmark::State &state, std::shared_ptr<spdlog::logger> logger)
+{
+    measure(state, [&logger](int i) { logger->info("Hello logger: msg number {}...............", i); });
+}
+
+static void bench_debug(benchmark::State &state, std::shared_ptr<spdlog::logger> logger)
+{
+    measure(state, [&logger](int i) { logger->debug("Hello logger: msg number {}...............", i); });
+}
+
+static void bench_macro(benchmark::State &state, std::shared_ptr<spdlog::logger> logger)
+{
+    measure(state, [&logger](int i) { SPDLOG_LOGGER_INFO(logger, "Hello logger: msg number {}...............", i); });
+}
+
+// disabled in main() with spdlog::set_callsites_by_function()
+static void log_disabled_callsite(spdlog::logger *logger, int i)
+{
+    SPDLOG_LOGGER_INFO(logger, "Hello logger: msg number {}...............", i);
+}
+
+static void bench_disabled_callsite(benchmark::State &state, std::shared_ptr<spdlog::logger> logger)
+{
+    measure(state, [&logger](int i) { log_disabled_callsite(logger.get(), i); });
+}
+
+static std::shared_ptr<spdlog::logger> null_logger(const std::string &name)
+{
+    return std::make_shared<spdlog::logger>(name, std::make_shared<spdlog::sinks::null_sink_mt>());
+}
+
+static void register_level_benchmarks()
+{
+    auto disabled = null_logger("disabled");
+    disabled->set_level(spdlog::level::off);
+    benchmark::RegisterBenchmark("level/disabled", bench_logger, disabled);
+
+    auto below_level = null_logger("below_level");
+    benchmark::RegisterBenchmark("level/below_level", bench_debug, below_level);
+
+    benchmark::RegisterBenchmark("level/enabled", bench_logger, null_logger("enabled"));
+    benchmark::RegisterBenchmark("level/enabled_macro", bench_macro, null_logger("enabled_macro"));
+    benchmark::RegisterBenchmark("level/disabled_callsite", bench_disabled_callsite, null_logger("disabled_callsite"));
+}
+
+static void register_backtrace_benchmarks()
+{
+    auto off = null_logger("backtrace_off");
+    off->set_level(spdlog::level::info);
+    benchmark::RegisterBenchmark("backtrace/off/debug", bench_debug, off);
+
+    auto on = null_logger("backtrace_on");
+    on->enable_backtrace(64);
+    benchmark::RegisterBenchmark("backtrace/on/debug", bench_debug, on);
+    benchmark::RegisterBenchmark("backtrace/on/info", bench_logger, on);
+
+    auto on_mt = null_logger("backtrace_on_mt");
+    on_mt->enable_backtrace(64);
+    benchmark::RegisterBenchmark("backtrace/on/debug/threads", bench_debug, on_mt)->Threads(4)->UseRealTime();
+}
+
+static void register_formatter_benchmarks()
+{
+    std::string all_flags = "+vtPnlLaAbBcCYDmdHIMSefFprRTXzEisg@#!luioON%";
+    for (auto flag : all_flags)
+    {
+        auto pattern = std::string("%") + flag;
+        auto logger = null_logger("formatter");
+        logger->set_pattern(pattern);
+        benchmark::RegisterBenchmark(("formatter/" + pattern).c_str(), bench_macro, std::move(logger));
+    }
+
+    auto full = null_logger("formatter");
+    full->set_pattern("[%Y-%m-%d %H:%M:%S.%e] [%n] [%l] [%s:%#] %v");
+    benchmark::RegisterBenchmark("formatter/full", bench_macro, std::move(full));
+}
+
+static void register_file_benchmarks()
+{
+    size_t file_size = 30 * 1024 * 1024;
+    size_t max_files = 5;
+
+    benchmark::RegisterBenchmark("file/basic", bench_logger,
+        std::make_shared<spdlog::logger>("basic", std::make_shared<spdlog::sinks::basic_file_sink_mt>("latency_logs/basic.log", true)))
+        ->UseRealTime();
+
+    benchmark::RegisterBenchmark("file/rotating", bench_logger,
+        std::make_shared<spdlog::logger>(
+            "rotating", std::make_shared<spdlog::sinks::rotating_file_sink_mt>("latency_logs/rotating.log", file_size, max_files)))
+        ->UseRealTime();
+
+    benchmark::RegisterBenchmark("file/daily", bench_logger,
+        std::make_shared<spdlog::logger>("daily", std::make_shared<spdlog::sinks::daily_file_sink_mt>("latency_logs/daily.log", 0, 0)))
+        ->UseRealTime();
+
+    benchmark::RegisterBenchmark("file/hourly", bench_logger,
+        std::make_shared<spdlog::logger>("hourly",
+            std::make_shared<spdlog::sinks::interval_file_sink_mt>("latency_logs/hourly_%Y-%m-%d_%H.log", std::chrono::hours(1))))
+        ->UseRealTime();
+
+    benchmark::RegisterBenchmark("file/compressed_rotating", bench_logger,
+        std::make_shared<spdlog::logger>("compressed_rotating",
+            std::make_shared<spdlog::sinks::compressed_rotating_file_sink_mt>("latency_logs/compressed.lz4", file_size, max_files)))
+        ->UseRealTime();
+}
+
+static void register_rotation_benchmarks()
+{
+    // small files, so the rotation happens every ~1000 messages
+    size_t file_size = 64 * 1024;
+    size_t max_files = 3;
+
+    auto sync_sink = std::make_shared<spdlog::sinks::rotating_file_sink_mt>("latency_logs/rotation_sync.log", file_size, max_files);
+    benchmark::RegisterBenchmark("rotation/sync", bench_logger, std::make_shared<spdlog::logger>("rotation_sync", sync_sink))
+        ->UseRealTime();
+
+    auto async_sink = std::make_shared<spdlog::sinks::rotating_file_sink_mt>("latency_logs/rotation_async.log", file_size, max_files);
+    async_sink->enable_async_rotation(true);
+    benchmark::RegisterBenchmark("rotation/async", bench_logger, std::make_shared<spdlog::logger>("rotation_async", async_sink))
+        ->UseRealTime();
+}
+
+static void register_async_benchmarks(std::shared_ptr<spdlog::details::thread_pool> tp)
+{
+    for (int producers : {1, 4, 16, 64})
+    {
+        auto logger = std::make_shared<spdlog::async_logger>(
+            "async", std::make_shared<spdlog::sinks::null_sink_mt>(), tp, spdlog::async_overflow_policy::overrun_oldest);
+        benchmark::RegisterBenchmark("async/overrun_oldest", bench_logger, logger)->Threads(producers)->UseRealTime();
+    }
+    for (int producers : {1, 4, 16, 64})
+    {
+        auto logger = std::make_shared<spdlog::async_logger>(
+            "async", std::make_shared<spdlog::sinks::null_sink_mt>(), tp, spdlog::async_overflow_policy::block);
+        benchmark::RegisterBenchmark("async/block", bench_logger, logger)->Threads(producers)->UseRealTime();
+    }
+}
+
+int main(int argc, char *argv[])
+{
+    spdlog::set_automatic_registration(false);
+
+    register_level_benchmarks();
+    register_backtrace_benchmarks();
+    register_formatter_benchmarks();
+    register_file_benchmarks();
+    register_rotation_benchmarks();
+
+    auto tp = std::make_shared<spdlog::details::thread_pool>(1024 * 1024, 1);
+    register_async_benchmarks(tp);
+
+    spdlog::set_callsites_by_function("log_disabled_callsite", false);
+
+    benchmark::Initialize(&argc, argv);
+    benchmark::RunSpecifiedBenchmarks();
+}
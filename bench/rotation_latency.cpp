@@ -0,0 +1,68 @@
+//
+// Copyright(c) 2015 Gabi Melman.
+// Distributed under the MIT License (http://opensource.org/licenses/MIT)
+//
+
+//
+// rotation_latency.cpp : per call latency of a rotating file logger, across many rotations.
+// compares synchronous rotation, async rotation and async rotation with a pre-created next file.
+//
+#include "spdlog/spdlog.h"
+#include "spdlog/sinks/rotating_file_sink.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <memory>
+#include <vector>
+
+using namespace std::chrono;
+
+static void bench_rotation(const char *name, int howmany, size_t file_size, size_t max_files, bool async_rotation, bool precreate)
+{
+    auto sink = std::make_shared<spdlog::sinks::rotating_file_sink_mt>("logs/rotation_latency.log", file_size, max_files);
+    if (async_rotation)
+    {
+        sink->enable_async_rotation(precreate);
+    }
+    auto logger = std::make_shared<spdlog::logger>(name, std::move(sink));
+
+    std::vector<int64_t> latencies;
+    latencies.reserve(static_cast<size_t>(howmany));
+    for (int i = 0; i < howmany; ++i)
+    {
+        auto start = high_resolution_clock::now();
+        logger->info("Hello logger: msg number {}, some more text to make the message longer....", i);
+        latencies.push_back(duration_cast<nanoseconds>(high_resolution_clock::now() - start).count());
+    }
+    logger.reset();
+
+    std::sort(latencies.begin(), latencies.end());
+    auto percentile = [&latencies](double p) { return latencies[static_cast<size_t>(p * static_cast<double>(latencies.size() - 1))]; };
+    spdlog::info("{:<28} p50: {:>7}ns  p99: {:>7}ns  p99.9: {:>8}ns  max: {:>9}ns", name, percentile(0.5), percentile(0.99),
+        percentile(0.999), latencies.back());
+}
+
+int main(int argc, char *argv[])
+{
+    int howmany = argc > 1 ? std::atoi(argv[1]) : 1000000;
+    size_t file_size = argc > 2 ? static_cast<size_t>(std::atol(argv[2])) : 1024 * 1024;
+    size_t max_files = argc > 3 ? static_cast<size_t>(std::atol(argv[3])) : 10;
+
+    try
+    {
+        spdlog::info("Usage: {} <message_count> <file_size> <max_files>", argv[0]);
+        spdlog::info("{} messages, rotation every {} bytes, {} files", howmany, file_size, max_files);
+        spdlog::info("-----------------------------------------------------------------------------------------");
+
+        bench_rotation("sync rotation", howmany, file_size, max_files, false, false);
+        bench_rotation("async rotation", howmany, file_size, max_files, true, false);
+        bench_rotation("async rotation + precreate", howmany, file_size, max_files, true, true);
+    }
+    catch (std::exception &ex)
+    {
+        spdlog::error(ex.what());
+        return EXIT_FAILURE;
+    }
+    return EXIT_SUCCESS;
+}
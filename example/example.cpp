@@ -11,6 +11,7 @@ void stdout_logger_example();
 void basic_example();
 void rotating_example();
 void daily_example();
+void interval_example();
 void async_example();
 void binary_example();
 void trace_example();
@@ -65,6 +66,7 @@ int main(int, char *[])
         basic_example();
         rotating_example();
         daily_example();
+        interval_example();
         async_example();
         binary_example();
         multi_sink_example();
@@ -124,6 +126,13 @@ void daily_example()
     auto daily_logger = spdlog::daily_logger_mt("daily_logger", "logs/daily.txt", 2, 30);
 }
 
+#include "spdlog/sinks/interval_file_sink.h"
+void interval_example()
+{
+    // Create an interval logger - a new file is created every 15 minutes (00:00, 00:15, 00:30..).
+    auto interval_logger = spdlog::interval_logger_mt("interval_logger", "logs/interval_%Y-%m-%d_%H-%M.txt", std::chrono::minutes(15));
+}
+
 #include "spdlog/cfg/env.h"
 void load_levels_example()
 {
@@ -72,11 +72,28 @@ inline std::shared_ptr<spdlog::logger> create_async_nb(std::string logger_name,
     return async_factory_nonblock::create<Sink>(std::move(logger_name), std::forward<SinkArgs>(sink_args)...);
 }
 
+// set global thread pool, its queue and queued messages allocated from the given memory resource.
+// numa_policy::per_node: a queue of q_size and thread_count workers per NUMA node (see details::thread_pool).
+// The async loggers then queue the messages of a thread to the node of the CPU it first logged from. Their sinks are
+// shared by the nodes (a merged sink, ordered per thread and per node only), or split with a numa_node_sink
+// (sinks/numa_node_sink.h): a sink per node. Flushes reach all the nodes.
+inline void init_thread_pool(size_t q_size, size_t thread_count, std::function<void()> on_thread_start, memory_resource *resource,
+    numa_policy numa = numa_policy::shared)
+{
+    auto tp = std::make_shared<details::thread_pool>(q_size, thread_count, std::move(on_thread_start), resource, numa);
+    details::registry::instance().set_tp(std::move(tp));
+}
+
+// set global thread pool, with one queue per NUMA node if numa is numa_policy::per_node.
+inline void init_thread_pool(size_t q_size, size_t thread_count, numa_policy numa)
+{
+    init_thread_pool(q_size, thread_count, [] {}, nullptr, numa);
+}
+
 // set global thread pool.
 inline void init_thread_pool(size_t q_size, size_t thread_count, std::function<void()> on_thread_start)
 {
-    auto tp = std::make_shared<details::thread_pool>(q_size, thread_count, on_thread_start);
-    details::registry::instance().set_tp(std::move(tp));
+    init_thread_pool(q_size, thread_count, std::move(on_thread_start), nullptr);
 }
 
 // set global thread pool.
@@ -90,4 +107,17 @@ inline std::shared_ptr<spdlog::details::thread_pool> thread_pool()
 {
     return details::registry::instance().get_tp();
 }
+
+// flush the sink every interval if it is dirty: the flush is posted to the pool and run by a worker,
+// in order with the messages already queued (see spdlog::flush_every(sink, interval)).
+inline void flush_every(sink_ptr sink, std::chrono::milliseconds interval, const std::shared_ptr<details::thread_pool> &tp)
+{
+    std::weak_ptr<details::thread_pool> weak_tp = tp;
+    details::registry::instance().flush_every(std::move(sink), interval, [weak_tp](const sink_ptr &dirty_sink) {
+        if (auto pool_ptr = weak_tp.lock())
+        {
+            pool_ptr->post_control([dirty_sink] { dirty_sink->flush_tracked(); });
+        }
+    });
+}
 } // namespace spdlog
@@ -49,6 +49,25 @@ SPDLOG_INLINE void spdlog::async_logger::flush_()
     }
 }
 
+// post a flush of the dirty sinks to the thread pool. nothing is posted if no sink is dirty yet
+// (the messages still queued make their sinks dirty when written, and are flushed by the next call).
+SPDLOG_INLINE void spdlog::async_logger::flush_dirty_()
+{
+    if (!dirty())
+    {
+        return;
+    }
+    if (auto pool_ptr = thread_pool_.lock())
+    {
+        auto self = shared_from_this();
+        pool_ptr->post_control([self] { self->logger::flush_dirty_(); });
+    }
+    else
+    {
+        throw_spdlog_ex("async flush: thread pool doesn't exist anymore");
+    }
+}
+
 //
 // backend functions - called from the thread pool to do the actual job
 //
@@ -61,6 +80,10 @@ SPDLOG_INLINE void spdlog::async_logger::backend_sink_it_(const details::log_msg
             SPDLOG_TRY
             {
                 sink->log(msg);
+                if (sink->count_written(msg.payload.size()))
+                {
+                    sink->flush_tracked();
+                }
             }
             SPDLOG_LOGGER_CATCH()
         }
@@ -78,7 +101,7 @@ SPDLOG_INLINE void spdlog::async_logger::backend_flush_()
     {
         SPDLOG_TRY
         {
-            sink->flush();
+            sink->flush_tracked();
         }
         SPDLOG_LOGGER_CATCH()
     }
@@ -26,6 +26,14 @@ enum class async_overflow_policy
                    // add new item.
 };
 
+// Thread pool queues - a single queue by default.
+enum class numa_policy
+{
+    shared,  // One queue for all the threads
+    per_node // One queue and its worker threads per NUMA node. The messages of a thread are
+             // queued to the node of the CPU it first logged from.
+};
+
 namespace details {
 class thread_pool;
 }
@@ -54,6 +62,7 @@ public:
 protected:
     void sink_it_(const details::log_msg &msg) override;
     void flush_() override;
+    void flush_dirty_() override;
     void backend_sink_it_(const details::log_msg &incoming_log_msg);
     void backend_flush_();
 
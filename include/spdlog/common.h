@@ -20,6 +20,7 @@
 #include <string>
 #include <type_traits>
 #include <functional>
+#include <vector>
 
 #ifdef SPDLOG_COMPILED_LIB
 #undef SPDLOG_HEADER_ONLY
@@ -98,6 +99,10 @@ namespace sinks {
 class sink;
 }
 
+namespace details {
+class callsite;
+}
+
 #if defined(_WIN32) && defined(SPDLOG_WCHAR_FILENAMES)
 using filename_t = std::wstring;
 #define SPDLOG_FILENAME_T(s) L##s
@@ -113,6 +118,15 @@ using err_handler = std::function<void(const std::string &err_msg)>;
 using string_view_t = fmt::basic_string_view<char>;
 using wstring_view_t = fmt::basic_string_view<wchar_t>;
 using memory_buf_t = fmt::basic_memory_buffer<char, 250>;
+
+// Batch of formatted messages delivered to a batch_log_handler (see stdout_sink_base::set_batch_handler()).
+struct log_batch
+{
+    std::vector<string_view_t> lines; // views into one contiguous buffer, valid during the handler call only
+    size_t dropped = 0;               // messages dropped (queue full) since the previous batch
+};
+using batch_log_handler = std::function<void(const log_batch &batch)>;
+
 #ifdef CEP_SPDLOG_MODIFIED
 using log_handler = std::function<void(const spdlog::memory_buf_t& formattedMsg)>;
 using log_err_handler = std::function<void(const std::string& err_msg)>;
@@ -197,6 +211,16 @@ enum class color_mode
     never
 };
 
+//
+// Output buffering of the console sinks.
+//
+enum class console_buffering
+{
+    line,      // write and flush each message (default)
+    block,     // write the messages in blocks: when the block is full, on flush, or when the oldest is max_latency old
+    automatic  // line if the output is a terminal, block otherwise (pipe, file)
+};
+
 //
 // Pattern time - specific time getting to use for pattern_formatter.
 // local time by default
@@ -207,6 +231,17 @@ enum class pattern_time_type
     utc    // log utc
 };
 
+//
+// Clock of the log messages timestamps (see spdlog::set_clock_source()).
+// system by default (coarse if SPDLOG_CLOCK_COARSE is defined)
+//
+enum class clock_source
+{
+    system, // log_clock::now()
+    coarse, // CLOCK_REALTIME_COARSE under linux (system elsewhere): faster, but only as accurate as the kernel tick
+    tsc     // cpu time stamp counter calibrated against the system clock (see details/tsc_clock.h)
+};
+
 //
 // Log exception
 //
@@ -233,6 +268,14 @@ struct source_loc
         , funcname{funcname_in}
     {}
 
+    // location of a log macro, with its static descriptor
+    SPDLOG_CONSTEXPR source_loc(const char *filename_in, int line_in, const char *funcname_in, const details::callsite *site_in)
+        : filename{filename_in}
+        , line{line_in}
+        , funcname{funcname_in}
+        , site{site_in}
+    {}
+
     SPDLOG_CONSTEXPR bool empty() const SPDLOG_NOEXCEPT
     {
         return line == 0;
@@ -240,6 +283,7 @@ struct source_loc
     const char *filename{nullptr};
     int line{0};
     const char *funcname{nullptr};
+    const details::callsite *site{nullptr};
 };
 
 namespace details {
@@ -6,8 +6,30 @@
 #ifndef SPDLOG_HEADER_ONLY
 #include <spdlog/details/backtracer.h>
 #endif
+
+#include <algorithm>
+
 namespace spdlog {
 namespace details {
+
+SPDLOG_INLINE backtracer::thread_ring::thread_ring(size_t n_slots)
+    : size(n_slots)
+    , slots(new std::atomic<backtrace_msg *>[n_slots])
+{
+    for (size_t i = 0; i < size; i++)
+    {
+        slots[i].store(nullptr, std::memory_order_relaxed);
+    }
+}
+
+SPDLOG_INLINE backtracer::thread_ring::~thread_ring()
+{
+    for (size_t i = 0; i < size; i++)
+    {
+        delete slots[i].load(std::memory_order_acquire);
+    }
+}
+
 SPDLOG_INLINE backtracer::backtracer(
 #if defined(CEP_SPDLOG_MODIFIED) && defined(CEP_SPDLOG_USE_MUTEX)
 #else
@@ -23,7 +45,7 @@ SPDLOG_INLINE backtracer::backtracer(
     std::lock_guard<std::mutex> lock(other.mutex_);
 #endif
     enabled_ = other.enabled();
-    messages_ = other.messages_;
+    size_ = other.size_;
 }
 
 SPDLOG_INLINE backtracer::backtracer(backtracer &&other) SPDLOG_NOEXCEPT
@@ -35,8 +57,11 @@ SPDLOG_INLINE backtracer::backtracer(backtracer &&other) SPDLOG_NOEXCEPT
 #else
     std::lock_guard<std::mutex> lock(other.mutex_);
 #endif
+    // keep the id, so the threads of the other backtracer keep pushing into the moved rings
     enabled_ = other.enabled();
-    messages_ = std::move(other.messages_);
+    id_ = other.id_.exchange(next_id_());
+    size_ = other.size_;
+    rings_ = std::move(other.rings_);
 }
 
 SPDLOG_INLINE backtracer &backtracer::operator=(backtracer other)
@@ -49,7 +74,9 @@ SPDLOG_INLINE backtracer &backtracer::operator=(backtracer other)
     std::lock_guard<std::mutex> lock(mutex_);
 #endif
     enabled_ = other.enabled();
-    messages_ = std::move(other.messages_);
+    id_ = other.id_.exchange(next_id_());
+    size_ = other.size_;
+    rings_ = std::move(other.rings_);
     return *this;
 }
 
@@ -63,7 +90,10 @@ SPDLOG_INLINE void backtracer::enable(size_t size)
     std::lock_guard<std::mutex> lock(mutex_);
 #endif
     enabled_.store(true, std::memory_order_relaxed);
-    messages_ = circular_q<log_msg_buffer>{size};
+    // start over with new rings. threads register again on their next push.
+    id_.store(next_id_(), std::memory_order_release);
+    size_ = size;
+    rings_.clear();
 }
 
 SPDLOG_INLINE void backtracer::disable()
@@ -85,6 +115,13 @@ SPDLOG_INLINE bool backtracer::enabled() const
 
 SPDLOG_INLINE void backtracer::push_back(const log_msg &msg)
 {
+    push_back_(msg, nullptr);
+}
+
+SPDLOG_INLINE void backtracer::push_back_(const log_msg &msg, const deferred_payload *deferred)
+{
+#if defined(SPDLOG_NO_TLS)
+    // no per thread rings: all threads share a single ring under the mutex
 #ifdef CEP_SPDLOG_MODIFIED
 #ifdef CEP_SPDLOG_USE_MUTEX
     cep::Lock_Guard lock{mutex_};
@@ -92,12 +129,65 @@ SPDLOG_INLINE void backtracer::push_back(const log_msg &msg)
 #else
     std::lock_guard<std::mutex> lock{mutex_};
 #endif
-    messages_.push_back(log_msg_buffer{msg});
+    if (size_ == 0)
+    {
+        return;
+    }
+    if (rings_.empty())
+    {
+        rings_.push_back(std::make_shared<thread_ring>(size_));
+    }
+    push_to_ring_(*rings_.front(), msg, deferred);
+#else
+    auto ring = thread_ring_();
+    if (ring)
+    {
+        push_to_ring_(*ring, msg, deferred);
+    }
+#endif
 }
 
-// pop all items in the q and apply the given fun on each of them.
-SPDLOG_INLINE void backtracer::foreach_pop(std::function<void(const details::log_msg &)> fun)
+SPDLOG_INLINE std::shared_ptr<backtracer::thread_ring> backtracer::thread_ring_()
 {
+#if defined(SPDLOG_NO_TLS)
+    return nullptr;
+#else
+    // rings of the calling thread, by backtracer id.
+    // weak references: the rings are owned by the backtracers, which drop them when disabled or destroyed.
+    // when the thread exits its rings are marked as orphaned, so the next dump can drop them.
+    struct thread_rings
+    {
+        std::vector<std::pair<uint64_t, std::weak_ptr<thread_ring>>> entries;
+
+        ~thread_rings()
+        {
+            for (auto &entry : entries)
+            {
+                auto ring = entry.second.lock();
+                if (ring)
+                {
+                    ring->owner_alive.store(false, std::memory_order_release);
+                }
+            }
+        }
+    };
+    static thread_local thread_rings cache;
+
+    auto id = id_.load(std::memory_order_acquire);
+    for (auto &entry : cache.entries)
+    {
+        if (entry.first == id)
+        {
+            auto ring = entry.second.lock();
+            if (ring)
+            {
+                return ring;
+            }
+            break;
+        }
+    }
+
+    // first push from this thread since enable(): register a new ring
 #ifdef CEP_SPDLOG_MODIFIED
 #ifdef CEP_SPDLOG_USE_MUTEX
     cep::Lock_Guard lock{mutex_};
@@ -105,11 +195,128 @@ SPDLOG_INLINE void backtracer::foreach_pop(std::function<void(const details::log
 #else
     std::lock_guard<std::mutex> lock{mutex_};
 #endif
-    while (!messages_.empty())
+    if (size_ == 0)
+    {
+        return nullptr;
+    }
+    id = id_.load(std::memory_order_relaxed);
+    auto ring = std::make_shared<thread_ring>(size_);
+    rings_.push_back(ring);
+
+    cache.entries.erase(std::remove_if(cache.entries.begin(), cache.entries.end(),
+                            [id](const std::pair<uint64_t, std::weak_ptr<thread_ring>> &entry) {
+                                return entry.first == id || entry.second.expired();
+                            }),
+        cache.entries.end());
+    cache.entries.emplace_back(id, ring);
+    return ring;
+#endif
+}
+
+SPDLOG_INLINE void backtracer::push_to_ring_(thread_ring &ring, const log_msg &msg, const deferred_payload *deferred)
+{
+    std::unique_ptr<backtrace_msg> item = std::move(ring.spare);
+    if (item)
+    {
+        item->msg.assign(msg);
+    }
+    else
+    {
+        item.reset(new backtrace_msg{log_msg_buffer{msg}, deferred_payload{}});
+    }
+    if (deferred != nullptr)
+    {
+        item->deferred = *deferred;
+    }
+    else
+    {
+        item->deferred.clear();
+    }
+
+    auto pos = ring.next.load(std::memory_order_relaxed);
+    ring.next.store(pos + 1 == ring.size ? 0 : pos + 1, std::memory_order_relaxed);
+    // publish the new message, and keep the one it replaced (unless already taken by foreach_pop) for the next push
+    ring.spare.reset(ring.slots[pos].exchange(item.release(), std::memory_order_acq_rel));
+}
+
+SPDLOG_INLINE uint64_t backtracer::next_id_()
+{
+    static std::atomic<uint64_t> last_id{0};
+    return last_id.fetch_add(1, std::memory_order_relaxed) + 1;
+}
+
+// pop all items from the rings and apply the given fun on each of them, ordered by time.
+SPDLOG_INLINE void backtracer::foreach_pop(std::function<void(const details::log_msg &)> fun)
+{
+    std::vector<std::unique_ptr<backtrace_msg>> items;
+    size_t max_items = 0;
+    {
+#ifdef CEP_SPDLOG_MODIFIED
+#ifdef CEP_SPDLOG_USE_MUTEX
+        cep::Lock_Guard lock{mutex_};
+#endif
+#else
+        std::lock_guard<std::mutex> lock{mutex_};
+#endif
+        max_items = size_;
+        for (auto &ring : rings_)
+        {
+            // oldest first, so messages with the same timestamp keep their order after the (stable) sort
+            auto start = ring->next.load(std::memory_order_relaxed);
+            for (size_t i = 0; i < ring->size; i++)
+            {
+                auto pos = (start + i) % ring->size;
+                auto *item = ring->slots[pos].exchange(nullptr, std::memory_order_acq_rel);
+                if (item != nullptr)
+                {
+                    items.emplace_back(item);
+                }
+            }
+        }
+
+#if !defined(SPDLOG_NO_TLS)
+        // drop the (now empty) rings of the threads that have exited. live threads keep theirs.
+        rings_.erase(std::remove_if(rings_.begin(), rings_.end(),
+                         [](const std::shared_ptr<thread_ring> &ring) {
+                             return !ring->owner_alive.load(std::memory_order_acquire);
+                         }),
+            rings_.end());
+#endif
+    }
+
+    std::stable_sort(items.begin(), items.end(),
+        [](const std::unique_ptr<backtrace_msg> &a, const std::unique_ptr<backtrace_msg> &b) { return a->msg.time < b->msg.time; });
+    auto first = items.size() > max_items ? items.size() - max_items : 0;
+
+    memory_buf_t formatted;
+    for (auto i = first; i < items.size(); i++)
     {
-        auto &front_msg = messages_.front();
-        fun(front_msg);
-        messages_.pop_front();
+        auto &item = *items[i];
+        if (!item.deferred.empty())
+        {
+            formatted.clear();
+            bool ok = false;
+            SPDLOG_TRY
+            {
+                item.deferred.format_to(formatted);
+                ok = true;
+            }
+            SPDLOG_CATCH_ALL() {}
+            if (!ok)
+            {
+                // show the unformatted message rather than nothing
+                auto format = item.deferred.format_string();
+                formatted.clear();
+                formatted.append(format.data(), format.data() + format.size());
+            }
+            log_msg msg{item.msg};
+            msg.payload = string_view_t{formatted.data(), formatted.size()};
+            fun(msg);
+        }
+        else
+        {
+            fun(item.msg);
+        }
     }
 }
 } // namespace details
@@ -4,19 +4,279 @@
 #pragma once
 
 #include <spdlog/details/log_msg_buffer.h>
-#include <spdlog/details/circular_q.h>
+#include <spdlog/fmt/fmt.h>
 
 #include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <memory>
 #include <mutex>
+#include <new>
 #include <functional>
+#include <string>
+#include <type_traits>
+#include <vector>
 
-// Store log messages in circular buffer.
+// Store log messages in circular buffers.
 // Useful for storing debug data in case of error/warning happens.
+//
+// Each thread pushes into its own fixed size ring, without locking (the mutex is taken only the
+// first time a thread pushes). foreach_pop() takes the messages of all the rings, merges them by
+// timestamp and applies the function on the last "size" messages.
+//
+// Messages that are stored only for the backtrace (i.e. below the logger level) are not formatted:
+// copies of their format string and arguments are stored instead (in the ring slot, see deferred_payload),
+// and formatted in foreach_pop().
 
 namespace spdlog {
 namespace details {
+
+// Arguments that can be copied and formatted later: plain values and strings (stored as std::string).
+// Other types (e.g. user types, or fmt::join() views) might refer to data that is gone by the time
+// the backtrace is dumped, so messages with such arguments are formatted immediately.
+template<typename T, bool = fmt::internal::is_string<T>::value>
+struct is_char_string : std::false_type
+{};
+
+template<typename T>
+struct is_char_string<T, true> : std::is_same<fmt::char_t<T>, char>
+{};
+
+template<typename T>
+struct is_deferrable_arg : std::integral_constant<bool, std::is_arithmetic<T>::value || std::is_enum<T>::value ||
+                                                           std::is_pointer<T>::value || is_char_string<T>::value>
+{};
+
+template<typename... Args>
+struct are_deferrable_args : std::true_type
+{};
+
+template<typename T, typename... Args>
+struct are_deferrable_args<T, Args...> : std::integral_constant<bool, is_deferrable_arg<T>::value && are_deferrable_args<Args...>::value>
+{};
+
+// Copy of the format string and arguments of a message, to be formatted later.
+// Everything is packed in an inline buffer (no allocation): the arguments by value, the strings
+// (format string included) as offsets of their characters in the buffer.
+// assign() fails if they don't fit (then the message is formatted right away).
+class deferred_payload
+{
+public:
+    static const size_t capacity = 256;
+    static const size_t max_args = 16;
+
+    deferred_payload() = default;
+
+    // copy the used bytes only
+    deferred_payload(const deferred_payload &other)
+    {
+        *this = other;
+    }
+
+    deferred_payload &operator=(const deferred_payload &other)
+    {
+        std::memcpy(data_, other.data_, other.size_);
+        std::memcpy(arg_offsets_, other.arg_offsets_, other.args_count_ * sizeof(arg_offsets_[0]));
+        size_ = other.size_;
+        args_count_ = other.args_count_;
+        format_ = other.format_;
+        format_fn_ = other.format_fn_;
+        return *this;
+    }
+
+    template<typename... Args>
+    bool assign(string_view_t fmt, const Args &... args)
+    {
+        clear();
+        if (sizeof...(Args) > max_args || !store_string_(fmt, format_) || !store_args_(0, args...))
+        {
+            return false;
+        }
+        args_count_ = sizeof...(Args);
+        format_fn_ = &format_stored_<typename stored_arg<Args>::type...>;
+        return true;
+    }
+
+    void clear()
+    {
+        size_ = 0;
+        args_count_ = 0;
+        format_fn_ = nullptr;
+    }
+
+    bool empty() const
+    {
+        return format_fn_ == nullptr;
+    }
+
+    string_view_t format_string() const
+    {
+        return get_(format_);
+    }
+
+    // format the stored message. throws on invalid format.
+    void format_to(memory_buf_t &dest) const
+    {
+        format_fn_(*this, dest);
+    }
+
+private:
+    // a string copied in the buffer
+    struct stored_string
+    {
+        size_t offset;
+        size_t size;
+    };
+
+    template<typename T, bool = fmt::internal::is_string<T>::value>
+    struct stored_arg
+    {
+        using type = typename std::decay<T>::type;
+    };
+
+    template<typename T>
+    struct stored_arg<T, true>
+    {
+        using type = stored_string;
+    };
+
+    // unpack the stored arguments one by one, then format them
+    template<typename... Stored>
+    struct deferred_unpack
+    {
+        template<typename... Values>
+        static void format(const deferred_payload &payload, memory_buf_t &dest, size_t, const Values &... values)
+        {
+            fmt::format_to(dest, payload.format_string(), values...);
+        }
+    };
+
+    template<typename S, typename... Rest>
+    struct deferred_unpack<S, Rest...>
+    {
+        template<typename... Values>
+        static void format(const deferred_payload &payload, memory_buf_t &dest, size_t i, const Values &... values)
+        {
+            deferred_unpack<Rest...>::format(payload, dest, i + 1, values..., payload.get_(payload.arg_<S>(i)));
+        }
+    };
+
+    template<typename... Stored>
+    static void format_stored_(const deferred_payload &payload, memory_buf_t &dest)
+    {
+        deferred_unpack<Stored...>::format(payload, dest, 0);
+    }
+
+    // room for bytes at the given alignment, or nullptr if full
+    void *reserve_(size_t bytes, size_t alignment)
+    {
+        auto offset = (size_ + alignment - 1) / alignment * alignment;
+        if (offset + bytes > capacity)
+        {
+            return nullptr;
+        }
+        size_ = offset + bytes;
+        return data_ + offset;
+    }
+
+    bool store_string_(string_view_t str, stored_string &stored)
+    {
+        auto *chars = static_cast<char *>(reserve_(str.size(), 1));
+        if (chars == nullptr)
+        {
+            return false;
+        }
+        std::memcpy(chars, str.data(), str.size());
+        stored = stored_string{static_cast<size_t>(chars - data_), str.size()};
+        return true;
+    }
+
+    bool store_args_(size_t)
+    {
+        return true;
+    }
+
+    template<typename T, typename... Args>
+    bool store_args_(size_t i, const T &arg, const Args &... args)
+    {
+        return store_arg_(i, arg) && store_args_(i + 1, args...);
+    }
+
+    template<typename T, typename std::enable_if<!fmt::internal::is_string<T>::value, int>::type = 0>
+    bool store_arg_(size_t i, const T &arg)
+    {
+        using stored_t = typename stored_arg<T>::type;
+        auto *p = reserve_(sizeof(stored_t), alignof(stored_t));
+        if (p == nullptr)
+        {
+            return false;
+        }
+        new (p) stored_t(arg);
+        arg_offsets_[i] = static_cast<uint16_t>(static_cast<char *>(p) - data_);
+        return true;
+    }
+
+    template<typename T, typename std::enable_if<fmt::internal::is_string<T>::value, int>::type = 0>
+    bool store_arg_(size_t i, const T &arg)
+    {
+        stored_string chars{0, 0};
+        if (!store_string_(fmt::to_string_view(arg), chars))
+        {
+            return false;
+        }
+        return store_arg_(i, chars);
+    }
+
+    template<typename S>
+    const S &arg_(size_t i) const
+    {
+        return *reinterpret_cast<const S *>(data_ + arg_offsets_[i]);
+    }
+
+    template<typename T>
+    const T &get_(const T &value) const
+    {
+        return value;
+    }
+
+    string_view_t get_(const stored_string &str) const
+    {
+        return string_view_t{data_ + str.offset, str.size};
+    }
+
+    alignas(std::max_align_t) char data_[capacity];
+    uint16_t arg_offsets_[max_args];
+    size_t size_ = 0;
+    size_t args_count_ = 0;
+    stored_string format_{0, 0};
+    void (*format_fn_)(const deferred_payload &, memory_buf_t &) = nullptr;
+};
+
 class SPDLOG_API backtracer
 {
+    struct backtrace_msg
+    {
+        log_msg_buffer msg;
+        deferred_payload deferred; // if not empty, the msg payload is formatted from it
+    };
+
+    // Ring of the messages pushed by a single thread.
+    // Only the owning thread pushes into it, foreach_pop() takes the messages out with atomic exchanges.
+    struct thread_ring
+    {
+        explicit thread_ring(size_t size);
+        ~thread_ring();
+        thread_ring(const thread_ring &) = delete;
+        thread_ring &operator=(const thread_ring &) = delete;
+
+        size_t size;
+        std::unique_ptr<std::atomic<backtrace_msg *>[]> slots;
+        std::atomic<size_t> next{0};          // slot of the next push. written by the owning thread only
+        std::unique_ptr<backtrace_msg> spare; // message replaced by the last push, reused by the next one
+        std::atomic<bool> owner_alive{true};  // cleared when the owning thread exits
+    };
+
 #ifndef CEP_SPDLOG_MODIFIED
     mutable std::mutex mutex_;
 #else
@@ -25,10 +285,14 @@ class SPDLOG_API backtracer
 #endif
 #endif
     std::atomic<bool> enabled_{false};
-    circular_q<log_msg_buffer> messages_;
+    std::atomic<uint64_t> id_{next_id_()}; // identifies the current rings in the per thread caches
+    size_t size_ = 0;
+    std::vector<std::shared_ptr<thread_ring>> rings_;
 
 public:
     backtracer() = default;
+
+    // the copy is enabled as the other backtracer, but with empty rings (the messages are not copied)
     backtracer(
 #if defined(CEP_SPDLOG_MODIFIED) && defined(CEP_SPDLOG_USE_MUTEX)
 #else
@@ -44,8 +308,32 @@ public:
     bool enabled() const;
     void push_back(const log_msg &msg);
 
-    // pop all items in the q and apply the given fun on each of them.
+    // store the message without formatting it (its payload is ignored).
+    // the format string and the arguments are copied and formatted in foreach_pop().
+    // return false (and store nothing) if they don't fit in a deferred_payload.
+    template<typename... Args>
+    bool push_back_deferred(const log_msg &msg, string_view_t fmt, const Args &... args)
+    {
+        deferred_payload deferred;
+        if (!deferred.assign(fmt, args...))
+        {
+            return false;
+        }
+        push_back_(msg, &deferred);
+        return true;
+    }
+
+    // pop all items from the rings and apply the given fun on each of them, ordered by time.
     void foreach_pop(std::function<void(const details::log_msg &)> fun);
+
+private:
+    void push_back_(const log_msg &msg, const deferred_payload *deferred);
+
+    // the ring of the calling thread (registered on first use), or null if disabled.
+    std::shared_ptr<thread_ring> thread_ring_();
+
+    static void push_to_ring_(thread_ring &ring, const log_msg &msg, const deferred_payload *deferred);
+    static uint64_t next_id_();
 };
 
 } // namespace details
@@ -0,0 +1,58 @@
+// Copyright(c) 2015-present, Gabi Melman & spdlog contributors.
+// Distributed under the MIT License (http://opensource.org/licenses/MIT)
+
+#pragma once
+
+#ifndef SPDLOG_HEADER_ONLY
+#include <spdlog/details/batch_queue.h>
+#endif
+
+#include <utility>
+
+namespace spdlog {
+namespace details {
+
+SPDLOG_INLINE void batch_queue::storage::clear()
+{
+    data.clear();
+    ends.clear();
+    dropped = 0;
+}
+
+SPDLOG_INLINE void batch_queue::storage::to_batch(log_batch &batch) const
+{
+    batch.lines.clear();
+    size_t begin = 0;
+    for (auto end : ends)
+    {
+        batch.lines.emplace_back(data.data() + begin, end - begin);
+        begin = end;
+    }
+    batch.dropped = dropped;
+}
+
+SPDLOG_INLINE batch_queue::batch_queue(size_t max_lines, size_t max_bytes)
+    : max_lines_(max_lines)
+    , max_bytes_(max_bytes)
+{}
+
+SPDLOG_INLINE void batch_queue::push(string_view_t line)
+{
+    if (pending_.ends.size() >= max_lines_ || pending_.data.size() + line.size() > max_bytes_)
+    {
+        pending_.dropped++;
+        dropped_.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+    pending_.data.insert(pending_.data.end(), line.data(), line.data() + line.size());
+    pending_.ends.push_back(pending_.data.size());
+}
+
+SPDLOG_INLINE void batch_queue::take(storage &dest)
+{
+    dest.clear();
+    std::swap(dest, pending_);
+}
+
+} // namespace details
+} // namespace spdlog
@@ -0,0 +1,82 @@
+// Copyright(c) 2015-present, Gabi Melman & spdlog contributors.
+// Distributed under the MIT License (http://opensource.org/licenses/MIT)
+
+#pragma once
+
+// Bounded queue of formatted lines, delivered in batches (see stdout_sink_base::set_batch_handler()).
+//
+// The lines are copied to one contiguous buffer. When the pending batch holds max_lines or max_bytes,
+// the new lines are dropped and counted.
+// The deliverer swaps the pending batch with its own storage, so the producers are blocked by the swap only,
+// never by the batch handler. Once both storages have grown, nothing is allocated anymore.
+// Not thread safe: push() and take() are called under the sink mutex.
+
+#include <spdlog/common.h>
+
+#include <atomic>
+#include <vector>
+
+namespace spdlog {
+namespace details {
+
+class SPDLOG_API batch_queue
+{
+public:
+    struct storage
+    {
+        std::vector<char> data;
+        std::vector<size_t> ends; // end offset of each line in data
+        size_t dropped = 0;       // lines dropped before these ones
+
+        void clear();
+
+        // views of the lines into data
+        void to_batch(log_batch &batch) const;
+    };
+
+    batch_queue(size_t max_lines, size_t max_bytes);
+
+    batch_queue(const batch_queue &) = delete;
+    batch_queue &operator=(const batch_queue &) = delete;
+
+    // queue the line, or drop it if the pending batch is full
+    void push(string_view_t line);
+
+    // move the pending lines (and the count of lines dropped since the last take) to dest
+    void take(storage &dest);
+
+    bool empty() const
+    {
+        return pending_.ends.empty() && pending_.dropped == 0;
+    }
+
+    void add_delivered(size_t n)
+    {
+        delivered_.fetch_add(n, std::memory_order_relaxed);
+    }
+
+    // totals since the creation of the queue
+    size_t dropped() const
+    {
+        return dropped_.load(std::memory_order_relaxed);
+    }
+
+    size_t delivered() const
+    {
+        return delivered_.load(std::memory_order_relaxed);
+    }
+
+private:
+    size_t max_lines_;
+    size_t max_bytes_;
+    storage pending_;
+    std::atomic<size_t> dropped_{0};
+    std::atomic<size_t> delivered_{0};
+};
+
+} // namespace details
+} // namespace spdlog
+
+#ifdef SPDLOG_HEADER_ONLY
+#include "batch_queue-inl.h"
+#endif
@@ -0,0 +1,291 @@
+// Copyright(c) 2015-present, Gabi Melman & spdlog contributors.
+// Distributed under the MIT License (http://opensource.org/licenses/MIT)
+
+#pragma once
+
+#ifndef SPDLOG_HEADER_ONLY
+#include <spdlog/details/callsite.h>
+#endif
+
+#include <spdlog/details/os.h>
+
+#include <cstring>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+namespace spdlog {
+namespace details {
+
+struct callsite_rule
+{
+    bool by_file; // match the filename, or else the function name
+    std::string glob;
+    bool enabled;
+    level::level_enum max_level;
+
+    bool matches(const callsite &site) const
+    {
+        if (site.level() > max_level)
+        {
+            return false;
+        }
+        const char *name = by_file ? site.filename() : site.funcname();
+        return name != nullptr && callsite::glob_match(glob.c_str(), name);
+    }
+};
+
+// an explicit location, by its pointers (see callsite::of())
+struct explicit_location
+{
+    const char *filename;
+    int line;
+    const char *funcname;
+
+    bool operator==(const explicit_location &other) const
+    {
+        return filename == other.filename && line == other.line && funcname == other.funcname;
+    }
+};
+
+struct explicit_location_hash
+{
+    size_t operator()(const explicit_location &loc) const
+    {
+        return std::hash<const char *>()(loc.filename) ^ (std::hash<const char *>()(loc.funcname) * 31) ^ static_cast<size_t>(loc.line);
+    }
+};
+
+// descriptor of an explicit location, with copies of its names
+struct explicit_callsite
+{
+    explicit explicit_callsite(const source_loc &loc)
+        : filename(loc.filename != nullptr ? loc.filename : "")
+        , funcname(loc.funcname != nullptr ? loc.funcname : "")
+        , site(filename.c_str(), loc.line)
+    {}
+
+    std::string filename;
+    std::string funcname;
+    callsite site;
+};
+
+// the registered sites and the rules applied so far
+struct callsite_list
+{
+#ifdef CEP_SPDLOG_MODIFIED
+#ifdef CEP_SPDLOG_USE_MUTEX
+    cep::Mutex mutex;
+#endif
+#else
+    std::mutex mutex;
+#endif
+    callsite *head = nullptr;
+    std::vector<callsite_rule> rules;
+    std::unordered_map<explicit_location, std::unique_ptr<explicit_callsite>, explicit_location_hash> explicit_sites;
+
+    static callsite_list &instance()
+    {
+        static callsite_list s_instance;
+        return s_instance;
+    }
+
+    // add the rule and apply it on the registered sites. must be called under the mutex.
+    size_t apply_(callsite_rule rule)
+    {
+        size_t count = 0;
+        for (auto *site = head; site != nullptr; site = site->next_)
+        {
+            if (rule.matches(*site))
+            {
+                site->state_.store(rule.enabled ? callsite::state_enabled : callsite::state_disabled, std::memory_order_relaxed);
+                count++;
+            }
+        }
+        rules.push_back(std::move(rule));
+        return count;
+    }
+};
+
+SPDLOG_INLINE void callsite::init_names_(const char *funcname)
+{
+    funcname_ = funcname != nullptr ? funcname : "";
+    funcname_size_ = std::strlen(funcname_);
+    filename_size_ = std::strlen(filename_);
+    const char *sep = std::strrchr(filename_, os::folder_sep);
+    short_filename_ = sep != nullptr ? sep + 1 : filename_;
+}
+
+SPDLOG_INLINE bool callsite::register_(const char *funcname, level::level_enum lvl)
+{
+    auto &list = callsite_list::instance();
+#ifdef CEP_SPDLOG_MODIFIED
+#ifdef CEP_SPDLOG_USE_MUTEX
+    cep::Lock_Guard lock{list.mutex};
+#endif
+#else
+    std::lock_guard<std::mutex> lock(list.mutex);
+#endif
+    // another thread might have registered the site in the meantime
+    if (state_.load(std::memory_order_relaxed) == state_unregistered)
+    {
+        init_names_(funcname);
+        level_ = lvl;
+        next_ = list.head;
+        list.head = this;
+
+        bool is_enabled = true;
+        for (const auto &rule : list.rules)
+        {
+            if (rule.matches(*this))
+            {
+                is_enabled = rule.enabled;
+            }
+        }
+        state_.store(is_enabled ? state_enabled : state_disabled, std::memory_order_release);
+    }
+    return state_.load(std::memory_order_relaxed) == state_enabled;
+}
+
+SPDLOG_INLINE const callsite *callsite::intern_(const source_loc &loc)
+{
+    explicit_location key{loc.filename, loc.line, loc.funcname};
+#if !defined(SPDLOG_NO_TLS)
+    // the last locations interned by this thread, so repeated explicit locations don't lock
+    struct cached_site
+    {
+        explicit_location key;
+        const callsite *site;
+    };
+    static thread_local cached_site cache[4];
+    static thread_local size_t next_cached = 0;
+    for (const auto &entry : cache)
+    {
+        if (entry.site != nullptr && entry.key == key)
+        {
+            return entry.site;
+        }
+    }
+#endif
+
+    const callsite *site;
+    {
+        auto &list = callsite_list::instance();
+#ifdef CEP_SPDLOG_MODIFIED
+#ifdef CEP_SPDLOG_USE_MUTEX
+        cep::Lock_Guard lock{list.mutex};
+#endif
+#else
+        std::lock_guard<std::mutex> lock(list.mutex);
+#endif
+        auto &interned = list.explicit_sites[key];
+        if (!interned)
+        {
+            interned.reset(new explicit_callsite(loc));
+            interned->site.init_names_(interned->funcname.c_str());
+        }
+        site = &interned->site;
+    }
+
+#if !defined(SPDLOG_NO_TLS)
+    cache[next_cached++ % 4] = cached_site{key, site};
+#endif
+    return site;
+}
+
+SPDLOG_INLINE size_t callsite::set_enabled_by_file(const std::string &file_glob, bool enabled, level::level_enum max_level)
+{
+    auto &list = callsite_list::instance();
+#ifdef CEP_SPDLOG_MODIFIED
+#ifdef CEP_SPDLOG_USE_MUTEX
+    cep::Lock_Guard lock{list.mutex};
+#endif
+#else
+    std::lock_guard<std::mutex> lock(list.mutex);
+#endif
+    return list.apply_(callsite_rule{true, file_glob, enabled, max_level});
+}
+
+SPDLOG_INLINE size_t callsite::set_enabled_by_function(const std::string &funcname_glob, bool enabled, level::level_enum max_level)
+{
+    auto &list = callsite_list::instance();
+#ifdef CEP_SPDLOG_MODIFIED
+#ifdef CEP_SPDLOG_USE_MUTEX
+    cep::Lock_Guard lock{list.mutex};
+#endif
+#else
+    std::lock_guard<std::mutex> lock(list.mutex);
+#endif
+    return list.apply_(callsite_rule{false, funcname_glob, enabled, max_level});
+}
+
+SPDLOG_INLINE void callsite::reset_all()
+{
+    auto &list = callsite_list::instance();
+#ifdef CEP_SPDLOG_MODIFIED
+#ifdef CEP_SPDLOG_USE_MUTEX
+    cep::Lock_Guard lock{list.mutex};
+#endif
+#else
+    std::lock_guard<std::mutex> lock(list.mutex);
+#endif
+    list.rules.clear();
+    for (auto *site = list.head; site != nullptr; site = site->next_)
+    {
+        site->state_.store(state_enabled, std::memory_order_relaxed);
+    }
+}
+
+SPDLOG_INLINE void callsite::for_each(const std::function<void(const callsite &, bool)> &fun)
+{
+    auto &list = callsite_list::instance();
+#ifdef CEP_SPDLOG_MODIFIED
+#ifdef CEP_SPDLOG_USE_MUTEX
+    cep::Lock_Guard lock{list.mutex};
+#endif
+#else
+    std::lock_guard<std::mutex> lock(list.mutex);
+#endif
+    for (auto *site = list.head; site != nullptr; site = site->next_)
+    {
+        fun(*site, site->state_.load(std::memory_order_relaxed) == state_enabled);
+    }
+}
+
+SPDLOG_INLINE bool callsite::glob_match(const char *pattern, const char *str)
+{
+    // iterative matching with backtracking to the last '*'
+    const char *star = nullptr;
+    const char *star_str = nullptr;
+    while (*str != '\0')
+    {
+        if (*pattern == '?' || *pattern == *str)
+        {
+            ++pattern;
+            ++str;
+        }
+        else if (*pattern == '*')
+        {
+            star = pattern++;
+            star_str = str;
+        }
+        else if (star != nullptr)
+        {
+            pattern = star + 1;
+            str = ++star_str;
+        }
+        else
+        {
+            return false;
+        }
+    }
+    while (*pattern == '*')
+    {
+        ++pattern;
+    }
+    return *pattern == '\0';
+}
+
+} // namespace details
+} // namespace spdlog
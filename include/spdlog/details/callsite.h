@@ -0,0 +1,164 @@
+// Copyright(c) 2015-present, Gabi Melman & spdlog contributors.
+// Distributed under the MIT License (http://opensource.org/licenses/MIT)
+
+#pragma once
+
+// Static descriptor of a log call site (see SPDLOG_LOGGER_CALL in spdlog.h).
+//
+// Each call site owns a constant initialized descriptor, which registers itself in a global list
+// the first time the site is reached. Sites can then be disabled/enabled at runtime by their source
+// file or function name (see spdlog::set_callsites_by_file()), without changing the logger level.
+// Checking if a site is enabled costs a single load of its state byte.
+//
+// The messages refer to the descriptor of their location only (see log_msg::source), and the formatters use
+// the lengths and the short filename computed at registration. A location given without a descriptor
+// (e.g. an explicit source_loc passed to logger::log()) gets one on its first use: such descriptors are
+// interned by the location pointers and line, keep copies of the names, and are never freed.
+
+#include <spdlog/common.h>
+#include <spdlog/details/os.h>
+
+#include <atomic>
+#include <cstring>
+#include <functional>
+#include <string>
+
+namespace spdlog {
+namespace details {
+
+class SPDLOG_API callsite
+{
+public:
+    SPDLOG_CONSTEXPR callsite(const char *filename, int line) SPDLOG_NOEXCEPT : filename_(filename), line_(line) {}
+
+    callsite(const callsite &) = delete;
+    callsite &operator=(const callsite &) = delete;
+
+    // register the site on its first call.
+    // acquire: the names set by the registration are read by the formatters.
+    bool enabled(const char *funcname, level::level_enum lvl)
+    {
+        auto state = state_.load(std::memory_order_acquire);
+        return state == state_enabled || (state == state_unregistered && register_(funcname, lvl));
+    }
+
+    const char *filename() const
+    {
+        return filename_;
+    }
+
+    int line() const
+    {
+        return line_;
+    }
+
+    // null until the site is registered
+    const char *funcname() const
+    {
+        return funcname_;
+    }
+
+    size_t filename_size() const
+    {
+        return filename_size_;
+    }
+
+    size_t funcname_size() const
+    {
+        return funcname_size_;
+    }
+
+    // the filename without its directories
+    const char *short_filename() const
+    {
+        return short_filename_;
+    }
+
+    size_t short_filename_size() const
+    {
+        return filename_size_ - static_cast<size_t>(short_filename_ - filename_);
+    }
+
+    level::level_enum level() const
+    {
+        return level_;
+    }
+
+    // Enable/disable the sites whose filename matches the given glob ('*' and '?' wildcards), and
+    // whose level is at most max_level. The rule also applies to sites that are registered later.
+    // Return the number of matching registered sites.
+    static size_t set_enabled_by_file(const std::string &file_glob, bool enabled, level::level_enum max_level);
+
+    // Same as set_enabled_by_file(), but match the function name (as given by SPDLOG_FUNCTION).
+    static size_t set_enabled_by_function(const std::string &funcname_glob, bool enabled, level::level_enum max_level);
+
+    // Remove all the rules and enable all the sites.
+    static void reset_all();
+
+    // Apply the given function on all the registered sites.
+    static void for_each(const std::function<void(const callsite &, bool enabled)> &fun);
+
+    // Simple glob matching, with '*' (any sequence) and '?' (any character) wildcards
+    static bool glob_match(const char *pattern, const char *str);
+
+    // The descriptor of a location: the registered site of a log macro, or the interned descriptor
+    // of an explicit location (slow path). nullptr if the location is empty.
+    static const callsite *of(const source_loc &loc)
+    {
+        if (loc.site != nullptr && loc.site->funcname() != nullptr)
+        {
+            return loc.site;
+        }
+        return loc.empty() ? nullptr : intern_(loc);
+    }
+
+private:
+    friend struct callsite_list;
+
+    static const callsite *intern_(const source_loc &loc);
+
+    enum : unsigned char
+    {
+        state_unregistered,
+        state_enabled,
+        state_disabled
+    };
+
+    bool register_(const char *funcname, level::level_enum lvl);
+
+    // set the function name, and compute the name sizes and the short filename
+    void init_names_(const char *funcname);
+
+    const char *filename_;
+    int line_;
+    const char *funcname_{nullptr};
+    const char *short_filename_{nullptr};
+    size_t filename_size_{0};
+    size_t funcname_size_{0};
+    level::level_enum level_{level::off};
+    std::atomic<unsigned char> state_{state_unregistered};
+    callsite *next_{nullptr}; // next registered site
+};
+
+// The names of a descriptor (registered or interned, see of())
+inline string_view_t source_filename(const callsite &site)
+{
+    return string_view_t(site.filename(), site.filename_size());
+}
+
+inline string_view_t source_short_filename(const callsite &site)
+{
+    return string_view_t(site.short_filename(), site.short_filename_size());
+}
+
+inline string_view_t source_funcname(const callsite &site)
+{
+    return string_view_t(site.funcname(), site.funcname_size());
+}
+
+} // namespace details
+} // namespace spdlog
+
+#ifdef SPDLOG_HEADER_ONLY
+#include "callsite-inl.h"
+#endif
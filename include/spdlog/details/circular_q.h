@@ -4,6 +4,8 @@
 // circular q view of std::vector.
 #pragma once
 
+#include <spdlog/memory_resource.h>
+
 #include <vector>
 #include <cassert>
 
@@ -16,7 +18,7 @@ class circular_q
     typename std::vector<T>::size_type head_ = 0;
     typename std::vector<T>::size_type tail_ = 0;
     size_t overrun_counter_ = 0;
-    std::vector<T> v_;
+    std::vector<T, polymorphic_allocator<T>> v_;
 
 public:
     using value_type = T;
@@ -24,10 +26,13 @@ public:
     // empty ctor - create a disabled queue with no elements allocated at all
     circular_q() = default;
 
-    explicit circular_q(size_t max_items)
+    // the items are allocated from the given resource (the default resource if null)
+    explicit circular_q(size_t max_items, memory_resource *resource = nullptr)
         : max_items_(max_items + 1) // one item is reserved as marker for full q
-        , v_(max_items_)
-    {}
+        , v_(polymorphic_allocator<T>(resource))
+    {
+        v_.resize(max_items_);
+    }
 
     circular_q(const circular_q &) = default;
     circular_q &operator=(const circular_q &) = default;
@@ -47,10 +52,18 @@ public:
 
     // push back, overrun (oldest) item if no room left
     void push_back(T &&item)
+    {
+        push_back_with([&item](T &slot) { slot = std::move(item); });
+    }
+
+    // push back an item filled in place by fill(T &slot), overrun (oldest) item if no room left.
+    // the slot holds an old item: fill can reuse its resources (e.g. the capacity of a buffer).
+    template<typename Fill>
+    void push_back_with(Fill &&fill)
     {
         if (max_items_ > 0)
         {
-            v_[tail_] = std::move(item);
+            fill(v_[tail_]);
             tail_ = (tail_ + 1) % max_items_;
 
             if (tail_ == head_) // overrun last item if full
@@ -0,0 +1,85 @@
+// Copyright(c) 2015-present, Gabi Melman & spdlog contributors.
+// Distributed under the MIT License (http://opensource.org/licenses/MIT)
+
+#pragma once
+
+#ifndef SPDLOG_HEADER_ONLY
+#include <spdlog/details/console_buffer.h>
+#endif
+
+#include <spdlog/details/os.h>
+
+namespace spdlog {
+namespace details {
+
+SPDLOG_INLINE console_buffer::console_buffer(FILE *file)
+    : file_(file)
+{}
+
+SPDLOG_INLINE void console_buffer::set_mode(console_buffering mode, std::chrono::milliseconds max_latency, size_t block_size)
+{
+    flush();
+    switch (mode)
+    {
+    case console_buffering::line:
+        block_mode_ = false;
+        break;
+    case console_buffering::block:
+        block_mode_ = true;
+        break;
+    case console_buffering::automatic:
+        block_mode_ = !os::in_terminal(file_);
+        break;
+    }
+    max_latency_ = max_latency;
+    block_size_ = block_size;
+}
+
+SPDLOG_INLINE void console_buffer::line_done()
+{
+    if (!block_mode_)
+    {
+        write_();
+        fflush(file_); // flush every line to terminal
+        return;
+    }
+
+    auto now = std::chrono::steady_clock::now();
+    if (pending_lines_++ == 0)
+    {
+        oldest_ = now;
+    }
+    if (buf_.size() >= block_size_ || now - oldest_ >= max_latency_)
+    {
+        write_();
+        fflush(file_);
+    }
+}
+
+SPDLOG_INLINE void console_buffer::flush_pending()
+{
+    if (pending_lines_ > 0)
+    {
+        write_();
+        fflush(file_);
+    }
+}
+
+SPDLOG_INLINE void console_buffer::flush()
+{
+    write_();
+    fflush(file_);
+}
+
+SPDLOG_INLINE void console_buffer::write_()
+{
+    if (buf_.size() > 0)
+    {
+        fwrite(buf_.data(), sizeof(char), buf_.size(), file_);
+    }
+    buf_.clear();
+    pending_lines_ = 0;
+}
+
+} // namespace details
+} // namespace spdlog
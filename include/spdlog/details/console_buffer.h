@@ -0,0 +1,78 @@
+// Copyright(c) 2015-present, Gabi Melman & spdlog contributors.
+// Distributed under the MIT License (http://opensource.org/licenses/MIT)
+
+#pragma once
+
+// Output buffer of the console sinks (see console_buffering).
+//
+// The sink appends the whole line (color codes included) to buf() and calls line_done():
+//  - line mode:  the line is written with a single fwrite and flushed.
+//  - block mode: the lines are accumulated and written with a single fwrite + fflush
+//                when block_size is reached or when the oldest pending line is max_latency old.
+//                The age is checked on the next line only: the sink runs a periodic flush_pending()
+//                to bound the latency of the last lines.
+// Not thread safe: the sink calls it under its mutex.
+
+#include <spdlog/common.h>
+
+#include <chrono>
+#include <cstdio>
+
+namespace spdlog {
+namespace details {
+
+class SPDLOG_API console_buffer
+{
+public:
+    static SPDLOG_CONSTEXPR const size_t default_block_size = 64 * 1024;
+
+    explicit console_buffer(FILE *file);
+
+    console_buffer(const console_buffer &) = delete;
+    console_buffer &operator=(const console_buffer &) = delete;
+
+    // write the pending lines and switch mode (automatic: line if the file is a terminal, block otherwise)
+    void set_mode(console_buffering mode, std::chrono::milliseconds max_latency, size_t block_size);
+
+    bool block_mode() const
+    {
+        return block_mode_;
+    }
+
+    std::chrono::milliseconds max_latency() const
+    {
+        return max_latency_;
+    }
+
+    memory_buf_t &buf()
+    {
+        return buf_;
+    }
+
+    // a whole line was appended to buf()
+    void line_done();
+
+    // write the pending lines if any
+    void flush_pending();
+
+    // write the pending lines and flush the file
+    void flush();
+
+private:
+    void write_();
+
+    FILE *file_;
+    bool block_mode_ = false;
+    std::chrono::milliseconds max_latency_{0};
+    size_t block_size_ = default_block_size;
+    size_t pending_lines_ = 0;
+    std::chrono::steady_clock::time_point oldest_;
+    memory_buf_t buf_;
+};
+
+} // namespace details
+} // namespace spdlog
+
+#ifdef SPDLOG_HEADER_ONLY
+#include "console_buffer-inl.h"
+#endif
@@ -0,0 +1,175 @@
+// Copyright(c) 2015-present, Gabi Melman & spdlog contributors.
+// Distributed under the MIT License (http://opensource.org/licenses/MIT)
+
+#pragma once
+
+#ifndef SPDLOG_HEADER_ONLY
+#include <spdlog/details/file_archiver.h>
+#endif
+
+#include <spdlog/details/lz4_block.h>
+#include <spdlog/details/os.h>
+
+#include <cstdio>
+
+namespace spdlog {
+namespace details {
+
+// os::fopen_s() opens files for writing only
+static SPDLOG_INLINE std::FILE *fopen_for_read_(const filename_t &filename)
+{
+#if defined(_WIN32) && defined(SPDLOG_WCHAR_FILENAMES)
+    return ::_wfopen(filename.c_str(), L"rb");
+#else
+    return std::fopen(filename.c_str(), "rb");
+#endif
+}
+
+SPDLOG_INLINE file_archiver::file_archiver(archive_policy policy)
+    : policy_(policy)
+    , total_bytes_(0)
+    , worker_(true)
+{}
+
+SPDLOG_INLINE void file_archiver::add_file(filename_t filename)
+{
+    auto closed_time = log_clock::now();
+    worker_.post([this, filename, closed_time]() { this->archive_(filename, closed_time); });
+}
+
+SPDLOG_INLINE void file_archiver::wait_idle()
+{
+    worker_.wait_idle();
+}
+
+SPDLOG_INLINE std::vector<filename_t> file_archiver::archived_files()
+{
+    std::lock_guard<std::mutex> lock(files_mutex_);
+    std::vector<filename_t> ret;
+    ret.reserve(files_.size());
+    for (const auto &f : files_)
+    {
+        ret.push_back(f.filename);
+    }
+    return ret;
+}
+
+SPDLOG_INLINE std::size_t file_archiver::total_bytes()
+{
+    std::lock_guard<std::mutex> lock(files_mutex_);
+    return total_bytes_;
+}
+
+SPDLOG_INLINE rotation_hook file_archiver::make_hook(std::shared_ptr<file_archiver> archiver)
+{
+    return [archiver](const filename_t &filename) { archiver->add_file(filename); };
+}
+
+SPDLOG_INLINE void file_archiver::archive_(const filename_t &filename, log_clock::time_point closed_time)
+{
+    std::FILE *fp = fopen_for_read_(filename);
+    if (fp == nullptr)
+    {
+        return; // already gone, nothing to archive
+    }
+    std::size_t size = os::filesize(fp);
+    std::fclose(fp);
+
+    archived_file archived{filename, size, closed_time};
+    if (policy_.compress)
+    {
+        filename_t target = filename + SPDLOG_FILENAME_T(".lz4");
+        std::size_t target_size = 0;
+        // on failure keep the uncompressed file, so nothing is lost
+        if (compress_file_(filename, target, target_size) && os::remove(filename) == 0)
+        {
+            archived.filename = std::move(target);
+            archived.size = target_size;
+        }
+    }
+
+    std::lock_guard<std::mutex> lock(files_mutex_);
+    total_bytes_ += archived.size;
+    files_.push_back(std::move(archived));
+    enforce_retention_(log_clock::now());
+}
+
+SPDLOG_INLINE bool file_archiver::compress_file_(const filename_t &src, const filename_t &target, std::size_t &target_size)
+{
+    // compress in 256KB blocks, so big files don't need big buffers
+    const std::size_t block_size = 256 * 1024;
+
+    std::FILE *in = fopen_for_read_(src);
+    if (in == nullptr)
+    {
+        return false;
+    }
+    std::FILE *out = nullptr;
+    if (os::fopen_s(&out, target, SPDLOG_FILENAME_T("wb")))
+    {
+        std::fclose(in);
+        return false;
+    }
+
+    memory_buf_t input;
+    memory_buf_t output;
+    lz4::append_le32(lz4::legacy_magic, output);
+    target_size = 0;
+    bool ok = true;
+    for (;;)
+    {
+        input.resize(block_size);
+        auto n = std::fread(input.data(), 1, block_size, in);
+        if (n > 0)
+        {
+            output.resize(output.size() + 4);
+            auto compressed_size = lz4::compress_block(input.data(), n, output);
+            auto *size_pos = output.data() + output.size() - compressed_size - 4;
+            size_pos[0] = static_cast<char>(compressed_size & 0xff);
+            size_pos[1] = static_cast<char>((compressed_size >> 8) & 0xff);
+            size_pos[2] = static_cast<char>((compressed_size >> 16) & 0xff);
+            size_pos[3] = static_cast<char>((compressed_size >> 24) & 0xff);
+        }
+        if (std::fwrite(output.data(), 1, output.size(), out) != output.size())
+        {
+            ok = false;
+            break;
+        }
+        target_size += output.size();
+        output.clear();
+        if (n < block_size)
+        {
+            ok = std::ferror(in) == 0;
+            break;
+        }
+    }
+
+    std::fclose(in);
+    ok = std::fclose(out) == 0 && ok;
+    if (!ok)
+    {
+        (void)os::remove(target);
+    }
+    return ok;
+}
+
+SPDLOG_INLINE void file_archiver::enforce_retention_(log_clock::time_point now)
+{
+    while (!files_.empty())
+    {
+        const auto &oldest = files_.front();
+        bool too_many = policy_.max_files > 0 && files_.size() > policy_.max_files;
+        bool too_big = policy_.max_total_bytes > 0 && total_bytes_ > policy_.max_total_bytes;
+        bool too_old = policy_.max_age > std::chrono::seconds::zero() && now - oldest.closed_time > policy_.max_age;
+        if (!too_many && !too_big && !too_old)
+        {
+            break;
+        }
+        (void)os::remove_if_exists(oldest.filename);
+        total_bytes_ -= oldest.size;
+        files_.pop_front();
+    }
+}
+
+} // namespace details
+} // namespace spdlog
@@ -0,0 +1,104 @@
+// Copyright(c) 2015-present, Gabi Melman & spdlog contributors.
+// Distributed under the MIT License (http://opensource.org/licenses/MIT)
+
+#pragma once
+
+// Background archiving of closed log files.
+//
+// The rotating and daily file sinks call their rotation hook with the name of each
+// file they are done with. The file_archiver takes ownership of those files and, on its own
+// low priority thread (never on the logging thread):
+//    compresses them to <filename>.lz4 (lz4 legacy frame, see details/lz4_block.h) and deletes the original.
+//    enforces the retention policy: deletes the oldest archived files beyond max_files,
+//    beyond max_total_bytes, or older than max_age.
+//
+// Retention only applies to the files handed over to this archiver (i.e. since the process started).
+//
+// Usage:
+//    spdlog::details::archive_policy policy;
+//    policy.max_total_bytes = 50 * 1024 * 1024;
+//    auto archiver = std::make_shared<spdlog::details::file_archiver>(policy);
+//    sink->set_rotation_hook(spdlog::details::file_archiver::make_hook(archiver));
+
+#include <spdlog/common.h>
+#include <spdlog/details/task_worker.h>
+
+#include <chrono>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace spdlog {
+namespace details {
+
+// Called by the file sinks with the name of a file they closed and will never write to again.
+// The hook takes ownership of the file (it may compress, move or delete it).
+using rotation_hook = std::function<void(const filename_t &filename)>;
+
+struct archive_policy
+{
+    // compress the files to <filename>.lz4 and delete the originals
+    bool compress = true;
+    // max number of archived files to keep (0 = unlimited)
+    std::size_t max_files = 0;
+    // max total size in bytes of the archived files to keep (0 = unlimited)
+    std::size_t max_total_bytes = 0;
+    // delete archived files older than this (0 = never)
+    std::chrono::seconds max_age{0};
+};
+
+class SPDLOG_API file_archiver
+{
+public:
+    explicit file_archiver(archive_policy policy = archive_policy());
+    file_archiver(const file_archiver &) = delete;
+    file_archiver &operator=(const file_archiver &) = delete;
+
+    // Take ownership of the given closed file and return immediately.
+    // The file is archived and the retention policy enforced in the background thread.
+    void add_file(filename_t filename);
+
+    // Block until all the files added so far were processed
+    void wait_idle();
+
+    // Names of the archived files currently kept, oldest first
+    std::vector<filename_t> archived_files();
+
+    // Total size in bytes of the archived files currently kept
+    std::size_t total_bytes();
+
+    // Create a rotation hook that hands over the rotated files to the given archiver
+    static rotation_hook make_hook(std::shared_ptr<file_archiver> archiver);
+
+private:
+    struct archived_file
+    {
+        filename_t filename;
+        std::size_t size;
+        log_clock::time_point closed_time;
+    };
+
+    // runs in the worker thread
+    void archive_(const filename_t &filename, log_clock::time_point closed_time);
+
+    // compress the src file into target. return false on failure (the src file is kept).
+    bool compress_file_(const filename_t &src, const filename_t &target, std::size_t &target_size);
+
+    // delete the oldest archived files until the policy is satisfied
+    void enforce_retention_(log_clock::time_point now);
+
+    archive_policy policy_;
+    std::mutex files_mutex_;
+    std::deque<archived_file> files_;
+    std::size_t total_bytes_;
+    task_worker worker_; // must be last, so it finishes the pending work before the other members are destroyed
+};
+
+} // namespace details
+} // namespace spdlog
+
+#ifdef SPDLOG_HEADER_ONLY
+#include "file_archiver-inl.h"
+#endif
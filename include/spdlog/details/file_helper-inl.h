@@ -8,6 +8,7 @@
 #endif
 
 #include <spdlog/details/os.h>
+#include <spdlog/details/profiler.h>
 #include <spdlog/common.h>
 
 #include <cerrno>
@@ -16,6 +17,7 @@
 #include <string>
 #include <thread>
 #include <tuple>
+#include <utility>
 
 namespace spdlog {
 namespace details {
@@ -37,6 +39,12 @@ SPDLOG_INLINE void file_helper::open(const filename_t &fname, bool truncate)
         os::create_dir(os::dir_name(fname));
         if (!os::fopen_s(&fd_, fname, mode))
         {
+#ifndef CEP_SPDLOG_MODIFIED
+            if (group_commit_)
+            {
+                group_commit_->set_file(fd_);
+            }
+#endif
             return;
         }
 
@@ -57,6 +65,13 @@ SPDLOG_INLINE void file_helper::reopen(bool truncate)
 
 SPDLOG_INLINE void file_helper::flush()
 {
+#ifndef CEP_SPDLOG_MODIFIED
+    if (group_commit_)
+    {
+        group_commit_->commit();
+        return;
+    }
+#endif
     std::fflush(fd_);
 }
 
@@ -64,6 +79,12 @@ SPDLOG_INLINE void file_helper::close()
 {
     if (fd_ != nullptr)
     {
+#ifndef CEP_SPDLOG_MODIFIED
+        if (group_commit_)
+        {
+            group_commit_->set_file(nullptr);
+        }
+#endif
         std::fclose(fd_);
         fd_ = nullptr;
     }
@@ -71,6 +92,14 @@ SPDLOG_INLINE void file_helper::close()
 
 SPDLOG_INLINE void file_helper::write(const memory_buf_t &buf)
 {
+    SPDLOG_PROFILE_STAGE(&profiling::sink_profile(), profiling::sink_write);
+#ifndef CEP_SPDLOG_MODIFIED
+    if (group_commit_)
+    {
+        group_commit_->append(buf);
+        return;
+    }
+#endif
     size_t msg_size = buf.size();
     auto data = buf.data();
     if (std::fwrite(data, 1, msg_size, fd_) != msg_size)
@@ -93,6 +122,53 @@ SPDLOG_INLINE const filename_t &file_helper::filename() const
     return filename_;
 }
 
+SPDLOG_INLINE bool file_helper::rename(const filename_t &new_filename)
+{
+    if (os::rename(filename_, new_filename) != 0)
+    {
+        return false;
+    }
+    filename_ = new_filename;
+    return true;
+}
+
+SPDLOG_INLINE void file_helper::swap(file_helper &other) SPDLOG_NOEXCEPT
+{
+#ifndef CEP_SPDLOG_MODIFIED
+    // the pending data goes to the file it was written to. the group commits stay with their helpers.
+    if (group_commit_)
+    {
+        group_commit_->set_file(other.fd_);
+    }
+    if (other.group_commit_)
+    {
+        other.group_commit_->set_file(fd_);
+    }
+#endif
+    std::swap(fd_, other.fd_);
+    std::swap(filename_, other.filename_);
+}
+
+#ifndef CEP_SPDLOG_MODIFIED
+SPDLOG_INLINE void file_helper::enable_group_commit(std::chrono::microseconds window)
+{
+    if (fd_ != nullptr)
+    {
+        std::fflush(fd_); // from now on, the data bypasses the stdio buffer
+    }
+    group_commit_ = details::make_unique<group_commit>(window);
+    group_commit_->set_file(fd_);
+}
+
+SPDLOG_INLINE void file_helper::wait_durable()
+{
+    if (group_commit_)
+    {
+        group_commit_->wait();
+    }
+}
+#endif
+
 //
 // return file path and its extension:
 //
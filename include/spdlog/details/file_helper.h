@@ -4,6 +4,12 @@
 #pragma once
 
 #include <spdlog/common.h>
+#ifndef CEP_SPDLOG_MODIFIED
+#include <spdlog/details/group_commit.h>
+#endif
+
+#include <chrono>
+#include <memory>
 #include <tuple>
 
 namespace spdlog {
@@ -30,6 +36,23 @@ public:
     size_t size() const;
     const filename_t &filename() const;
 
+    // rename the file while keeping it open (not supported under windows).
+    // return true on success, false otherwise.
+    bool rename(const filename_t &new_filename);
+
+    // exchange the open files (and their names) of this and other.
+    void swap(file_helper &other) SPDLOG_NOEXCEPT;
+
+#ifndef CEP_SPDLOG_MODIFIED
+    // Durable writes with group commit (see details/group_commit.h): write() queues the data,
+    // wait_durable() blocks until the data written so far is on disk, and flush() syncs it.
+    // Must be enabled before writing from several threads.
+    void enable_group_commit(std::chrono::microseconds window);
+
+    // no-op if group commit isn't enabled
+    void wait_durable();
+#endif
+
     //
     // return file path and its extension:
     //
@@ -50,6 +73,9 @@ private:
     const int open_interval_ = 10;
     std::FILE *fd_{nullptr};
     filename_t filename_;
+#ifndef CEP_SPDLOG_MODIFIED
+    std::unique_ptr<group_commit> group_commit_;
+#endif
 };
 } // namespace details
 } // namespace spdlog
@@ -0,0 +1,179 @@
+// Copyright(c) 2015-present, Gabi Melman & spdlog contributors.
+// Distributed under the MIT License (http://opensource.org/licenses/MIT)
+
+#pragma once
+
+#ifndef SPDLOG_HEADER_ONLY
+#include <spdlog/details/flush_scheduler.h>
+#endif
+
+#include <algorithm>
+
+namespace spdlog {
+namespace details {
+
+SPDLOG_INLINE flush_scheduler::flush_scheduler()
+    : start_(std::chrono::steady_clock::now())
+    , last_tick_(0)
+    , next_id_(1)
+    , slots_(n_slots)
+    , active_(true)
+    , changed_(false)
+{
+    worker_thread_ = std::thread([this]() { worker_loop_(); });
+}
+
+SPDLOG_INLINE flush_scheduler::~flush_scheduler()
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        active_ = false;
+    }
+    cv_.notify_one();
+    worker_thread_.join();
+}
+
+SPDLOG_INLINE uint64_t flush_scheduler::add(task_t task, std::chrono::milliseconds interval)
+{
+    auto interval_ticks = static_cast<uint64_t>((std::max)(interval.count(), static_cast<std::chrono::milliseconds::rep>(1)));
+    uint64_t id;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        id = next_id_++;
+        auto e = std::make_shared<entry>();
+        e->id = id;
+        e->task = std::move(task);
+        e->interval_ticks = interval_ticks;
+        e->removed = false;
+        schedule_(e, now_tick_() + interval_ticks);
+        entries_[id] = std::move(e);
+        changed_ = true;
+    }
+    cv_.notify_one();
+    return id;
+}
+
+SPDLOG_INLINE void flush_scheduler::remove(uint64_t id)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = entries_.find(id);
+    if (it != entries_.end())
+    {
+        // the entry is dropped from its slot when the worker visits it
+        it->second->removed = true;
+        entries_.erase(it);
+    }
+}
+
+SPDLOG_INLINE size_t flush_scheduler::size()
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    return entries_.size();
+}
+
+SPDLOG_INLINE uint64_t flush_scheduler::now_tick_() const
+{
+    auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start_);
+    return static_cast<uint64_t>(elapsed.count());
+}
+
+SPDLOG_INLINE void flush_scheduler::schedule_(const entry_ptr &e, uint64_t deadline)
+{
+    e->deadline = deadline;
+    slots_[deadline % n_slots].push_back(e);
+}
+
+SPDLOG_INLINE void flush_scheduler::collect_due_(uint64_t now_tick)
+{
+    if (now_tick <= last_tick_)
+    {
+        return;
+    }
+    // visit the slots of the ticks elapsed since the last visit (each slot once if a whole turn elapsed)
+    uint64_t first = now_tick - last_tick_ >= n_slots ? now_tick - n_slots + 1 : last_tick_ + 1;
+    for (uint64_t tick = first; tick <= now_tick; tick++)
+    {
+        auto &slot = slots_[tick % n_slots];
+        auto keep = std::remove_if(slot.begin(), slot.end(), [this, now_tick](const entry_ptr &e) {
+            if (e->removed)
+            {
+                return true;
+            }
+            if (e->deadline <= now_tick)
+            {
+                due_.push_back(e);
+                return true;
+            }
+            return false; // due in a later turn of the wheel
+        });
+        slot.erase(keep, slot.end());
+    }
+    last_tick_ = now_tick;
+}
+
+SPDLOG_INLINE uint64_t flush_scheduler::next_tick_(uint64_t now_tick) const
+{
+    for (uint64_t tick = now_tick + 1; tick <= now_tick + n_slots; tick++)
+    {
+        if (!slots_[tick % n_slots].empty())
+        {
+            return tick;
+        }
+    }
+    return 0;
+}
+
+SPDLOG_INLINE void flush_scheduler::worker_loop_()
+{
+    std::unique_lock<std::mutex> lock(mutex_);
+    while (active_)
+    {
+        collect_due_(now_tick_());
+        if (!due_.empty())
+        {
+            // run the tasks without holding the lock, so add()/remove() can be called meanwhile.
+            // due_ is used by this thread only.
+            std::vector<char> keep(due_.size());
+            lock.unlock();
+            for (size_t i = 0; i < due_.size(); i++)
+            {
+                keep[i] = due_[i]->task() ? 1 : 0;
+            }
+            lock.lock();
+
+            auto now_tick = now_tick_();
+            for (size_t i = 0; i < due_.size(); i++)
+            {
+                auto &e = due_[i];
+                if (e->removed)
+                {
+                    continue;
+                }
+                if (!keep[i])
+                {
+                    entries_.erase(e->id);
+                    continue;
+                }
+                // keep the period of the task, unless it is late by more than a period
+                auto next = e->deadline + e->interval_ticks;
+                schedule_(e, next > now_tick ? next : now_tick + e->interval_ticks);
+            }
+            due_.clear();
+            continue;
+        }
+
+        changed_ = false;
+        auto next_tick = next_tick_(last_tick_);
+        if (next_tick == 0)
+        {
+            cv_.wait(lock, [this] { return !active_ || changed_; });
+        }
+        else
+        {
+            cv_.wait_until(lock, start_ + std::chrono::milliseconds(next_tick), [this] { return !active_ || changed_; });
+        }
+    }
+}
+
+} // namespace details
+} // namespace spdlog
@@ -0,0 +1,86 @@
+// Copyright(c) 2015-present, Gabi Melman & spdlog contributors.
+// Distributed under the MIT License (http://opensource.org/licenses/MIT)
+
+#pragma once
+
+// Periodic tasks (flushes) on a single thread, with millisecond granularity.
+//
+// The tasks are kept in a hashed timer wheel of n_slots 1ms slots: a task due at tick t is in slot t % n_slots,
+// so adding and rescheduling a task is O(1), and each tick only visits the tasks of its slot.
+// The thread sleeps until the next non empty slot (or until a task is added), it doesn't wake up every tick.
+// A task returns false to unschedule itself (e.g. its logger is gone).
+
+#include <spdlog/common.h>
+
+#include <chrono>
+#include <condition_variable>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+namespace spdlog {
+namespace details {
+
+class SPDLOG_API flush_scheduler
+{
+public:
+    using task_t = std::function<bool()>;
+    static const size_t n_slots = 1024;
+
+    flush_scheduler();
+    // stop the thread and join it (if a task is running, wait for it to finish first)
+    ~flush_scheduler();
+
+    flush_scheduler(const flush_scheduler &) = delete;
+    flush_scheduler &operator=(const flush_scheduler &) = delete;
+
+    // run task every interval (at least 1ms), starting interval from now. return its id.
+    uint64_t add(task_t task, std::chrono::milliseconds interval);
+
+    // unschedule the task (it can still be running when this returns)
+    void remove(uint64_t id);
+
+    size_t size();
+
+private:
+    struct entry
+    {
+        uint64_t id;
+        task_t task;
+        uint64_t interval_ticks;
+        uint64_t deadline; // tick
+        bool removed;
+    };
+    using entry_ptr = std::shared_ptr<entry>;
+
+    uint64_t now_tick_() const;
+    void schedule_(const entry_ptr &e, uint64_t deadline);
+    // move the entries due at or before now_tick to due_
+    void collect_due_(uint64_t now_tick);
+    // tick of the first non empty slot after now_tick (0 if none)
+    uint64_t next_tick_(uint64_t now_tick) const;
+    void worker_loop_();
+
+    const std::chrono::steady_clock::time_point start_;
+    uint64_t last_tick_;
+    uint64_t next_id_;
+    std::vector<std::vector<entry_ptr>> slots_;
+    std::unordered_map<uint64_t, entry_ptr> entries_;
+    std::vector<entry_ptr> due_;
+
+    bool active_;
+    bool changed_;
+    std::mutex mutex_;
+    std::condition_variable cv_;
+    std::thread worker_thread_;
+};
+
+} // namespace details
+} // namespace spdlog
+
+#ifdef SPDLOG_HEADER_ONLY
+#include "flush_scheduler-inl.h"
+#endif
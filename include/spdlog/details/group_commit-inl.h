@@ -0,0 +1,110 @@
+// Copyright(c) 2015-present, Gabi Melman & spdlog contributors.
+// Distributed under the MIT License (http://opensource.org/licenses/MIT)
+
+#pragma once
+
+#ifndef SPDLOG_HEADER_ONLY
+#include <spdlog/details/group_commit.h>
+#endif
+
+#include <spdlog/details/os.h>
+
+#include <cerrno>
+#include <thread>
+#include <utility>
+
+namespace spdlog {
+namespace details {
+
+SPDLOG_INLINE group_commit::group_commit(std::chrono::microseconds window)
+    : window_(window)
+{}
+
+SPDLOG_INLINE void group_commit::append(const memory_buf_t &buf)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    pending_.insert(pending_.end(), buf.data(), buf.data() + buf.size());
+    appended_++;
+}
+
+SPDLOG_INLINE void group_commit::wait()
+{
+    std::unique_lock<std::mutex> lock(mutex_);
+    auto seq = appended_;
+    while (durable_ < seq)
+    {
+        if (leader_)
+        {
+            cv_.wait(lock);
+            continue;
+        }
+        leader_ = true;
+        lock.unlock();
+        if (window_ > std::chrono::microseconds::zero())
+        {
+            std::this_thread::sleep_for(window_);
+        }
+        commit();
+        lock.lock();
+        leader_ = false;
+        cv_.notify_all(); // the next waiter leads the next group
+    }
+    if (seq > failed_from_ && seq <= failed_to_)
+    {
+        throw_spdlog_ex("group commit: failed writing to disk", failed_errno_);
+    }
+}
+
+SPDLOG_INLINE void group_commit::commit()
+{
+    std::lock_guard<std::mutex> io_lock(io_mutex_);
+    commit_locked_();
+}
+
+SPDLOG_INLINE void group_commit::set_file(std::FILE *f)
+{
+    std::lock_guard<std::mutex> io_lock(io_mutex_);
+    commit_locked_();
+    file_ = f;
+}
+
+SPDLOG_INLINE void group_commit::commit_locked_()
+{
+    uint64_t seq;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (durable_ == appended_)
+        {
+            return;
+        }
+        std::swap(pending_, writing_);
+        seq = appended_;
+    }
+
+    // the producers keep appending to the other buffer meanwhile
+    int err = 0;
+    if (file_ == nullptr)
+    {
+        err = EBADF;
+    }
+    else if (!os::write_durable(file_, writing_.data(), writing_.size()))
+    {
+        err = errno;
+    }
+    writing_.clear();
+
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (err != 0)
+        {
+            failed_from_ = durable_;
+            failed_to_ = seq;
+            failed_errno_ = err;
+        }
+        durable_ = seq;
+    }
+    cv_.notify_all();
+}
+
+} // namespace details
+} // namespace spdlog
@@ -0,0 +1,72 @@
+// Copyright(c) 2015-present, Gabi Melman & spdlog contributors.
+// Distributed under the MIT License (http://opensource.org/licenses/MIT)
+
+#pragma once
+
+// Group commit of durable file writes (see file_helper::enable_group_commit()).
+//
+// append() copies the data to the pending buffer (under the sink mutex), and wait() blocks the calling thread
+// until it is on disk. The first waiter becomes the leader of the group: it sleeps for window so the other
+// producers can append and join the group, then writes the whole pending buffer at once and calls fdatasync()
+// once, and wakes up the group. The producers arriving during the sync form the next group.
+// The messages are staged in one contiguous buffer, so the group is written by a single write() call.
+
+#include <spdlog/common.h>
+
+#include <chrono>
+#include <condition_variable>
+#include <cstdio>
+#include <mutex>
+#include <vector>
+
+namespace spdlog {
+namespace details {
+
+class SPDLOG_API group_commit
+{
+public:
+    explicit group_commit(std::chrono::microseconds window);
+
+    group_commit(const group_commit &) = delete;
+    group_commit &operator=(const group_commit &) = delete;
+
+    void append(const memory_buf_t &buf);
+
+    // block until the data appended so far is on disk.
+    // throw spdlog_ex if writing or syncing it failed.
+    void wait();
+
+    // write and sync the pending data now
+    void commit();
+
+    // write and sync the pending data to the current file, then switch to f (can be null)
+    void set_file(std::FILE *f);
+
+private:
+    // must be called with io_mutex_ held
+    void commit_locked_();
+
+    const std::chrono::microseconds window_;
+    std::FILE *file_ = nullptr;
+
+    std::mutex mutex_;    // protects the fields below
+    std::mutex io_mutex_; // protects file_ and writing_. taken before mutex_
+    std::condition_variable cv_;
+    std::vector<char> pending_;
+    std::vector<char> writing_;
+    uint64_t appended_ = 0; // number of append() calls
+    uint64_t durable_ = 0;  // number of appended buffers that are on disk (or failed)
+    bool leader_ = false;
+
+    // last failed group: the buffers appended_ in (failed_from_, failed_to_]
+    uint64_t failed_from_ = 0;
+    uint64_t failed_to_ = 0;
+    int failed_errno_ = 0;
+};
+
+} // namespace details
+} // namespace spdlog
+
+#ifdef SPDLOG_HEADER_ONLY
+#include "group_commit-inl.h"
+#endif
@@ -20,7 +20,8 @@ SPDLOG_INLINE log_msg::log_msg(spdlog::log_clock::time_point log_time, SPDLOG_SO
 #ifndef SPDLOG_NO_THREAD_ID
     , thread_id(os::thread_id())
 #endif
-    , source(loc)
+    , thread_name(os::thread_name())
+    , source(callsite::of(loc))
     , payload(msg)
 {}
 
@@ -4,6 +4,7 @@
 #pragma once
 
 #include <spdlog/common.h>
+#include <spdlog/details/callsite.h>
 #include <string>
 
 namespace spdlog {
@@ -20,12 +21,15 @@ struct SPDLOG_API log_msg
     level::level_enum level{level::off};
     log_clock::time_point time;
     size_t thread_id{0};
+    string_view_t thread_name; // set by os::set_thread_name()
 
     // wrapping the formatted text with color (updated by pattern_formatter).
     mutable size_t color_range_start{0};
     mutable size_t color_range_end{0};
 
-    source_loc source;
+    // descriptor of the location (see callsite::of()): the site of a log macro, or an interned explicit location.
+    // nullptr if unknown.
+    const callsite *source{nullptr};
     string_view_t payload;
 };
 } // namespace details
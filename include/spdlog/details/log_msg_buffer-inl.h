@@ -10,19 +10,27 @@
 namespace spdlog {
 namespace details {
 
-SPDLOG_INLINE log_msg_buffer::log_msg_buffer(const log_msg &orig_msg)
+SPDLOG_INLINE log_msg_buffer::log_msg_buffer(memory_resource *resource)
+    : buffer{polymorphic_allocator<char>(resource)}
+{}
+
+SPDLOG_INLINE log_msg_buffer::log_msg_buffer(const log_msg &orig_msg, memory_resource *resource)
     : log_msg{orig_msg}
+    , buffer{polymorphic_allocator<char>(resource)}
 {
     buffer.append(logger_name.begin(), logger_name.end());
     buffer.append(payload.begin(), payload.end());
+    buffer.append(thread_name.begin(), thread_name.end());
     update_string_views();
 }
 
 SPDLOG_INLINE log_msg_buffer::log_msg_buffer(const log_msg_buffer &other)
     : log_msg{other}
+    , buffer{other.buffer.get_allocator()}
 {
     buffer.append(logger_name.begin(), logger_name.end());
     buffer.append(payload.begin(), payload.end());
+    buffer.append(thread_name.begin(), thread_name.end());
     update_string_views();
 }
 
@@ -48,10 +56,21 @@ SPDLOG_INLINE log_msg_buffer &log_msg_buffer::operator=(log_msg_buffer &&other)
     return *this;
 }
 
+SPDLOG_INLINE void log_msg_buffer::assign(const log_msg &msg)
+{
+    log_msg::operator=(msg);
+    buffer.clear();
+    buffer.append(logger_name.begin(), logger_name.end());
+    buffer.append(payload.begin(), payload.end());
+    buffer.append(thread_name.begin(), thread_name.end());
+    update_string_views();
+}
+
 SPDLOG_INLINE void log_msg_buffer::update_string_views()
 {
     logger_name = string_view_t{buffer.data(), logger_name.size()};
     payload = string_view_t{buffer.data() + logger_name.size(), payload.size()};
+    thread_name = string_view_t{buffer.data() + logger_name.size() + payload.size(), thread_name.size()};
 }
 
 } // namespace details
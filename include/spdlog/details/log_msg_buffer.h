@@ -4,25 +4,37 @@
 #pragma once
 
 #include <spdlog/details/log_msg.h>
+#include <spdlog/memory_resource.h>
 
 namespace spdlog {
 namespace details {
 
 // Extend log_msg with internal buffer to store its payload.
 // This is needed since log_msg holds string_views that points to stack data.
+// The payloads too long for the inline storage are allocated from the memory resource of the buffer
+// (the default resource unless given). A copy uses the resource of the original, a move takes it along.
 
 class SPDLOG_API log_msg_buffer : public log_msg
 {
-    memory_buf_t buffer;
+    fmt::basic_memory_buffer<char, 250, polymorphic_allocator<char>> buffer;
     void update_string_views();
 
 public:
     log_msg_buffer() = default;
-    explicit log_msg_buffer(const log_msg &orig_msg);
+    explicit log_msg_buffer(memory_resource *resource);
+    explicit log_msg_buffer(const log_msg &orig_msg, memory_resource *resource = nullptr);
     log_msg_buffer(const log_msg_buffer &other);
     log_msg_buffer(log_msg_buffer &&other) SPDLOG_NOEXCEPT;
     log_msg_buffer &operator=(const log_msg_buffer &other);
     log_msg_buffer &operator=(log_msg_buffer &&other) SPDLOG_NOEXCEPT;
+
+    // copy msg, reusing the capacity of the buffer (no allocation once it has grown to the message size)
+    void assign(const log_msg &msg);
+
+    memory_resource *resource() const
+    {
+        return buffer.get_allocator().resource();
+    }
 };
 
 } // namespace details
@@ -0,0 +1,256 @@
+// Copyright(c) 2015-present, Gabi Melman & spdlog contributors.
+// Distributed under the MIT License (http://opensource.org/licenses/MIT)
+
+#pragma once
+
+#ifndef SPDLOG_HEADER_ONLY
+#include <spdlog/details/lz4_block.h>
+#endif
+
+#include <cstring>
+
+namespace spdlog {
+namespace details {
+namespace lz4 {
+
+// format constants (see https://github.com/lz4/lz4/blob/dev/doc/lz4_Block_format.md)
+SPDLOG_CONSTEXPR static const size_t min_match = 4;
+SPDLOG_CONSTEXPR static const size_t last_literals = 5; // the last 5 bytes are always literals
+SPDLOG_CONSTEXPR static const size_t mf_limit = 12;     // the last match must start at least 12 bytes before the end
+SPDLOG_CONSTEXPR static const size_t max_distance = 65535;
+SPDLOG_CONSTEXPR static const int hash_log = 12;
+
+static inline uint32_t read32(const unsigned char *p)
+{
+    uint32_t v;
+    std::memcpy(&v, p, sizeof(v));
+    return v;
+}
+
+static inline uint32_t hash32(uint32_t sequence)
+{
+    return (sequence * 2654435761U) >> (32 - hash_log);
+}
+
+// write length in the lz4 "15 + 255 + 255 + .. + remainder" encoding
+static inline void append_length(size_t len, memory_buf_t &dest)
+{
+    for (; len >= 255; len -= 255)
+    {
+        dest.push_back(static_cast<char>(255));
+    }
+    dest.push_back(static_cast<char>(len));
+}
+
+static inline void append_sequence(const unsigned char *literals, size_t literals_len, size_t offset, size_t match_len, memory_buf_t &dest)
+{
+    auto token_pos = dest.size();
+    dest.push_back(0);
+
+    unsigned token = 0;
+    if (literals_len >= 15)
+    {
+        token = 15u << 4;
+        append_length(literals_len - 15, dest);
+    }
+    else
+    {
+        token = static_cast<unsigned>(literals_len) << 4;
+    }
+    dest.append(reinterpret_cast<const char *>(literals), reinterpret_cast<const char *>(literals) + literals_len);
+
+    // the last sequence contains literals only
+    if (match_len > 0)
+    {
+        dest.push_back(static_cast<char>(offset & 0xff));
+        dest.push_back(static_cast<char>((offset >> 8) & 0xff));
+        auto len = match_len - min_match;
+        if (len >= 15)
+        {
+            token |= 15u;
+            append_length(len - 15, dest);
+        }
+        else
+        {
+            token |= static_cast<unsigned>(len);
+        }
+    }
+    dest[token_pos] = static_cast<char>(token);
+}
+
+// read length in the lz4 "15 + 255 + 255 + .. + remainder" encoding.
+// return false on truncated input.
+static inline bool read_length(const unsigned char *&ip, const unsigned char *iend, size_t &len)
+{
+    unsigned char b;
+    do
+    {
+        if (ip >= iend)
+        {
+            return false;
+        }
+        b = *ip++;
+        len += b;
+    } while (b == 255);
+    return true;
+}
+
+SPDLOG_INLINE size_t compress_block(const char *src, size_t src_size, memory_buf_t &dest)
+{
+    const auto orig_size = dest.size();
+    dest.reserve(orig_size + compress_bound(src_size));
+
+    const auto *base = reinterpret_cast<const unsigned char *>(src);
+    const auto *ip = base;
+    const auto *anchor = base;
+    const auto *iend = base + src_size;
+
+    if (src_size > mf_limit)
+    {
+        const auto *match_limit = iend - last_literals;
+        const auto *ilimit = iend - mf_limit;
+
+        // positions (relative to base) of the last occurrence of each hashed 4 bytes sequence
+        uint32_t table[1 << hash_log];
+        std::memset(table, 0, sizeof(table));
+
+        ++ip;
+        while (ip < ilimit)
+        {
+            auto sequence = read32(ip);
+            auto h = hash32(sequence);
+            const auto *ref = base + table[h];
+            table[h] = static_cast<uint32_t>(ip - base);
+
+            if (ref >= ip || static_cast<size_t>(ip - ref) > max_distance || read32(ref) != sequence)
+            {
+                ++ip;
+                continue;
+            }
+
+            // extend the match backwards as long as it doesn't overlap already emitted data
+            while (ip > anchor && ref > base && ip[-1] == ref[-1])
+            {
+                --ip;
+                --ref;
+            }
+
+            // extend the match forward
+            size_t match_len = min_match;
+            while (ip + match_len < match_limit && ip[match_len] == ref[match_len])
+            {
+                ++match_len;
+            }
+
+            append_sequence(anchor, static_cast<size_t>(ip - anchor), static_cast<size_t>(ip - ref), match_len, dest);
+            ip += match_len;
+            anchor = ip;
+        }
+    }
+
+    append_sequence(anchor, static_cast<size_t>(iend - anchor), 0, 0, dest);
+    return dest.size() - orig_size;
+}
+
+SPDLOG_INLINE bool decompress_block(const char *src, size_t src_size, memory_buf_t &dest, size_t max_output)
+{
+    const auto *ip = reinterpret_cast<const unsigned char *>(src);
+    const auto *iend = ip + src_size;
+    const auto orig_size = dest.size();
+
+    while (ip < iend)
+    {
+        unsigned token = *ip++;
+
+        size_t literals_len = token >> 4;
+        if (literals_len == 15 && !read_length(ip, iend, literals_len))
+        {
+            return false;
+        }
+        if (literals_len > static_cast<size_t>(iend - ip) || dest.size() - orig_size + literals_len > max_output)
+        {
+            return false;
+        }
+        dest.append(reinterpret_cast<const char *>(ip), reinterpret_cast<const char *>(ip) + literals_len);
+        ip += literals_len;
+
+        // the last sequence has no match part
+        if (ip == iend)
+        {
+            return true;
+        }
+
+        if (iend - ip < 2)
+        {
+            return false;
+        }
+        size_t offset = static_cast<size_t>(ip[0]) | (static_cast<size_t>(ip[1]) << 8);
+        ip += 2;
+
+        size_t match_len = token & 15u;
+        if (match_len == 15 && !read_length(ip, iend, match_len))
+        {
+            return false;
+        }
+        match_len += min_match;
+
+        auto out_size = dest.size() - orig_size;
+        if (offset == 0 || offset > out_size || out_size + match_len > max_output)
+        {
+            return false;
+        }
+
+        // byte by byte copy - the match may overlap the bytes it produces
+        auto pos = dest.size();
+        dest.resize(pos + match_len);
+        auto *out = dest.data();
+        for (size_t i = 0; i < match_len; ++i)
+        {
+            out[pos + i] = out[pos + i - offset];
+        }
+    }
+    return false; // a valid block always ends with a literals only sequence
+}
+
+SPDLOG_INLINE bool decompress_frame(const char *src, size_t src_size, memory_buf_t &dest)
+{
+    const auto *ip = reinterpret_cast<const unsigned char *>(src);
+    const auto *iend = ip + src_size;
+
+    while (ip < iend)
+    {
+        if (iend - ip < 4)
+        {
+            return false;
+        }
+        uint32_t size = static_cast<uint32_t>(ip[0]) | (static_cast<uint32_t>(ip[1]) << 8) | (static_cast<uint32_t>(ip[2]) << 16) |
+                        (static_cast<uint32_t>(ip[3]) << 24);
+        ip += 4;
+
+        // concatenated frames are allowed, so the magic may appear again
+        if (size == legacy_magic)
+        {
+            continue;
+        }
+
+        if (size > static_cast<size_t>(iend - ip) ||
+            !decompress_block(reinterpret_cast<const char *>(ip), size, dest, max_block_size))
+        {
+            return false;
+        }
+        ip += size;
+    }
+    return true;
+}
+
+SPDLOG_INLINE void append_le32(uint32_t value, memory_buf_t &dest)
+{
+    dest.push_back(static_cast<char>(value & 0xff));
+    dest.push_back(static_cast<char>((value >> 8) & 0xff));
+    dest.push_back(static_cast<char>((value >> 16) & 0xff));
+    dest.push_back(static_cast<char>((value >> 24) & 0xff));
+}
+
+} // namespace lz4
+} // namespace details
+} // namespace spdlog
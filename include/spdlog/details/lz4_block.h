@@ -0,0 +1,57 @@
+// Copyright(c) 2015-present, Gabi Melman & spdlog contributors.
+// Distributed under the MIT License (http://opensource.org/licenses/MIT)
+
+#pragma once
+
+// Minimal, dependency free, LZ4 block compressor.
+//
+// Produces standard LZ4 blocks, wrapped in the LZ4 "legacy" frame format:
+//    [magic (4 bytes)] [block size (4 bytes LE)] [block] [block size] [block] ...
+// Every block is independent, so a file written this way stays readable
+// (by "lz4 -d" or by decompress_block()) up to the last complete block even if
+// the process crashed in the middle of writing.
+
+#include <spdlog/common.h>
+
+#include <cstdint>
+
+namespace spdlog {
+namespace details {
+namespace lz4 {
+
+// magic number of the lz4 legacy frame format
+SPDLOG_CONSTEXPR static const uint32_t legacy_magic = 0x184C2102;
+
+// max uncompressed size of a single block in the legacy frame format (8MB).
+SPDLOG_CONSTEXPR static const size_t max_block_size = 8 * 1024 * 1024;
+
+// worst case size of a compressed block for the given input size
+SPDLOG_CONSTEXPR inline size_t compress_bound(size_t src_size)
+{
+    return src_size + src_size / 255 + 16;
+}
+
+// Compress the given data (at most max_block_size bytes) into a single lz4
+// block and append it to dest.
+// Return the number of bytes appended.
+SPDLOG_API size_t compress_block(const char *src, size_t src_size, memory_buf_t &dest);
+
+// Decompress a single lz4 block and append the result to dest.
+// Return false if the block is malformed or decompresses to more than max_output bytes.
+SPDLOG_API bool decompress_block(const char *src, size_t src_size, memory_buf_t &dest, size_t max_output = max_block_size);
+
+// Decompress a whole legacy frame (e.g. the content of a file written by
+// compressed_rotating_file_sink) and append the result to dest.
+// Return false if the frame is malformed.
+SPDLOG_API bool decompress_frame(const char *src, size_t src_size, memory_buf_t &dest);
+
+// Append a little endian uint32 to the dest buffer
+SPDLOG_API void append_le32(uint32_t value, memory_buf_t &dest);
+
+} // namespace lz4
+} // namespace details
+} // namespace spdlog
+
+#ifdef SPDLOG_HEADER_ONLY
+#include "lz4_block-inl.h"
+#endif
@@ -5,8 +5,8 @@
 
 // multi producer-multi consumer blocking queue.
 // enqueue(..) - will block until room found to put the new message.
-// enqueue_nowait(..) - will return immediately with false if no room left in
-// the queue.
+// enqueue_nowait(..) - will overrun the oldest message if no room left in
+// the queue (or wait for the consumer to pop it if it must not be overrun, see overrunnable()).
 // dequeue_for(..) - will block until the queue is not empty or timeout have
 // passed.
 
@@ -18,13 +18,21 @@
 namespace spdlog {
 namespace details {
 
+// Can enqueue_nowait() overrun the item. Overloaded (and found by argument dependent lookup) for the
+// items that must not be lost.
+template<typename T>
+bool overrunnable(const T &)
+{
+    return true;
+}
+
 template<typename T>
 class mpmc_blocking_queue
 {
 public:
     using item_type = T;
-    explicit mpmc_blocking_queue(size_t max_items)
-        : q_(max_items)
+    explicit mpmc_blocking_queue(size_t max_items, memory_resource *resource = nullptr)
+        : q_(max_items, resource)
     {}
 
 #ifndef __MINGW32__
@@ -39,11 +47,13 @@ public:
         push_cv_.notify_one();
     }
 
-    // enqueue immediately. overrun oldest message in the queue if no room left.
+    // enqueue immediately. overrun oldest message in the queue if no room left
+    // (wait until it is dequeued instead if it can't be overrun).
     void enqueue_nowait(T &&item)
     {
         {
             std::unique_lock<std::mutex> lock(queue_mutex_);
+            pop_cv_.wait(lock, [this] { return !this->q_.full() || overrunnable(this->q_.front()); });
             q_.push_back(std::move(item));
         }
         push_cv_.notify_one();
@@ -79,10 +89,12 @@ public:
         push_cv_.notify_one();
     }
 
-    // enqueue immediately. overrun oldest message in the queue if no room left.
+    // enqueue immediately. overrun oldest message in the queue if no room left
+    // (wait until it is dequeued instead if it can't be overrun).
     void enqueue_nowait(T &&item)
     {
         std::unique_lock<std::mutex> lock(queue_mutex_);
+        pop_cv_.wait(lock, [this] { return !this->q_.full() || overrunnable(this->q_.front()); });
         q_.push_back(std::move(item));
         push_cv_.notify_one();
     }
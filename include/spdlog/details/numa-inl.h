@@ -0,0 +1,147 @@
+// Copyright(c) 2015-present, Gabi Melman & spdlog contributors.
+// Distributed under the MIT License (http://opensource.org/licenses/MIT)
+
+#pragma once
+
+#ifndef SPDLOG_HEADER_ONLY
+#include <spdlog/details/numa.h>
+#endif
+
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <thread>
+#include <utility>
+
+#ifdef __linux__
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+namespace spdlog {
+namespace details {
+
+#ifdef __linux__
+// first line of a sysfs file, empty if it can't be read
+static std::string read_sysfs_line(const std::string &path)
+{
+    std::string line;
+    std::FILE *f = std::fopen(path.c_str(), "r");
+    if (f == nullptr)
+    {
+        return line;
+    }
+    char buf[1024];
+    if (std::fgets(buf, sizeof(buf), f) != nullptr)
+    {
+        line = buf;
+    }
+    std::fclose(f);
+    return line;
+}
+#endif
+
+SPDLOG_INLINE const numa_topology &numa_topology::instance()
+{
+    static const numa_topology topology = [] {
+        std::vector<std::vector<int>> nodes_cpus;
+#ifdef __linux__
+        for (int node : parse_cpu_list(read_sysfs_line("/sys/devices/system/node/online")))
+        {
+            auto cpus = parse_cpu_list(read_sysfs_line("/sys/devices/system/node/node" + std::to_string(node) + "/cpulist"));
+            if (!cpus.empty()) // skip the memory only nodes
+            {
+                nodes_cpus.push_back(std::move(cpus));
+            }
+        }
+#endif
+        if (nodes_cpus.empty())
+        {
+            std::vector<int> cpus;
+            for (unsigned int cpu = 0; cpu < std::max(std::thread::hardware_concurrency(), 1u); cpu++)
+            {
+                cpus.push_back(static_cast<int>(cpu));
+            }
+            nodes_cpus.push_back(std::move(cpus));
+        }
+        return numa_topology(std::move(nodes_cpus));
+    }();
+    return topology;
+}
+
+SPDLOG_INLINE numa_topology::numa_topology(std::vector<std::vector<int>> nodes_cpus)
+    : nodes_cpus_(std::move(nodes_cpus))
+{
+    for (size_t node = 0; node < nodes_cpus_.size(); node++)
+    {
+        for (int cpu : nodes_cpus_[node])
+        {
+            if (static_cast<size_t>(cpu) >= cpu_node_.size())
+            {
+                cpu_node_.resize(static_cast<size_t>(cpu) + 1, 0);
+            }
+            cpu_node_[static_cast<size_t>(cpu)] = node;
+        }
+    }
+}
+
+SPDLOG_INLINE size_t numa_topology::current_node() const
+{
+    if (nodes_cpus_.size() < 2)
+    {
+        return 0;
+    }
+#ifdef __linux__
+    return node_of_cpu(sched_getcpu()); // vdso call, no syscall
+#else
+    return 0;
+#endif
+}
+
+SPDLOG_INLINE bool numa_topology::bind_current_thread(size_t node) const
+{
+#ifdef __linux__
+    if (node >= nodes_cpus_.size())
+    {
+        return false;
+    }
+    cpu_set_t cpu_set;
+    CPU_ZERO(&cpu_set);
+    for (int cpu : nodes_cpus_[node])
+    {
+        if (cpu < CPU_SETSIZE)
+        {
+            CPU_SET(cpu, &cpu_set);
+        }
+    }
+    return pthread_setaffinity_np(pthread_self(), sizeof(cpu_set), &cpu_set) == 0;
+#else
+    (void)node;
+    return false;
+#endif
+}
+
+SPDLOG_INLINE std::vector<int> numa_topology::parse_cpu_list(const std::string &list)
+{
+    std::vector<int> cpus;
+    const char *p = list.c_str();
+    while (*p >= '0' && *p <= '9')
+    {
+        char *end;
+        auto first = static_cast<int>(std::strtol(p, &end, 10));
+        auto last = first;
+        if (*end == '-')
+        {
+            last = static_cast<int>(std::strtol(end + 1, &end, 10));
+        }
+        for (int cpu = first; cpu <= last; cpu++)
+        {
+            cpus.push_back(cpu);
+        }
+        p = *end == ',' ? end + 1 : end;
+    }
+    return cpus;
+}
+
+} // namespace details
+} // namespace spdlog
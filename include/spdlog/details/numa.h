@@ -0,0 +1,65 @@
+// Copyright(c) 2015-present, Gabi Melman & spdlog contributors.
+// Distributed under the MIT License (http://opensource.org/licenses/MIT)
+
+#pragma once
+
+// NUMA topology of the machine: the nodes with CPUs, and the CPUs of each node.
+// Read once from /sys/devices/system/node under Linux (no libnuma needed).
+// Elsewhere, or if it can't be read, the machine is a single node with all the CPUs.
+//
+// The nodes are numbered 0..nodes_count()-1 (the nodes without CPUs are skipped, so the numbers
+// may differ from the kernel's node ids).
+
+#include <spdlog/common.h>
+
+#include <string>
+#include <vector>
+
+namespace spdlog {
+namespace details {
+
+class SPDLOG_API numa_topology
+{
+public:
+    // the topology of this machine
+    static const numa_topology &instance();
+
+    // topology given as the CPUs of each node
+    explicit numa_topology(std::vector<std::vector<int>> nodes_cpus);
+
+    size_t nodes_count() const
+    {
+        return nodes_cpus_.size();
+    }
+
+    const std::vector<int> &node_cpus(size_t node) const
+    {
+        return nodes_cpus_[node];
+    }
+
+    // node of the cpu (0 if unknown)
+    size_t node_of_cpu(int cpu) const
+    {
+        return cpu >= 0 && static_cast<size_t>(cpu) < cpu_node_.size() ? cpu_node_[static_cast<size_t>(cpu)] : 0;
+    }
+
+    // node of the CPU running the calling thread (0 if unknown)
+    size_t current_node() const;
+
+    // restrict the calling thread to the CPUs of the node. return false if not supported or failed.
+    bool bind_current_thread(size_t node) const;
+
+    // parse a kernel cpu list (e.g. "0-3,8,10-11")
+    static std::vector<int> parse_cpu_list(const std::string &list);
+
+private:
+    std::vector<std::vector<int>> nodes_cpus_;
+    std::vector<size_t> cpu_node_; // index: cpu
+};
+
+} // namespace details
+} // namespace spdlog
+
+#ifdef SPDLOG_HEADER_ONLY
+#include "numa-inl.h"
+#endif
@@ -8,8 +8,10 @@
 #endif
 
 #include <spdlog/common.h>
+#include <spdlog/details/tsc_clock.h>
 
 #include <algorithm>
+#include <cerrno>
 #include <chrono>
 #include <cstdio>
 #include <cstdlib>
@@ -18,6 +20,7 @@
 #include <string>
 #include <thread>
 #include <array>
+#include <atomic>
 #include <sys/stat.h>
 #include <sys/types.h>
 
@@ -42,8 +45,13 @@
 #include <fcntl.h>
 #include <unistd.h>
 
+#ifndef CEP_SPDLOG_MODIFIED
+#include <pthread.h> // for pthread_atfork
+#endif
+
 #ifdef __linux__
-#include <sys/syscall.h> //Use gettid() syscall under linux to get thread id
+#include <sys/resource.h> // for setpriority
+#include <sys/syscall.h>  //Use gettid() syscall under linux to get thread id
 
 #elif defined(_AIX)
 #include <pthread.h> // for pthread_getthreadid_np
@@ -68,18 +76,49 @@ namespace spdlog {
 namespace details {
 namespace os {
 
+// constant initialized: no guard in now()
+SPDLOG_INLINE std::atomic<int> &clock_source_state() SPDLOG_NOEXCEPT
+{
+#ifdef SPDLOG_CLOCK_COARSE
+    static std::atomic<int> source{static_cast<int>(clock_source::coarse)};
+#else
+    static std::atomic<int> source{static_cast<int>(clock_source::system)};
+#endif
+    return source;
+}
+
 SPDLOG_INLINE spdlog::log_clock::time_point now() SPDLOG_NOEXCEPT
 {
+    switch (static_cast<clock_source>(clock_source_state().load(std::memory_order_relaxed)))
+    {
+    case clock_source::tsc:
+        return tsc_clock::instance().now();
+#ifdef __linux__
+    case clock_source::coarse: {
+        timespec ts;
+        ::clock_gettime(CLOCK_REALTIME_COARSE, &ts);
+        return std::chrono::time_point<log_clock, typename log_clock::duration>(std::chrono::duration_cast<typename log_clock::duration>(
+            std::chrono::seconds(ts.tv_sec) + std::chrono::nanoseconds(ts.tv_nsec)));
+    }
+#endif
+    default:
+        return log_clock::now();
+    }
+}
 
-#if defined __linux__ && defined SPDLOG_CLOCK_COARSE
-    timespec ts;
-    ::clock_gettime(CLOCK_REALTIME_COARSE, &ts);
-    return std::chrono::time_point<log_clock, typename log_clock::duration>(
-        std::chrono::duration_cast<typename log_clock::duration>(std::chrono::seconds(ts.tv_sec) + std::chrono::nanoseconds(ts.tv_nsec)));
+SPDLOG_INLINE void set_clock_source(clock_source source) SPDLOG_NOEXCEPT
+{
+    if (source == clock_source::tsc)
+    {
+        // calibrate before the first message
+        (void)tsc_clock::instance();
+    }
+    clock_source_state().store(static_cast<int>(source), std::memory_order_relaxed);
+}
 
-#else
-    return log_clock::now();
-#endif
+SPDLOG_INLINE clock_source get_clock_source() SPDLOG_NOEXCEPT
+{
+    return static_cast<clock_source>(clock_source_state().load(std::memory_order_relaxed));
 }
 SPDLOG_INLINE std::tm localtime(const std::time_t &time_tt) SPDLOG_NOEXCEPT
 {
@@ -253,6 +292,47 @@ SPDLOG_INLINE size_t filesize(FILE *f)
     return 0; // will not be reached.
 }
 
+SPDLOG_INLINE bool write_durable(FILE *f, const char *data, size_t size) SPDLOG_NOEXCEPT
+{
+#if defined(CEP_SPDLOG_MODIFIED)
+    return std::fwrite(data, 1, size, f) == size && std::fflush(f) == 0;
+#elif defined(_WIN32)
+    if (std::fwrite(data, 1, size, f) != size || std::fflush(f) != 0)
+    {
+        return false;
+    }
+    return ::FlushFileBuffers(reinterpret_cast<HANDLE>(_get_osfhandle(::_fileno(f)))) != 0;
+#else
+#if defined(__OpenBSD__)
+    int fd = fileno(f);
+#else
+    int fd = ::fileno(f);
+#endif
+    while (size > 0)
+    {
+        auto written = ::write(fd, data, size);
+        if (written < 0)
+        {
+            if (errno == EINTR)
+            {
+                continue;
+            }
+            return false;
+        }
+        data += written;
+        size -= static_cast<size_t>(written);
+    }
+#if defined(__APPLE__)
+    // fsync() doesn't flush the drive cache under macOS
+    return ::fcntl(fd, F_FULLFSYNC) == 0 || ::fsync(fd) == 0;
+#elif defined(__linux__)
+    return ::fdatasync(fd) == 0;
+#else
+    return ::fsync(fd) == 0;
+#endif
+#endif
+}
+
 // Return utc offset in minutes or throw spdlog_ex on failure
 SPDLOG_INLINE int utc_minutes_offset(const std::tm &tm)
 {
@@ -362,6 +442,41 @@ SPDLOG_INLINE size_t thread_id() SPDLOG_NOEXCEPT
 #endif
 }
 
+#if !defined(SPDLOG_NO_TLS)
+struct thread_name_storage
+{
+    char name[max_thread_name_len];
+    size_t len;
+};
+
+SPDLOG_INLINE thread_name_storage &thread_name_tls_() SPDLOG_NOEXCEPT
+{
+    static thread_local thread_name_storage storage{{}, 0};
+    return storage;
+}
+#endif
+
+SPDLOG_INLINE void set_thread_name(string_view_t name) SPDLOG_NOEXCEPT
+{
+#if defined(SPDLOG_NO_TLS)
+    (void)name;
+#else
+    auto &storage = thread_name_tls_();
+    storage.len = (std::min)(name.size(), max_thread_name_len);
+    std::memcpy(storage.name, name.data(), storage.len);
+#endif
+}
+
+SPDLOG_INLINE string_view_t thread_name() SPDLOG_NOEXCEPT
+{
+#if defined(SPDLOG_NO_TLS)
+    return string_view_t{};
+#else
+    const auto &storage = thread_name_tls_();
+    return string_view_t{storage.name, storage.len};
+#endif
+}
+
 // This is avoid msvc issue in sleep_for that happens if the clock changes.
 // See https://github.com/gabime/spdlog/issues/609
 SPDLOG_INLINE void sleep_for_millis(int milliseconds) SPDLOG_NOEXCEPT
@@ -381,6 +496,18 @@ SPDLOG_INLINE void sleep_for_millis(int milliseconds) SPDLOG_NOEXCEPT
 #endif
 }
 
+SPDLOG_INLINE void set_thread_low_priority() SPDLOG_NOEXCEPT
+{
+#ifdef CEP_SPDLOG_MODIFIED
+    return;
+#elif defined(_WIN32)
+    (void)::SetThreadPriority(::GetCurrentThread(), THREAD_PRIORITY_LOWEST);
+#elif defined(__linux__)
+    // under linux the nice value is per thread
+    (void)::setpriority(PRIO_PROCESS, static_cast<id_t>(::syscall(SYS_gettid)), 10);
+#endif
+}
+
 // wchar support for windows file names (SPDLOG_WCHAR_FILENAMES must be defined)
 #if defined(_WIN32) && defined(SPDLOG_WCHAR_FILENAMES)
 SPDLOG_INLINE std::string filename_to_str(const filename_t &filename)
@@ -400,9 +527,23 @@ SPDLOG_INLINE int pid() SPDLOG_NOEXCEPT
 {
 
 #ifdef _WIN32
-    return static_cast<int>(::GetCurrentProcessId());
-#else
+    static const int cached_pid = static_cast<int>(::GetCurrentProcessId());
+    return cached_pid;
+#elif defined(CEP_SPDLOG_MODIFIED)
     return static_cast<int>(::getpid());
+#else
+    // the cached pid is reset in the child process after fork()
+    static std::atomic<int> cached_pid{0};
+    static const int atfork_registered = ::pthread_atfork(nullptr, nullptr, [] { cached_pid.store(0, std::memory_order_relaxed); });
+    (void)atfork_registered;
+
+    auto pid = cached_pid.load(std::memory_order_relaxed);
+    if (pid == 0)
+    {
+        pid = static_cast<int>(::getpid());
+        cached_pid.store(pid, std::memory_order_relaxed);
+    }
+    return pid;
 #endif
 }
 
@@ -12,6 +12,11 @@ namespace os {
 
 SPDLOG_API spdlog::log_clock::time_point now() SPDLOG_NOEXCEPT;
 
+// select the clock used by now()
+SPDLOG_API void set_clock_source(clock_source source) SPDLOG_NOEXCEPT;
+
+SPDLOG_API clock_source get_clock_source() SPDLOG_NOEXCEPT;
+
 SPDLOG_API std::tm localtime(const std::time_t &time_tt) SPDLOG_NOEXCEPT;
 
 SPDLOG_API std::tm localtime() SPDLOG_NOEXCEPT;
@@ -56,6 +61,10 @@ SPDLOG_API bool path_exists(const filename_t &filename) SPDLOG_NOEXCEPT;
 // Return file size according to open FILE* object
 SPDLOG_API size_t filesize(FILE *f);
 
+// Write the data to the file, bypassing its stdio buffer (which must be empty), and wait until it is on disk
+// (fdatasync, or the closest equivalent). Return false on failure (errno is set).
+SPDLOG_API bool write_durable(FILE *f, const char *data, size_t size) SPDLOG_NOEXCEPT;
+
 // Return utc offset in minutes or throw spdlog_ex on failure
 SPDLOG_API int utc_minutes_offset(const std::tm &tm = details::os::localtime());
 
@@ -67,12 +76,26 @@ SPDLOG_API size_t _thread_id() SPDLOG_NOEXCEPT;
 // Return current thread id as size_t (from thread local storage)
 SPDLOG_API size_t thread_id() SPDLOG_NOEXCEPT;
 
+// max length of thread names (longer names are truncated)
+SPDLOG_CONSTEXPR static const size_t max_thread_name_len = 15;
+
+// Set the name of the current thread, as shown by the %N pattern flag (stored in thread local storage).
+// No-op if SPDLOG_NO_TLS is defined.
+SPDLOG_API void set_thread_name(string_view_t name) SPDLOG_NOEXCEPT;
+
+// Return the name of the current thread set by set_thread_name() or empty string (from thread local storage).
+SPDLOG_API string_view_t thread_name() SPDLOG_NOEXCEPT;
+
 // This is avoid msvc issue in sleep_for that happens if the clock changes.
 // See https://github.com/gabime/spdlog/issues/609
 SPDLOG_API void sleep_for_millis(int milliseconds) SPDLOG_NOEXCEPT;
 
+// Lower the scheduling priority of the calling thread (best effort, no-op if not supported).
+SPDLOG_API void set_thread_low_priority() SPDLOG_NOEXCEPT;
+
 SPDLOG_API std::string filename_to_str(const filename_t &filename);
 
+// Return the process id (cached, and refreshed after fork())
 SPDLOG_API int pid() SPDLOG_NOEXCEPT;
 
 // Determine if the terminal supports colors
@@ -10,9 +10,9 @@
 namespace spdlog {
 namespace details {
 
-SPDLOG_INLINE periodic_worker::periodic_worker(const std::function<void()> &callback_fun, std::chrono::seconds interval)
+SPDLOG_INLINE periodic_worker::periodic_worker(const std::function<void()> &callback_fun, std::chrono::milliseconds interval)
 {
-    active_ = (interval > std::chrono::seconds::zero());
+    active_ = (interval > std::chrono::milliseconds::zero());
     if (!active_)
     {
         return;
@@ -0,0 +1,194 @@
+// Copyright(c) 2015-present, Gabi Melman & spdlog contributors.
+// Distributed under the MIT License (http://opensource.org/licenses/MIT)
+
+#pragma once
+
+#ifndef SPDLOG_HEADER_ONLY
+#include <spdlog/details/profiler.h>
+#endif
+
+#include <spdlog/fmt/fmt.h>
+
+namespace spdlog {
+namespace details {
+namespace profiling {
+
+SPDLOG_INLINE const char *stage_name(stage s)
+{
+    static const char *names[n_stages] = {"format", "enqueue", "queue_wait", "pattern_format", "sink_write"};
+    return s >= 0 && s < n_stages ? names[s] : "unknown";
+}
+
+// index of the most significant bit set (value > 0)
+static inline size_t msb64(uint64_t value)
+{
+#if defined(__GNUC__)
+    return static_cast<size_t>(63 - __builtin_clzll(value));
+#else
+    size_t msb = 0;
+    while (value >>= 1)
+    {
+        ++msb;
+    }
+    return msb;
+#endif
+}
+
+SPDLOG_INLINE histogram::histogram()
+{
+    reset();
+}
+
+SPDLOG_INLINE size_t histogram::bucket_index(uint64_t value)
+{
+    if (value < 4)
+    {
+        return static_cast<size_t>(value);
+    }
+    auto msb = msb64(value);
+    return (msb - 1) * 4 + static_cast<size_t>((value >> (msb - 2)) & 3);
+}
+
+SPDLOG_INLINE uint64_t histogram::bucket_lower_bound(size_t index)
+{
+    if (index < 4)
+    {
+        return index;
+    }
+    auto msb = index / 4 + 1;
+    return static_cast<uint64_t>(4 + index % 4) << (msb - 2);
+}
+
+SPDLOG_INLINE void histogram::record(uint64_t value)
+{
+    buckets_[bucket_index(value)].fetch_add(1, std::memory_order_relaxed);
+    count_.fetch_add(1, std::memory_order_relaxed);
+    sum_.fetch_add(value, std::memory_order_relaxed);
+    auto max = max_.load(std::memory_order_relaxed);
+    while (value > max && !max_.compare_exchange_weak(max, value, std::memory_order_relaxed)) {}
+}
+
+SPDLOG_INLINE void histogram::reset()
+{
+    for (auto &bucket : buckets_)
+    {
+        bucket.store(0, std::memory_order_relaxed);
+    }
+    count_.store(0, std::memory_order_relaxed);
+    sum_.store(0, std::memory_order_relaxed);
+    max_.store(0, std::memory_order_relaxed);
+}
+
+SPDLOG_INLINE uint64_t histogram::count() const
+{
+    return count_.load(std::memory_order_relaxed);
+}
+
+SPDLOG_INLINE uint64_t histogram::sum() const
+{
+    return sum_.load(std::memory_order_relaxed);
+}
+
+SPDLOG_INLINE uint64_t histogram::max() const
+{
+    return max_.load(std::memory_order_relaxed);
+}
+
+SPDLOG_INLINE uint64_t histogram::percentile(double p) const
+{
+    // the buckets may be updated concurrently: use their own total
+    uint64_t total = 0;
+    for (auto &bucket : buckets_)
+    {
+        total += bucket.load(std::memory_order_relaxed);
+    }
+    if (total == 0)
+    {
+        return 0;
+    }
+
+    auto rank = static_cast<uint64_t>(p * static_cast<double>(total));
+    rank = rank < 1 ? 1 : (rank > total ? total : rank);
+    uint64_t seen = 0;
+    for (size_t i = 0; i < n_buckets; ++i)
+    {
+        seen += buckets_[i].load(std::memory_order_relaxed);
+        if (seen >= rank)
+        {
+            auto width = i < 4 ? uint64_t(1) : uint64_t(1) << (i / 4 - 1);
+            auto mid = bucket_lower_bound(i) + width / 2;
+            auto max_value = max();
+            return mid < max_value || max_value == 0 ? mid : max_value;
+        }
+    }
+    return max();
+}
+
+SPDLOG_INLINE void stage_profile::reset()
+{
+    for (auto &h : stages_)
+    {
+        h.reset();
+    }
+}
+
+SPDLOG_INLINE void stage_profile::dump(string_view_t owner, memory_buf_t &dest) const
+{
+    for (int i = 0; i < n_stages; ++i)
+    {
+        const auto &h = stages_[i];
+        auto count = h.count();
+        if (count == 0)
+        {
+            continue;
+        }
+        fmt::format_to(dest, "{} {} count={} mean={} p50={} p99={} p99.9={} max={}\n", owner, stage_name(static_cast<stage>(i)), count,
+            h.sum() / count, h.percentile(0.5), h.percentile(0.99), h.percentile(0.999), h.max());
+    }
+}
+
+SPDLOG_INLINE stage_profile &unattributed_profile()
+{
+    static stage_profile profile;
+    return profile;
+}
+
+#ifdef SPDLOG_NO_TLS
+SPDLOG_INLINE stage_profile &sink_profile()
+{
+    return unattributed_profile();
+}
+
+SPDLOG_INLINE sink_scope::sink_scope(stage_profile &)
+    : prev_(nullptr)
+{}
+
+SPDLOG_INLINE sink_scope::~sink_scope() = default;
+#else
+SPDLOG_INLINE stage_profile *&current_sink_profile()
+{
+    static thread_local stage_profile *current = nullptr;
+    return current;
+}
+
+SPDLOG_INLINE stage_profile &sink_profile()
+{
+    auto *current = current_sink_profile();
+    return current != nullptr ? *current : unattributed_profile();
+}
+
+SPDLOG_INLINE sink_scope::sink_scope(stage_profile &profile)
+    : prev_(current_sink_profile())
+{
+    current_sink_profile() = &profile;
+}
+
+SPDLOG_INLINE sink_scope::~sink_scope()
+{
+    current_sink_profile() = prev_;
+}
+#endif
+
+} // namespace profiling
+} // namespace details
+} // namespace spdlog
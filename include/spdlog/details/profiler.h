@@ -0,0 +1,174 @@
+// Copyright(c) 2015-present, Gabi Melman & spdlog contributors.
+// Distributed under the MIT License (http://opensource.org/licenses/MIT)
+
+#pragma once
+
+// Self profiling of the logging pipeline (enabled by SPDLOG_ENABLE_PROFILING, see tweakme.h).
+//
+// Each stage of the pipeline is timed in cpu cycles (rdtsc/cntvct, or steady_clock nanoseconds
+// on other platforms) and recorded in a histogram:
+//  - format:         fmt::format_to() of the payload in logger::log_()      (per logger)
+//  - enqueue:        thread_pool::post_async_msg_()                          (per logger)
+//  - queue_wait:     time spent by the message in the async queue            (per logger)
+//  - pattern_format: pattern_formatter::format()                             (per sink)
+//  - sink_write:     file_helper::write()                                    (per sink)
+//
+// The sink stages are attributed to the sink whose log() is running on the current thread
+// (see sink_scope), or to unattributed_profile() when called outside of base_sink::log().
+// When the flag is off SPDLOG_PROFILE_STAGE expands to nothing and no member is added.
+
+#include <spdlog/common.h>
+#include <spdlog/details/tsc_clock.h>
+
+#include <atomic>
+#include <cstdint>
+
+namespace spdlog {
+namespace details {
+namespace profiling {
+
+enum stage : int
+{
+    format = 0,
+    enqueue,
+    queue_wait,
+    pattern_format,
+    sink_write,
+    n_stages
+};
+
+SPDLOG_API const char *stage_name(stage s);
+
+// current value of the cycle counter
+inline uint64_t cycles()
+{
+    return tsc_clock::ticks();
+}
+
+// Log-linear histogram of cycle counts: 4 sub-buckets per power of 2 (at most 25% error).
+// Recording is wait free (relaxed atomics), and can be read while being updated.
+class SPDLOG_API histogram
+{
+public:
+    static const size_t n_buckets = 252;
+
+    histogram();
+
+    void record(uint64_t value);
+    void reset();
+
+    uint64_t count() const;
+    uint64_t sum() const;
+    uint64_t max() const;
+
+    // approximate value (bucket midpoint, at most max()) below which the given fraction (0-1) of the values are
+    uint64_t percentile(double p) const;
+
+    static size_t bucket_index(uint64_t value);
+    static uint64_t bucket_lower_bound(size_t index);
+
+private:
+    std::atomic<uint64_t> buckets_[n_buckets];
+    std::atomic<uint64_t> count_;
+    std::atomic<uint64_t> sum_;
+    std::atomic<uint64_t> max_;
+};
+
+// the histograms of all the stages, owned by a logger or a sink.
+// copies start empty.
+class SPDLOG_API stage_profile
+{
+public:
+    stage_profile() = default;
+    stage_profile(const stage_profile &) {}
+    stage_profile &operator=(const stage_profile &)
+    {
+        return *this;
+    }
+
+    void record(stage s, uint64_t cycles)
+    {
+        stages_[s].record(cycles);
+    }
+
+    const histogram &get(stage s) const
+    {
+        return stages_[s];
+    }
+
+    void reset();
+
+    // append a line for each non empty stage:
+    // "<owner> <stage> count=.. mean=.. p50=.. p99=.. p99.9=.. max=.."
+    void dump(string_view_t owner, memory_buf_t &dest) const;
+
+private:
+    histogram stages_[n_stages];
+};
+
+// profile of the sink stages that run outside of a sink
+SPDLOG_API stage_profile &unattributed_profile();
+
+// profile of the sink being run by the current thread (unattributed_profile() if none).
+SPDLOG_API stage_profile &sink_profile();
+
+// make the given profile the current sink profile for the lifetime of this object.
+class SPDLOG_API sink_scope
+{
+public:
+    explicit sink_scope(stage_profile &profile);
+    ~sink_scope();
+
+    sink_scope(const sink_scope &) = delete;
+    sink_scope &operator=(const sink_scope &) = delete;
+
+private:
+    stage_profile *prev_;
+};
+
+// record the cycles elapsed between its construction and destruction (nothing if profile is null).
+class scoped_timer
+{
+public:
+    scoped_timer(stage_profile *profile, stage s)
+        : profile_(profile)
+        , stage_(s)
+        , start_(cycles())
+    {}
+
+    ~scoped_timer()
+    {
+        if (profile_ != nullptr)
+        {
+            profile_->record(stage_, cycles() - start_);
+        }
+    }
+
+    scoped_timer(const scoped_timer &) = delete;
+    scoped_timer &operator=(const scoped_timer &) = delete;
+
+private:
+    stage_profile *profile_;
+    stage stage_;
+    uint64_t start_;
+};
+
+} // namespace profiling
+} // namespace details
+} // namespace spdlog
+
+#ifdef SPDLOG_ENABLE_PROFILING
+#define SPDLOG_PROFILE_CONCAT_(a, b) a##b
+#define SPDLOG_PROFILE_CONCAT(a, b) SPDLOG_PROFILE_CONCAT_(a, b)
+#define SPDLOG_PROFILE_STAGE(profile, stage)                                                                                               \
+    spdlog::details::profiling::scoped_timer SPDLOG_PROFILE_CONCAT(spdlog_profile_timer_, __LINE__)(profile, stage)
+#define SPDLOG_PROFILE_SINK_SCOPE(profile)                                                                                                 \
+    spdlog::details::profiling::sink_scope SPDLOG_PROFILE_CONCAT(spdlog_profile_scope_, __LINE__)(profile)
+#else
+#define SPDLOG_PROFILE_STAGE(profile, stage) (void)0
+#define SPDLOG_PROFILE_SINK_SCOPE(profile) (void)0
+#endif
+
+#ifdef SPDLOG_HEADER_ONLY
+#include "profiler-inl.h"
+#endif
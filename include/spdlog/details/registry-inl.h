@@ -10,6 +10,8 @@
 #include <spdlog/common.h>
 #include <spdlog/logger.h>
 #include <spdlog/pattern_formatter.h>
+#include <spdlog/details/os.h>
+#include <spdlog/details/tsc_clock.h>
 
 #ifndef SPDLOG_DISABLE_DEFAULT_LOGGER
 // support for the default stdout color logger
@@ -20,6 +22,7 @@
 #endif
 #endif // SPDLOG_DISABLE_DEFAULT_LOGGER
 
+#include <algorithm>
 #include <chrono>
 #include <functional>
 #include <memory>
@@ -29,9 +32,26 @@
 namespace spdlog {
 namespace details {
 
+// FNV-1a hash of the logger name
+static SPDLOG_INLINE size_t name_hash_(string_view_t name)
+{
+    uint64_t hash = 14695981039346656037ULL;
+    for (auto c : name)
+    {
+        hash ^= static_cast<unsigned char>(c);
+        hash *= 1099511628211ULL;
+    }
+    return static_cast<size_t>(hash);
+}
+
 SPDLOG_INLINE registry::registry()
     : formatter_(new pattern_formatter())
 {
+    for (auto &stripe : readers_)
+    {
+        stripe.counts[0] = 0;
+        stripe.counts[1] = 0;
+    }
 
 #ifndef SPDLOG_DISABLE_DEFAULT_LOGGER
     // create default logger (ansicolor_stdout_sink_mt or wincolor_stdout_sink_mt in windows).
@@ -46,9 +66,13 @@ SPDLOG_INLINE registry::registry()
     loggers_[default_logger_name] = default_logger_;
 
 #endif // SPDLOG_DISABLE_DEFAULT_LOGGER
+    publish_snapshot_();
 }
 
-SPDLOG_INLINE registry::~registry() = default;
+SPDLOG_INLINE registry::~registry()
+{
+    delete snapshot_.load();
+}
 
 SPDLOG_INLINE void registry::register_logger(std::shared_ptr<logger> new_logger)
 {
@@ -94,27 +118,36 @@ SPDLOG_INLINE void registry::initialize_logger(std::shared_ptr<logger> new_logge
 
 SPDLOG_INLINE std::shared_ptr<logger> registry::get(const std::string &logger_name)
 {
-#ifdef CEP_SPDLOG_MODIFIED
-#ifdef CEP_SPDLOG_USE_MUTEX
-    cep::Lock_Guard lock{logger_map_mutex_};
-#endif
-#else
-    std::lock_guard<std::mutex> lock(logger_map_mutex_);
-#endif
-    auto found = loggers_.find(logger_name);
-    return found == loggers_.end() ? nullptr : found->second;
+    auto hash = name_hash_(logger_name);
+    std::shared_ptr<logger> result;
+
+    auto index = read_lock_();
+    const auto &entries = snapshot_.load()->entries;
+    auto it = std::lower_bound(
+        entries.begin(), entries.end(), hash, [](const snapshot_entry &entry, size_t h) { return entry.hash < h; });
+    for (; it != entries.end() && it->hash == hash; ++it)
+    {
+        if (it->name == logger_name)
+        {
+            result = it->logger_ptr;
+            break;
+        }
+    }
+    read_unlock_(index);
+    return result;
 }
 
 SPDLOG_INLINE std::shared_ptr<logger> registry::default_logger()
 {
-#ifdef CEP_SPDLOG_MODIFIED
-#ifdef CEP_SPDLOG_USE_MUTEX
-    cep::Lock_Guard lock{logger_map_mutex_};
-#endif
-#else
-    std::lock_guard<std::mutex> lock(logger_map_mutex_);
-#endif
-    return default_logger_;
+    auto index = read_lock_();
+    auto result = snapshot_.load()->default_logger;
+    read_unlock_(index);
+    return result;
+}
+
+SPDLOG_INLINE uint64_t registry::generation() const
+{
+    return generation_.load(std::memory_order_acquire);
 }
 
 // Return raw ptr to the default logger.
@@ -147,6 +180,7 @@ SPDLOG_INLINE void registry::set_default_logger(std::shared_ptr<logger> new_defa
         loggers_[new_default_logger->name()] = new_default_logger;
     }
     default_logger_ = std::move(new_default_logger);
+    publish_snapshot_();
 }
 
 SPDLOG_INLINE void registry::set_tp(std::shared_ptr<thread_pool> tp)
@@ -156,7 +190,7 @@ SPDLOG_INLINE void registry::set_tp(std::shared_ptr<thread_pool> tp)
     cep::Lock_Guard lock{tp_mutex_};
 #endif
 #else
-    std::lock_guard<std::mutex> lock(tp_mutex_);
+    std::lock_guard<std::recursive_mutex> lock(tp_mutex_);
 #endif
     tp_ = std::move(tp);
 }
@@ -260,12 +294,102 @@ SPDLOG_INLINE void registry::flush_every(std::chrono::seconds interval)
 #else
     std::lock_guard<std::mutex> lock(flusher_mutex_);
 #endif
-    auto clbk = [this]() { this->flush_all(); };
 #ifdef CEP_SPDLOG_MODIFIED
     UNUSED(interval);
-    clbk();
+    flush_all();
+#else
+    // all the loggers, dirty or not
+    schedule_flush_(
+        nullptr,
+        [this]() {
+            this->flush_all();
+            return true;
+        },
+        interval);
+#endif
+}
+
+SPDLOG_INLINE void registry::flush_every(std::shared_ptr<logger> logger, std::chrono::milliseconds interval)
+{
+#ifdef CEP_SPDLOG_MODIFIED
+#ifdef CEP_SPDLOG_USE_MUTEX
+    cep::Lock_Guard lock{flusher_mutex_};
+#endif
+    // no background thread: flush once
+    UNUSED(interval);
+    logger->flush_dirty();
+#else
+    std::lock_guard<std::mutex> lock(flusher_mutex_);
+    std::weak_ptr<spdlog::logger> weak_logger = logger;
+    schedule_flush_(
+        logger.get(),
+        [weak_logger]() {
+            auto logger_ptr = weak_logger.lock();
+            if (!logger_ptr)
+            {
+                return false; // the logger is gone
+            }
+            logger_ptr->flush_dirty();
+            return true;
+        },
+        interval);
+#endif
+}
+
+SPDLOG_INLINE void registry::flush_every(sink_ptr sink, std::chrono::milliseconds interval, std::function<void(const sink_ptr &)> flush_fn)
+{
+#ifdef CEP_SPDLOG_MODIFIED
+#ifdef CEP_SPDLOG_USE_MUTEX
+    cep::Lock_Guard lock{flusher_mutex_};
+#endif
+    UNUSED(interval);
+    if (sink->dirty())
+    {
+        flush_fn ? flush_fn(sink) : sink->flush_tracked();
+    }
 #else
-    periodic_flusher_ = details::make_unique<periodic_worker>(clbk, interval);
+    std::lock_guard<std::mutex> lock(flusher_mutex_);
+    std::weak_ptr<sinks::sink> weak_sink = sink;
+    schedule_flush_(
+        sink.get(),
+        [weak_sink, flush_fn]() {
+            auto sink_ptr = weak_sink.lock();
+            if (!sink_ptr)
+            {
+                return false; // the sink is gone
+            }
+            if (sink_ptr->dirty())
+            {
+                flush_fn ? flush_fn(sink_ptr) : sink_ptr->flush_tracked();
+            }
+            return true;
+        },
+        interval);
+#endif
+}
+
+SPDLOG_INLINE void registry::set_clock_source(clock_source source, std::chrono::seconds resync_interval)
+{
+#ifdef CEP_SPDLOG_MODIFIED
+#ifdef CEP_SPDLOG_USE_MUTEX
+    cep::Lock_Guard lock{flusher_mutex_};
+#endif
+#else
+    std::lock_guard<std::mutex> lock(flusher_mutex_);
+#endif
+    os::set_clock_source(source);
+#ifdef CEP_SPDLOG_MODIFIED
+    // no background thread: the clock is calibrated once
+    UNUSED(resync_interval);
+#else
+    if (source == clock_source::tsc)
+    {
+        clock_syncer_ = details::make_unique<periodic_worker>([] { tsc_clock::instance().resync(); }, resync_interval);
+    }
+    else
+    {
+        clock_syncer_.reset();
+    }
 #endif
 }
 
@@ -329,6 +453,7 @@ SPDLOG_INLINE void registry::drop(const std::string &logger_name)
     {
         default_logger_.reset();
     }
+    publish_snapshot_();
 }
 
 SPDLOG_INLINE void registry::drop_all()
@@ -342,6 +467,7 @@ SPDLOG_INLINE void registry::drop_all()
 #endif
     loggers_.clear();
     default_logger_.reset();
+    publish_snapshot_();
 }
 
 // clean all resources and threads started by the registry
@@ -356,7 +482,9 @@ SPDLOG_INLINE void registry::shutdown()
         std::lock_guard<std::mutex> lock(flusher_mutex_);
 #endif
 #ifndef CEP_SPDLOG_MODIFIED
-        periodic_flusher_.reset();
+        flush_scheduler_.reset();
+        flush_tasks_.clear();
+        clock_syncer_.reset();
 #endif
     }
 
@@ -368,7 +496,7 @@ SPDLOG_INLINE void registry::shutdown()
         cep::Lock_Guard lock{tp_mutex_};
 #endif
 #else
-        std::lock_guard<std::mutex> lock(tp_mutex_);
+        std::lock_guard<std::recursive_mutex> lock(tp_mutex_);
 #endif
         tp_.reset();
     }
@@ -417,6 +545,27 @@ SPDLOG_INLINE void registry::update_levels(cfg::log_levels levels)
     }
 }
 
+#ifndef CEP_SPDLOG_MODIFIED
+SPDLOG_INLINE void registry::schedule_flush_(const void *target, flush_scheduler::task_t task, std::chrono::milliseconds interval)
+{
+    auto it = flush_tasks_.find(target);
+    if (it != flush_tasks_.end())
+    {
+        flush_scheduler_->remove(it->second);
+        flush_tasks_.erase(it);
+    }
+    if (interval <= std::chrono::milliseconds::zero())
+    {
+        return;
+    }
+    if (!flush_scheduler_)
+    {
+        flush_scheduler_ = details::make_unique<flush_scheduler>();
+    }
+    flush_tasks_[target] = flush_scheduler_->add(std::move(task), interval);
+}
+#endif
+
 SPDLOG_INLINE registry &registry::instance()
 {
     static registry s_instance;
@@ -436,6 +585,75 @@ SPDLOG_INLINE void registry::register_logger_(std::shared_ptr<logger> new_logger
     auto logger_name = new_logger->name();
     throw_if_exists_(logger_name);
     loggers_[logger_name] = std::move(new_logger);
+    publish_snapshot_();
+}
+
+SPDLOG_INLINE void registry::publish_snapshot_()
+{
+    auto *new_snapshot = new snapshot();
+    new_snapshot->entries.reserve(loggers_.size());
+    for (auto &l : loggers_)
+    {
+        new_snapshot->entries.push_back(snapshot_entry{name_hash_(l.first), l.first, l.second});
+    }
+    std::sort(new_snapshot->entries.begin(), new_snapshot->entries.end(),
+        [](const snapshot_entry &a, const snapshot_entry &b) { return a.hash < b.hash; });
+    new_snapshot->default_logger = default_logger_;
+
+    auto *old_snapshot = snapshot_.exchange(new_snapshot);
+    generation_.fetch_add(1, std::memory_order_release);
+    if (old_snapshot == nullptr)
+    {
+        return;
+    }
+
+    // Grace period: wait until the readers that might still use the old snapshot are done.
+    // Flip the epoch and wait for the readers of the previous epoch to leave, twice, since a reader
+    // might have read the epoch just before the first flip and incremented its counter only after it.
+    // Yield for a while, then sleep: a reader that was preempted inside its lookup needs the cpu to leave.
+    for (int i = 0; i < 2; i++)
+    {
+        auto index = readers_epoch_.fetch_add(1) & 1;
+        for (int attempt = 0;; attempt++)
+        {
+            size_t readers = 0;
+            for (auto &stripe : readers_)
+            {
+                readers += stripe.counts[index].load();
+            }
+            if (readers == 0)
+            {
+                break;
+            }
+            details::os::sleep_for_millis(attempt < 16 ? 0 : 1);
+        }
+    }
+    delete old_snapshot;
+}
+
+SPDLOG_INLINE size_t registry::read_lock_() const
+{
+    auto stripe = reader_stripe_();
+    auto index = readers_epoch_.load() & 1;
+    readers_[stripe].counts[index].fetch_add(1);
+    return stripe * 2 + index;
+}
+
+SPDLOG_INLINE void registry::read_unlock_(size_t token) const
+{
+    readers_[token / 2].counts[token % 2].fetch_sub(1, std::memory_order_release);
+}
+
+SPDLOG_INLINE size_t registry::reader_stripe_()
+{
+#if defined(SPDLOG_NO_TLS)
+    return details::os::thread_id() % reader_stripes;
+#else
+    // threads take the stripes in turn
+    static std::atomic<size_t> next_stripe{0};
+    static thread_local const size_t stripe = next_stripe.fetch_add(1, std::memory_order_relaxed) % reader_stripes;
+    return stripe;
+#endif
 }
 
 } // namespace details
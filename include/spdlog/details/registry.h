@@ -7,16 +7,28 @@
 // An attempt to create a logger with an already existing name will result with spdlog_ex exception.
 // If user requests a non existing logger, nullptr will be returned
 // This class is thread safe
+//
+// Lookups (get() and default_logger()) don't lock and don't allocate: they read an immutable
+// snapshot of the loggers, which is replaced (under the mutex) each time a logger is registered or dropped.
+// A replaced snapshot is deleted once no reader can be using it anymore (after a grace period).
 
 #include <spdlog/common.h>
 #include <spdlog/cfg/log_levels.h>
 
+#include <atomic>
 #include <chrono>
+#include <cstdint>
 #include <functional>
 #include <memory>
 #include <string>
 #include <unordered_map>
 #include <mutex>
+#include <vector>
+
+#ifndef CEP_SPDLOG_MODIFIED
+#include <spdlog/details/flush_scheduler.h>
+#include <spdlog/details/periodic_worker.h>
+#endif
 
 namespace spdlog {
 class logger;
@@ -35,6 +47,10 @@ public:
     std::shared_ptr<logger> get(const std::string &logger_name);
     std::shared_ptr<logger> default_logger();
 
+    // Incremented each time a logger is registered, dropped or replaced.
+    // Can be used to cache the result of get() (see spdlog::logger_handle).
+    uint64_t generation() const;
+
     // Return raw ptr to the default logger.
     // To be used directly by the spdlog default api (e.g. spdlog::info)
     // This make the default API faster, but cannot be used concurrently with set_default_logger().
@@ -62,6 +78,17 @@ public:
 
     void flush_every(std::chrono::seconds interval);
 
+    // flush the dirty sinks of the logger every interval. a zero interval stops it.
+    void flush_every(std::shared_ptr<logger> logger, std::chrono::milliseconds interval);
+
+    // flush the sink every interval if it is dirty, with flush_fn(sink) if given (e.g. to post the flush to a thread pool),
+    // with sink->flush_tracked() otherwise. a zero interval stops it.
+    void flush_every(sink_ptr sink, std::chrono::milliseconds interval, std::function<void(const sink_ptr &)> flush_fn);
+
+    // select the clock of the messages timestamps.
+    // for clock_source::tsc, resync the clock every resync_interval in a background thread.
+    void set_clock_source(clock_source source, std::chrono::seconds resync_interval);
+
     void set_error_handler(void (*handler)(const std::string &msg));
 
     void apply_all(const std::function<void(const std::shared_ptr<logger>)> &fun);
@@ -80,7 +107,6 @@ public:
     cep::Mutex &tp_mutex();
 #endif
 #else
-    std::lock_guard<std::mutex> lock{mutex_};
     std::recursive_mutex &tp_mutex();
 #endif
 
@@ -91,11 +117,41 @@ public:
     static registry &instance();
 
 private:
+    struct snapshot_entry
+    {
+        size_t hash;
+        std::string name;
+        std::shared_ptr<logger> logger_ptr;
+    };
+
+    // immutable copy of the loggers map, sorted by hash.
+    struct snapshot
+    {
+        std::vector<snapshot_entry> entries;
+        std::shared_ptr<logger> default_logger;
+    };
+
     registry();
     ~registry();
 
     void throw_if_exists_(const std::string &logger_name);
     void register_logger_(std::shared_ptr<logger> new_logger);
+
+    // replace the snapshot after a change in the loggers map (must be called with logger_map_mutex_ held).
+    void publish_snapshot_();
+
+    // read side of the snapshot: read_lock_() returns the token to pass to read_unlock_().
+    size_t read_lock_() const;
+    void read_unlock_(size_t token) const;
+
+    // reader counters stripe of the calling thread
+    static size_t reader_stripe_();
+
+#ifndef CEP_SPDLOG_MODIFIED
+    // (re)schedule the flushes of target (nullptr for flush_every(interval)), or stop them if the interval is zero.
+    // must be called with flusher_mutex_ held.
+    void schedule_flush_(const void *target, flush_scheduler::task_t task, std::chrono::milliseconds interval);
+#endif
 #ifdef CEP_SPDLOG_MODIFIED
 #ifdef CEP_SPDLOG_USE_MUTEX
     cep::Mutex logger_map_mutex_;
@@ -108,13 +164,26 @@ private:
 #endif
 
     std::unordered_map<std::string, std::shared_ptr<logger>> loggers_;
+    std::atomic<const snapshot *> snapshot_{nullptr};
+    std::atomic<uint64_t> generation_{0};
+    // readers of the two epochs, striped by thread and padded to a cache line each,
+    // so concurrent lookups from different threads don't contend on the same counter.
+    struct alignas(64) reader_stripe
+    {
+        std::atomic<size_t> counts[2];
+    };
+    static constexpr size_t reader_stripes = 16;
+    mutable reader_stripe readers_[reader_stripes];
+    std::atomic<size_t> readers_epoch_{0};
     cfg::log_levels levels_;
     std::unique_ptr<formatter> formatter_;
     level::level_enum flush_level_ = level::off;
     void (*err_handler_)(const std::string &msg);
     std::shared_ptr<thread_pool> tp_;
 #ifndef CEP_SPDLOG_MODIFIED
-    std::unique_ptr<periodic_worker> periodic_flusher_;
+    std::unique_ptr<flush_scheduler> flush_scheduler_;
+    std::unordered_map<const void *, uint64_t> flush_tasks_; // scheduled task of each target
+    std::unique_ptr<periodic_worker> clock_syncer_;
 #endif
     std::shared_ptr<logger> default_logger_;
     bool automatic_registration_ = true;
@@ -0,0 +1,88 @@
+// Copyright(c) 2015-present, Gabi Melman & spdlog contributors.
+// Distributed under the MIT License (http://opensource.org/licenses/MIT)
+
+#pragma once
+
+#ifndef SPDLOG_HEADER_ONLY
+#include <spdlog/details/task_worker.h>
+#endif
+
+#include <spdlog/details/os.h>
+
+namespace spdlog {
+namespace details {
+
+SPDLOG_INLINE task_worker::task_worker(bool low_priority)
+    : active_(true)
+    , busy_(false)
+{
+    worker_thread_ = std::thread([this, low_priority]() {
+        if (low_priority)
+        {
+            os::set_thread_low_priority();
+        }
+        this->worker_loop_();
+    });
+}
+
+// execute the remaining tasks, stop the worker thread and join it
+SPDLOG_INLINE task_worker::~task_worker()
+{
+    if (worker_thread_.joinable())
+    {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            active_ = false;
+        }
+        cv_.notify_one();
+        worker_thread_.join();
+    }
+}
+
+SPDLOG_INLINE void task_worker::post(task_t task)
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        tasks_.push_back(std::move(task));
+    }
+    cv_.notify_one();
+}
+
+SPDLOG_INLINE void task_worker::wait_idle()
+{
+    std::unique_lock<std::mutex> lock(mutex_);
+    idle_cv_.wait(lock, [this] { return this->tasks_.empty() && !this->busy_; });
+}
+
+SPDLOG_INLINE void task_worker::worker_loop_()
+{
+    for (;;)
+    {
+        task_t task;
+        {
+            std::unique_lock<std::mutex> lock(mutex_);
+            busy_ = false;
+            if (tasks_.empty())
+            {
+                idle_cv_.notify_all();
+            }
+            cv_.wait(lock, [this] { return !this->active_ || !this->tasks_.empty(); });
+            if (tasks_.empty())
+            {
+                return; // active_ == false and nothing left to do, so exit this thread
+            }
+            task = std::move(tasks_.front());
+            tasks_.pop_front();
+            busy_ = true;
+        }
+
+        SPDLOG_TRY
+        {
+            task();
+        }
+        SPDLOG_CATCH_ALL() {} // tasks report their own errors, never let them kill the worker
+    }
+}
+
+} // namespace details
+} // namespace spdlog
@@ -0,0 +1,57 @@
+// Copyright(c) 2015-present, Gabi Melman & spdlog contributors.
+// Distributed under the MIT License (http://opensource.org/licenses/MIT)
+
+#pragma once
+
+// task worker thread - executes the posted tasks one by one, in the order they were posted.
+//
+// RAII over the owned thread:
+//    creates the thread on construction.
+//    executes the remaining tasks, then stops and joins the thread on destruction.
+
+#include <spdlog/common.h>
+
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+
+namespace spdlog {
+namespace details {
+
+class SPDLOG_API task_worker
+{
+public:
+    using task_t = std::function<void()>;
+
+    // if low_priority is true, the worker thread lowers its own scheduling priority (see os::set_thread_low_priority()).
+    explicit task_worker(bool low_priority = false);
+    task_worker(const task_worker &) = delete;
+    task_worker &operator=(const task_worker &) = delete;
+    // execute the remaining tasks, stop the worker thread and join it
+    ~task_worker();
+
+    void post(task_t task);
+
+    // block until all the tasks posted so far have been executed
+    void wait_idle();
+
+private:
+    void worker_loop_();
+
+    bool active_;
+    bool busy_;
+    std::deque<task_t> tasks_;
+    std::mutex mutex_;
+    std::condition_variable cv_;
+    std::condition_variable idle_cv_;
+    std::thread worker_thread_;
+};
+
+} // namespace details
+} // namespace spdlog
+
+#ifdef SPDLOG_HEADER_ONLY
+#include "task_worker-inl.h"
+#endif
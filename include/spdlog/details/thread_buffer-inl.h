@@ -0,0 +1,47 @@
+// Copyright(c) 2015-present, Gabi Melman & spdlog contributors.
+// Distributed under the MIT License (http://opensource.org/licenses/MIT)
+
+#pragma once
+
+#ifndef SPDLOG_HEADER_ONLY
+#include <spdlog/details/thread_buffer.h>
+#endif
+
+namespace spdlog {
+namespace details {
+
+SPDLOG_INLINE thread_buffer::thread_buffer(slot_id id)
+    : buf_(&fallback_)
+{
+#ifdef SPDLOG_NO_TLS
+    (void)id;
+#else
+    auto &s = slot_(id);
+    if (!s.in_use)
+    {
+        s.in_use = true;
+        s.buf.clear();
+        slot_ptr_ = &s;
+        buf_ = &s.buf;
+    }
+#endif
+}
+
+SPDLOG_INLINE thread_buffer::~thread_buffer()
+{
+    if (slot_ptr_ != nullptr)
+    {
+        slot_ptr_->in_use = false;
+    }
+}
+
+#ifndef SPDLOG_NO_TLS
+SPDLOG_INLINE thread_buffer::slot &thread_buffer::slot_(slot_id id)
+{
+    static thread_local slot slots[slots_count];
+    return slots[id];
+}
+#endif
+
+} // namespace details
+} // namespace spdlog
@@ -0,0 +1,65 @@
+// Copyright(c) 2015-present, Gabi Melman & spdlog contributors.
+// Distributed under the MIT License (http://opensource.org/licenses/MIT)
+
+#pragma once
+
+// Thread local formatting buffers, reused by all the log calls of a thread.
+//
+// memory_buf_t keeps 250 bytes on the stack and allocates for longer messages, on every log call.
+// The thread buffers grow to the longest message formatted by the thread and are then reused:
+// after this warm-up, formatting a message doesn't allocate anymore (see "No allocation after warm-up" in README.md).
+// The memory is released when the thread exits.
+//
+// Each stage of a log call has its own slot (payload formatting by the logger, message formatting by the sinks).
+// A nested use of a slot, e.g. logging from a sink or from the formatting of an argument,
+// gets a regular memory_buf_t instead, as does every use if SPDLOG_NO_TLS is defined.
+
+#include <spdlog/common.h>
+
+namespace spdlog {
+namespace details {
+
+class SPDLOG_API thread_buffer
+{
+public:
+    enum slot_id
+    {
+        payload = 0,
+        sink = 1,
+        slots_count = 2
+    };
+
+    // acquire the (cleared) buffer of the slot
+    explicit thread_buffer(slot_id slot);
+    ~thread_buffer();
+
+    thread_buffer(const thread_buffer &) = delete;
+    thread_buffer &operator=(const thread_buffer &) = delete;
+
+    memory_buf_t &get()
+    {
+        return *buf_;
+    }
+
+private:
+    struct slot
+    {
+        memory_buf_t buf;
+        bool in_use = false;
+    };
+
+#ifndef SPDLOG_NO_TLS
+    static slot &slot_(slot_id id);
+#endif
+
+    slot *slot_ptr_ = nullptr; // null if the slot was in use
+    memory_buf_t *buf_;
+    memory_buf_t fallback_;
+};
+
+} // namespace details
+} // namespace spdlog
+
+#ifdef SPDLOG_HEADER_ONLY
+#include "thread_buffer-inl.h"
+#endif
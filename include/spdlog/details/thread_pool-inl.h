@@ -8,28 +8,60 @@
 #endif
 
 #include <spdlog/common.h>
+#include <atomic>
 #include <cassert>
 
 namespace spdlog {
 namespace details {
 
-SPDLOG_INLINE thread_pool::thread_pool(size_t q_max_items, size_t threads_n, std::function<void()> on_thread_start)
-    : q_(q_max_items)
+SPDLOG_INLINE thread_pool::thread_pool(
+    size_t q_max_items, size_t threads_n, std::function<void()> on_thread_start, memory_resource *resource, numa_policy numa)
+    : resource_(resource != nullptr ? resource : get_default_resource())
+    , topology_(numa_topology::instance())
 {
     if (threads_n == 0 || threads_n > 1000)
     {
         throw_spdlog_ex("spdlog::thread_pool(): invalid threads_n param (valid "
                         "range is 1-1000)");
     }
-    for (size_t i = 0; i < threads_n; i++)
+    size_t nodes = numa == numa_policy::per_node ? topology_.nodes_count() : 1;
+    queues_.resize(nodes);
+    if (nodes == 1)
+    {
+        queues_[0] = details::make_unique<q_type>(q_max_items, resource_);
+    }
+    else
+    {
+        for (size_t node = 0; node < nodes; node++)
+        {
+            // allocate (and initialize) the queue from the node: its pages go to the node
+            std::thread([this, node, q_max_items] {
+                topology_.bind_current_thread(node);
+                queues_[node] = details::make_unique<q_type>(q_max_items, resource_);
+            }).join();
+        }
+    }
+
+    for (size_t node = 0; node < nodes; node++)
     {
-        threads_.emplace_back([this, on_thread_start] {
-            on_thread_start();
-            this->thread_pool::worker_loop_();
-        });
+        for (size_t i = 0; i < threads_n; i++)
+        {
+            threads_.emplace_back([this, on_thread_start, node, nodes] {
+                if (nodes > 1)
+                {
+                    topology_.bind_current_thread(node);
+                }
+                on_thread_start();
+                this->thread_pool::worker_loop_(*queues_[node]);
+            });
+        }
     }
 }
 
+SPDLOG_INLINE thread_pool::thread_pool(size_t q_max_items, size_t threads_n, std::function<void()> on_thread_start)
+    : thread_pool(q_max_items, threads_n, std::move(on_thread_start), nullptr)
+{}
+
 SPDLOG_INLINE thread_pool::thread_pool(size_t q_max_items, size_t threads_n)
     : thread_pool(q_max_items, threads_n, [] {})
 {}
@@ -39,9 +71,13 @@ SPDLOG_INLINE thread_pool::~thread_pool()
 {
     SPDLOG_TRY
     {
-        for (size_t i = 0; i < threads_.size(); i++)
+        // the same number of workers for each queue
+        for (auto &q : queues_)
         {
-            post_async_msg_(async_msg(async_msg_type::terminate), async_overflow_policy::block);
+            for (size_t i = 0; i < threads_.size() / queues_.size(); i++)
+            {
+                q->enqueue(async_msg(async_msg_type::terminate));
+            }
         }
 
         for (auto &t : threads_)
@@ -54,44 +90,140 @@ SPDLOG_INLINE thread_pool::~thread_pool()
 
 void SPDLOG_INLINE thread_pool::post_log(async_logger_ptr &&worker_ptr, const details::log_msg &msg, async_overflow_policy overflow_policy)
 {
-    async_msg async_m(std::move(worker_ptr), async_msg_type::log, msg);
+    async_msg async_m(std::move(worker_ptr), async_msg_type::log, msg, resource_);
     post_async_msg_(std::move(async_m), overflow_policy);
 }
 
 void SPDLOG_INLINE thread_pool::post_flush(async_logger_ptr &&worker_ptr, async_overflow_policy overflow_policy)
 {
-    post_async_msg_(async_msg(std::move(worker_ptr), async_msg_type::flush), overflow_policy);
+    if (queues_.size() == 1)
+    {
+        post_async_msg_(async_msg(std::move(worker_ptr), async_msg_type::flush), overflow_policy);
+    }
+    else
+    {
+        async_logger_ptr worker = std::move(worker_ptr);
+        post_to_all_queues_([worker] { worker->backend_flush_(); });
+    }
+}
+
+void SPDLOG_INLINE thread_pool::post_control(std::function<void()> fn)
+{
+    if (queues_.size() == 1)
+    {
+        post_async_msg_(async_msg(std::move(fn)), async_overflow_policy::block);
+    }
+    else
+    {
+        post_to_all_queues_(std::move(fn));
+    }
 }
 
 size_t SPDLOG_INLINE thread_pool::overrun_counter()
 {
-    return q_.overrun_counter();
+    size_t overrun_counter = 0;
+    for (auto &q : queues_)
+    {
+        overrun_counter += q->overrun_counter();
+    }
+    return overrun_counter;
+}
+
+size_t SPDLOG_INLINE thread_pool::queues_count() const
+{
+    return queues_.size();
+}
+
+size_t SPDLOG_INLINE thread_pool::threads_count() const
+{
+    return threads_.size();
+}
+
+SPDLOG_INLINE memory_resource *thread_pool::resource() const
+{
+    return resource_;
+}
+
+// threads_ is not modified after the constructor, which completes before anything is posted to the pool
+bool SPDLOG_INLINE thread_pool::is_worker_thread() const
+{
+    auto id = std::this_thread::get_id();
+    for (auto &t : threads_)
+    {
+        if (t.get_id() == id)
+        {
+            return true;
+        }
+    }
+    return false;
 }
 
 void SPDLOG_INLINE thread_pool::post_async_msg_(async_msg &&new_msg, async_overflow_policy overflow_policy)
 {
+#ifdef SPDLOG_ENABLE_PROFILING
+    SPDLOG_PROFILE_STAGE(new_msg.worker_ptr ? &new_msg.worker_ptr->profile() : nullptr, profiling::enqueue);
+    new_msg.enqueue_cycles = profiling::cycles();
+#endif
+    auto &q = thread_queue_();
     if (overflow_policy == async_overflow_policy::block)
     {
-        q_.enqueue(std::move(new_msg));
+        q.enqueue(std::move(new_msg));
     }
     else
     {
-        q_.enqueue_nowait(std::move(new_msg));
+        q.enqueue_nowait(std::move(new_msg));
+    }
+}
+
+void SPDLOG_INLINE thread_pool::post_to_all_queues_(std::function<void()> fn)
+{
+    struct barrier
+    {
+        std::atomic<size_t> remaining;
+        std::function<void()> fn;
+    };
+    auto shared_barrier = std::make_shared<barrier>();
+    shared_barrier->remaining.store(queues_.size(), std::memory_order_relaxed);
+    shared_barrier->fn = std::move(fn);
+    for (auto &q : queues_)
+    {
+        // acq_rel: the last worker sees the messages dequeued by the others before their marker
+        q->enqueue(async_msg([shared_barrier] {
+            if (shared_barrier->remaining.fetch_sub(1, std::memory_order_acq_rel) == 1)
+            {
+                shared_barrier->fn();
+            }
+        }));
+    }
+}
+
+SPDLOG_INLINE thread_pool::q_type &thread_pool::thread_queue_()
+{
+    if (queues_.size() == 1)
+    {
+        return *queues_[0];
     }
+#ifdef SPDLOG_NO_TLS
+    return *queues_[topology_.current_node() % queues_.size()];
+#else
+    // the node the thread first posted from: a migrated thread keeps its queue, so its messages stay in order
+    static thread_local const size_t node = numa_topology::instance().current_node();
+    return *queues_[node % queues_.size()];
+#endif
 }
 
-void SPDLOG_INLINE thread_pool::worker_loop_()
+void SPDLOG_INLINE thread_pool::worker_loop_(q_type &q)
 {
-    while (process_next_msg_()) {}
+    while (process_next_msg_(q)) {}
 }
 
 // process next message in the queue
 // return true if this thread should still be active (while no terminate msg
 // was received)
-bool SPDLOG_INLINE thread_pool::process_next_msg_()
+bool SPDLOG_INLINE thread_pool::process_next_msg_(q_type &q)
 {
     async_msg incoming_async_msg;
-    bool dequeued = q_.dequeue_for(incoming_async_msg, std::chrono::seconds(10));
+    bool dequeued = q.dequeue_for(incoming_async_msg, std::chrono::seconds(10));
     if (!dequeued)
     {
         return true;
@@ -100,6 +232,10 @@ bool SPDLOG_INLINE thread_pool::process_next_msg_()
     switch (incoming_async_msg.msg_type)
     {
     case async_msg_type::log: {
+#ifdef SPDLOG_ENABLE_PROFILING
+        incoming_async_msg.worker_ptr->profile().record(
+            profiling::queue_wait, profiling::cycles() - incoming_async_msg.enqueue_cycles);
+#endif
         incoming_async_msg.worker_ptr->backend_sink_it_(incoming_async_msg);
         return true;
     }
@@ -108,6 +244,15 @@ bool SPDLOG_INLINE thread_pool::process_next_msg_()
         return true;
     }
 
+    case async_msg_type::control: {
+        SPDLOG_TRY
+        {
+            (*incoming_async_msg.control_fn)();
+        }
+        SPDLOG_CATCH_ALL() {} // control functions report their own errors, never let them kill the worker
+        return true;
+    }
+
     case async_msg_type::terminate: {
         return false;
     }
@@ -5,7 +5,9 @@
 
 #include <spdlog/details/log_msg_buffer.h>
 #include <spdlog/details/mpmc_blocking_q.h>
+#include <spdlog/details/numa.h>
 #include <spdlog/details/os.h>
+#include <spdlog/details/profiler.h>
 
 #include <chrono>
 #include <memory>
@@ -24,6 +26,7 @@ enum class async_msg_type
 {
     log,
     flush,
+    control, // run control_fn on the worker thread
     terminate
 };
 
@@ -34,6 +37,10 @@ struct async_msg : log_msg_buffer
 {
     async_msg_type msg_type{async_msg_type::log};
     async_logger_ptr worker_ptr;
+    std::unique_ptr<std::function<void()>> control_fn; // control messages only. out of line: a pointer to move for the others
+#ifdef SPDLOG_ENABLE_PROFILING
+    uint64_t enqueue_cycles{0}; // for the queue_wait stage
+#endif
 
     async_msg() = default;
     ~async_msg() = default;
@@ -47,6 +54,10 @@ struct async_msg : log_msg_buffer
         : log_msg_buffer(std::move(other))
         , msg_type(other.msg_type)
         , worker_ptr(std::move(other.worker_ptr))
+        , control_fn(std::move(other.control_fn))
+#ifdef SPDLOG_ENABLE_PROFILING
+        , enqueue_cycles(other.enqueue_cycles)
+#endif
     {}
 
     async_msg &operator=(async_msg &&other)
@@ -54,6 +65,10 @@ struct async_msg : log_msg_buffer
         *static_cast<log_msg_buffer *>(this) = std::move(other);
         msg_type = other.msg_type;
         worker_ptr = std::move(other.worker_ptr);
+        control_fn = std::move(other.control_fn);
+#ifdef SPDLOG_ENABLE_PROFILING
+        enqueue_cycles = other.enqueue_cycles;
+#endif
         return *this;
     }
 #else // (_MSC_VER) && _MSC_VER <= 1800
@@ -61,9 +76,9 @@ struct async_msg : log_msg_buffer
     async_msg &operator=(async_msg &&) = default;
 #endif
 
-    // construct from log_msg with given type
-    async_msg(async_logger_ptr &&worker, async_msg_type the_type, const details::log_msg &m)
-        : log_msg_buffer{m}
+    // construct from log_msg with given type, its payload allocated from the given resource
+    async_msg(async_logger_ptr &&worker, async_msg_type the_type, const details::log_msg &m, memory_resource *resource = nullptr)
+        : log_msg_buffer{m, resource}
         , msg_type{the_type}
         , worker_ptr{std::move(worker)}
     {}
@@ -77,14 +92,37 @@ struct async_msg : log_msg_buffer
     explicit async_msg(async_msg_type the_type)
         : async_msg{nullptr, the_type}
     {}
+
+    explicit async_msg(std::function<void()> fn)
+        : async_msg{nullptr, async_msg_type::control}
+    {
+        control_fn = details::make_unique<std::function<void()>>(std::move(fn));
+    }
 };
 
+// the overrun_oldest policy discards the log and flush messages only: the control and terminate messages are never lost
+inline bool overrunnable(const async_msg &msg)
+{
+    return msg.msg_type == async_msg_type::log || msg.msg_type == async_msg_type::flush;
+}
+
 class SPDLOG_API thread_pool
 {
 public:
     using item_type = async_msg;
     using q_type = details::mpmc_blocking_queue<item_type>;
 
+    // the queue and the payloads of the queued messages are allocated from the given resource (the default resource if null).
+    //
+    // numa_policy::per_node: one queue of q_max_items and threads_n worker threads per NUMA node (see details/numa.h).
+    // The workers are bound to the CPUs of their node, and the queue is allocated and initialized by a thread
+    // bound to the node, so its pages are on the node (first touch).
+    // The messages of a thread are queued to the node of the CPU it first posted from (even if it migrates later):
+    // the messages of a thread stay in order, those of threads on different nodes are ordered per node only.
+    // The flushes and control messages are posted to all the queues, and run once all the queues reached them.
+    // On a single node machine, the same as numa_policy::shared.
+    thread_pool(size_t q_max_items, size_t threads_n, std::function<void()> on_thread_start, memory_resource *resource,
+        numa_policy numa = numa_policy::shared);
     thread_pool(size_t q_max_items, size_t threads_n, std::function<void()> on_thread_start);
     thread_pool(size_t q_max_items, size_t threads_n);
 
@@ -95,21 +133,46 @@ public:
     thread_pool &operator=(thread_pool &&) = delete;
 
     void post_log(async_logger_ptr &&worker_ptr, const details::log_msg &msg, async_overflow_policy overflow_policy);
+    // with several queues, the flush is posted as a control message to all of them (blocking, never dropped)
     void post_flush(async_logger_ptr &&worker_ptr, async_overflow_policy overflow_policy);
+
+    // run fn on a worker thread, after the messages posted so far (to any of the queues) were dequeued.
+    // never dropped: blocks if a queue is full, and the overrun_oldest policy doesn't discard it (see overrunnable()).
+    void post_control(std::function<void()> fn);
+
+    // sum of the queues
     size_t overrun_counter();
 
+    // one per NUMA node with numa_policy::per_node, else 1
+    size_t queues_count() const;
+
+    size_t threads_count() const;
+
+    // is the calling thread one of the worker threads of this pool
+    bool is_worker_thread() const;
+
+    memory_resource *resource() const;
+
 private:
-    q_type q_;
+    memory_resource *resource_;
+    const numa_topology &topology_;
+    std::vector<std::unique_ptr<q_type>> queues_; // index: NUMA node
 
     std::vector<std::thread> threads_;
 
     void post_async_msg_(async_msg &&new_msg, async_overflow_policy overflow_policy);
-    void worker_loop_();
+
+    // post fn to all the queues, run once by the worker reaching it last
+    void post_to_all_queues_(std::function<void()> fn);
+
+    // queue of the calling thread
+    q_type &thread_queue_();
+    void worker_loop_(q_type &q);
 
     // process next message in the queue
     // return true if this thread should still be active (while no terminate msg
     // was received)
-    bool process_next_msg_();
+    bool process_next_msg_(q_type &q);
 };
 
 } // namespace details
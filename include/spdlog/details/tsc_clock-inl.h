@@ -0,0 +1,125 @@
+// Copyright(c) 2015-present, Gabi Melman & spdlog contributors.
+// Distributed under the MIT License (http://opensource.org/licenses/MIT)
+
+#pragma once
+
+#ifndef SPDLOG_HEADER_ONLY
+#include <spdlog/details/tsc_clock.h>
+#endif
+
+namespace spdlog {
+namespace details {
+
+// (a * b) >> 32 without overflow, as long as the result fits in 64 bits
+static inline uint64_t mul_shift32(uint64_t a, uint64_t b)
+{
+    uint64_t a_hi = a >> 32, a_lo = a & 0xffffffffu;
+    uint64_t b_hi = b >> 32, b_lo = b & 0xffffffffu;
+    return ((a_hi * b_hi) << 32) + a_hi * b_lo + a_lo * b_hi + ((a_lo * b_lo) >> 32);
+}
+
+// nanoseconds per tick in 32.32 fixed point
+static inline uint64_t tsc_rate(uint64_t elapsed_ticks, int64_t elapsed_ns)
+{
+    if (elapsed_ticks == 0 || elapsed_ns <= 0)
+    {
+        return uint64_t(1) << 32;
+    }
+    return static_cast<uint64_t>(static_cast<double>(elapsed_ns) / static_cast<double>(elapsed_ticks) * 4294967296.0);
+}
+
+SPDLOG_INLINE tsc_clock::tsc_clock(int calibration_ms)
+{
+    sample_ticks_ = ticks();
+    sample_ns_ = system_ns_();
+
+    // spin instead of sleeping: the end sample is taken right after the system clock moved
+    auto end_ns = sample_ns_ + static_cast<int64_t>(calibration_ms) * 1000000;
+    uint64_t t;
+    int64_t ns;
+    do
+    {
+        t = ticks();
+        ns = system_ns_();
+    } while (ns < end_ns);
+
+    publish_(t, ns, tsc_rate(t - sample_ticks_, ns - sample_ns_));
+    sample_ticks_ = t;
+    sample_ns_ = ns;
+}
+
+SPDLOG_INLINE log_clock::time_point tsc_clock::now() const SPDLOG_NOEXCEPT
+{
+    return to_time_point(ticks());
+}
+
+SPDLOG_INLINE log_clock::time_point tsc_clock::to_time_point(uint64_t tsc) const SPDLOG_NOEXCEPT
+{
+    uint32_t seq;
+    uint64_t base_ticks, mult;
+    int64_t ns;
+    do
+    {
+        seq = seq_.load(std::memory_order_acquire);
+        base_ticks = base_ticks_.load(std::memory_order_relaxed);
+        ns = base_ns_.load(std::memory_order_relaxed);
+        mult = mult_.load(std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_acquire);
+    } while ((seq & 1) != 0 || seq != seq_.load(std::memory_order_relaxed));
+
+    // the counters of other cpus may be slightly behind the one that published the base
+    if (tsc > base_ticks)
+    {
+        ns += static_cast<int64_t>(mul_shift32(tsc - base_ticks, mult));
+    }
+    return log_clock::time_point(std::chrono::duration_cast<log_clock::duration>(std::chrono::nanoseconds(ns)));
+}
+
+SPDLOG_INLINE void tsc_clock::resync()
+{
+    std::lock_guard<std::mutex> lock(resync_mutex_);
+    auto t = ticks();
+    auto ns = system_ns_();
+    auto clock_ns = std::chrono::duration_cast<std::chrono::nanoseconds>(to_time_point(t).time_since_epoch()).count();
+    auto elapsed_ns = ns - sample_ns_;
+    auto rate = t > sample_ticks_ && elapsed_ns > 0 ? tsc_rate(t - sample_ticks_, elapsed_ns) : mult_.load(std::memory_order_relaxed);
+    sample_ticks_ = t;
+    sample_ns_ = ns;
+
+    auto error_ns = ns - clock_ns;
+    if (error_ns > max_step_ns || error_ns < -max_step_ns || elapsed_ns <= 0)
+    {
+        publish_(t, ns, rate);
+        return;
+    }
+
+    // continue from the current reading, at a rate that absorbs the error over the next interval
+    auto adjust = static_cast<double>(elapsed_ns + error_ns) / static_cast<double>(elapsed_ns);
+    adjust = adjust < 0.5 ? 0.5 : (adjust > 2.0 ? 2.0 : adjust);
+    publish_(t, clock_ns, static_cast<uint64_t>(static_cast<double>(rate) * adjust));
+}
+
+SPDLOG_INLINE tsc_clock &tsc_clock::instance()
+{
+    static tsc_clock clock;
+    return clock;
+}
+
+SPDLOG_INLINE int64_t tsc_clock::system_ns_()
+{
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(log_clock::now().time_since_epoch()).count();
+}
+
+SPDLOG_INLINE void tsc_clock::publish_(uint64_t base_ticks, int64_t base_ns, uint64_t mult)
+{
+    auto seq = seq_.load(std::memory_order_relaxed);
+    seq_.store(seq + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    base_ticks_.store(base_ticks, std::memory_order_relaxed);
+    base_ns_.store(base_ns, std::memory_order_relaxed);
+    mult_.store(mult, std::memory_order_relaxed);
+    seq_.store(seq + 2, std::memory_order_release);
+}
+
+} // namespace details
+} // namespace spdlog
@@ -0,0 +1,91 @@
+// Copyright(c) 2015-present, Gabi Melman & spdlog contributors.
+// Distributed under the MIT License (http://opensource.org/licenses/MIT)
+
+#pragma once
+
+// Wall clock based on the cpu time stamp counter (see clock_source::tsc).
+//
+// now() reads the counter (rdtsc on x86, cntvct_el0 on aarch64, steady_clock elsewhere) and converts
+// it with a multiply and a shift, instead of calling clock_gettime().
+// The conversion parameters (base ticks, base time and nanoseconds per tick in 32.32 fixed point) are
+// published with a sequence lock, and recalibrated against log_clock by resync(), which the registry calls
+// periodically from a background thread (see spdlog::set_clock_source()).
+// Each resync slews the rate so the clock catches up with log_clock by the next resync without going backwards,
+// unless they are more than max_step apart (e.g. the system clock was set), in which case it jumps.
+
+#include <spdlog/common.h>
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <mutex>
+
+#if defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+#include <intrin.h>
+#elif defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#include <x86intrin.h>
+#endif
+
+namespace spdlog {
+namespace details {
+
+class SPDLOG_API tsc_clock
+{
+public:
+    static SPDLOG_CONSTEXPR const int64_t max_step_ns = 1000000;
+
+    // current value of the counter
+    static uint64_t ticks() SPDLOG_NOEXCEPT
+    {
+#if defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+        return __rdtsc();
+#elif defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+        return __rdtsc();
+#elif defined(__GNUC__) && defined(__aarch64__)
+        uint64_t value;
+        asm volatile("mrs %0, cntvct_el0" : "=r"(value));
+        return value;
+#else
+        return static_cast<uint64_t>(
+            std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count());
+#endif
+    }
+
+    // initial calibration (busy for about calibration_ms)
+    explicit tsc_clock(int calibration_ms = 10);
+
+    tsc_clock(const tsc_clock &) = delete;
+    tsc_clock &operator=(const tsc_clock &) = delete;
+
+    log_clock::time_point now() const SPDLOG_NOEXCEPT;
+
+    // convert the given counter value to log_clock time
+    log_clock::time_point to_time_point(uint64_t tsc) const SPDLOG_NOEXCEPT;
+
+    // recalibrate against log_clock
+    void resync();
+
+    // the clock used by os::now() when the clock source is clock_source::tsc
+    static tsc_clock &instance();
+
+private:
+    static int64_t system_ns_();
+    void publish_(uint64_t base_ticks, int64_t base_ns, uint64_t mult);
+
+    std::atomic<uint32_t> seq_{0};
+    std::atomic<uint64_t> base_ticks_{0};
+    std::atomic<int64_t> base_ns_{0};
+    std::atomic<uint64_t> mult_{0};
+
+    // last calibration sample. used by resync() only
+    std::mutex resync_mutex_;
+    uint64_t sample_ticks_ = 0;
+    int64_t sample_ns_ = 0;
+};
+
+} // namespace details
+} // namespace spdlog
+
+#ifdef SPDLOG_HEADER_ONLY
+#include "tsc_clock-inl.h"
+#endif
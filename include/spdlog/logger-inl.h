@@ -11,6 +11,7 @@
 #include <spdlog/details/backtracer.h>
 #include <spdlog/pattern_formatter.h>
 
+#include <algorithm>
 #include <cstdio>
 
 namespace spdlog {
@@ -62,6 +63,10 @@ SPDLOG_INLINE void logger::swap(spdlog::logger &other) SPDLOG_NOEXCEPT
 
     custom_err_handler_.swap(other.custom_err_handler_);
     std::swap(tracer_, other.tracer_);
+
+    // the sinks were swapped: recompute the minimum sink levels
+    sink_level_.store(0, std::memory_order_relaxed);
+    other.sink_level_.store(0, std::memory_order_relaxed);
 }
 
 SPDLOG_INLINE void swap(logger &a, logger &b)
@@ -132,6 +137,16 @@ SPDLOG_INLINE void logger::flush()
     flush_();
 }
 
+SPDLOG_INLINE bool logger::dirty() const
+{
+    return std::any_of(sinks_.begin(), sinks_.end(), [](const sink_ptr &sink) { return sink->dirty(); });
+}
+
+SPDLOG_INLINE void logger::flush_dirty()
+{
+    flush_dirty_();
+}
+
 SPDLOG_INLINE void logger::flush_on(level::level_enum log_level)
 {
     flush_level_.store(log_level);
@@ -153,6 +168,25 @@ SPDLOG_INLINE std::vector<sink_ptr> &logger::sinks()
     return sinks_;
 }
 
+SPDLOG_INLINE void logger::add_sink(sink_ptr sink)
+{
+    sinks_.push_back(std::move(sink));
+    // after the change: recompute the minimum sink level on the next message
+    sinks::sink::levels_epoch().fetch_add(1, std::memory_order_release);
+}
+
+SPDLOG_INLINE bool logger::remove_sink(const sink_ptr &sink)
+{
+    auto it = std::remove(sinks_.begin(), sinks_.end(), sink);
+    if (it == sinks_.end())
+    {
+        return false;
+    }
+    sinks_.erase(it, sinks_.end());
+    sinks::sink::levels_epoch().fetch_add(1, std::memory_order_release);
+    return true;
+}
+
 // error handler
 SPDLOG_INLINE void logger::set_error_handler(err_handler handler)
 {
@@ -168,6 +202,32 @@ SPDLOG_INLINE std::shared_ptr<logger> logger::clone(std::string logger_name)
 }
 
 // protected methods
+SPDLOG_INLINE uint64_t logger::update_sink_level_()
+{
+    // read the epoch first: a level changed while the sinks are scanned moves it past the cached one
+    auto epoch = sinks::sink::levels_epoch().load(std::memory_order_acquire);
+    // no sinks: don't filter, a derived logger may not use them
+    int min_level = sinks_.empty() ? static_cast<int>(level::trace) : static_cast<int>(level::off);
+    for (auto &sink : sinks_)
+    {
+        min_level = (std::min)(min_level, static_cast<int>(sink->level()));
+    }
+    auto cached = (epoch << 8) | static_cast<uint64_t>(min_level);
+    sink_level_count_.store(sinks_.size(), std::memory_order_relaxed);
+    sink_level_data_.store(sinks_.data(), std::memory_order_relaxed);
+    sink_level_.store(cached, std::memory_order_relaxed);
+    return cached;
+}
+
+SPDLOG_INLINE void logger::flush_rejected_()
+{
+    SPDLOG_TRY
+    {
+        flush_();
+    }
+    SPDLOG_LOGGER_CATCH()
+}
+
 SPDLOG_INLINE void logger::log_it_(const spdlog::details::log_msg &log_msg, bool log_enabled, bool traceback_enabled)
 {
     if (log_enabled)
@@ -189,6 +249,10 @@ SPDLOG_INLINE void logger::sink_it_(const details::log_msg &msg)
             SPDLOG_TRY
             {
                 sink->log(msg);
+                if (sink->count_written(msg.payload.size()))
+                {
+                    sink->flush_tracked();
+                }
             }
             SPDLOG_LOGGER_CATCH()
         }
@@ -206,7 +270,23 @@ SPDLOG_INLINE void logger::flush_()
     {
         SPDLOG_TRY
         {
-            sink->flush();
+            sink->flush_tracked();
+        }
+        SPDLOG_LOGGER_CATCH()
+    }
+}
+
+SPDLOG_INLINE void logger::flush_dirty_()
+{
+    for (auto &sink : sinks_)
+    {
+        if (!sink->dirty())
+        {
+            continue;
+        }
+        SPDLOG_TRY
+        {
+            sink->flush_tracked();
         }
         SPDLOG_LOGGER_CATCH()
     }
@@ -224,9 +304,14 @@ SPDLOG_INLINE void logger::dump_backtrace_()
 }
 
 SPDLOG_INLINE bool logger::should_flush_(const details::log_msg &msg)
+{
+    return should_flush_(msg.level);
+}
+
+SPDLOG_INLINE bool logger::should_flush_(level::level_enum lvl)
 {
     auto flush_level = flush_level_.load(std::memory_order_relaxed);
-    return (msg.level >= flush_level) && (msg.level != level::off);
+    return (lvl >= flush_level) && (lvl != level::off);
 }
 
 SPDLOG_INLINE void logger::err_handler_(const std::string &msg)
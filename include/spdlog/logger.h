@@ -16,7 +16,10 @@
 
 #include <spdlog/common.h>
 #include <spdlog/details/log_msg.h>
+#include <spdlog/details/profiler.h>
 #include <spdlog/details/backtracer.h>
+#include <spdlog/details/thread_buffer.h>
+#include <spdlog/sinks/sink.h>
 
 #ifdef SPDLOG_WCHAR_TO_UTF8_SUPPORT
 #include <spdlog/details/os.h>
@@ -150,7 +153,7 @@ public:
 
     void log(log_clock::time_point log_time, SPDLOG_SOURCE_LOC loc, level::level_enum lvl, string_view_t msg)
     {
-        bool log_enabled = should_log(lvl);
+        bool log_enabled = log_enabled_(lvl);
         bool traceback_enabled = tracer_.enabled();
         if (!log_enabled && !traceback_enabled)
         {
@@ -163,7 +166,7 @@ public:
 
     void log(SPDLOG_SOURCE_LOC loc, level::level_enum lvl, string_view_t msg)
     {
-        bool log_enabled = should_log(lvl);
+        bool log_enabled = log_enabled_(lvl);
         bool traceback_enabled = tracer_.enabled();
         if (!log_enabled && !traceback_enabled)
         {
@@ -232,7 +235,7 @@ public:
     template<typename... Args>
     void log(source_loc loc, level::level_enum lvl, wstring_view_t fmt, const Args &... args)
     {
-        bool log_enabled = should_log(lvl);
+        bool log_enabled = log_enabled_(lvl);
         bool traceback_enabled = tracer_.enabled();
         if (!log_enabled && !traceback_enabled)
         {
@@ -256,7 +259,7 @@ public:
     template<class T, typename std::enable_if<is_convertible_to_wstring_view<const T &>::value, int>::type = 0>
     void log(source_loc loc, level::level_enum lvl, const T &msg)
     {
-        bool log_enabled = should_log(lvl);
+        bool log_enabled = log_enabled_(lvl);
         bool traceback_enabled = tracer_.enabled();
         if (!log_enabled && !traceback_enabled)
         {
@@ -309,18 +312,37 @@ public:
     void flush();
     void flush_on(level::level_enum log_level);
     level::level_enum flush_level() const;
+    // true if one of the sinks was written since its last flush
+    bool dirty() const;
+    // flush the sinks written since their last flush (through the thread pool for async loggers)
+    void flush_dirty();
 
     // sinks
     const std::vector<sink_ptr> &sinks() const;
 
+    // sinks added or removed through the returned vector are seen by the next message.
+    // a sink replaced in place (same size and storage) isn't: prefer add_sink() and remove_sink().
     std::vector<sink_ptr> &sinks();
 
+    // not thread safe: the sinks must not change while the logger is used by other threads
+    void add_sink(sink_ptr sink);
+    // remove all the occurrences of the sink. return false if not found
+    bool remove_sink(const sink_ptr &sink);
+
     // error handler
     void set_error_handler(err_handler);
 
     // create new logger with same sinks and configuration.
     virtual std::shared_ptr<logger> clone(std::string logger_name);
 
+#ifdef SPDLOG_ENABLE_PROFILING
+    // cycles spent in the format, enqueue and queue_wait stages of this logger (see details/profiler.h)
+    details::profiling::stage_profile &profile()
+    {
+        return profile_;
+    }
+#endif
+
 protected:
     std::string name_;
     std::vector<sink_ptr> sinks_;
@@ -328,12 +350,54 @@ protected:
     spdlog::level_t flush_level_{level::off};
     err_handler custom_err_handler_{nullptr};
     details::backtracer tracer_;
+#ifdef SPDLOG_ENABLE_PROFILING
+    details::profiling::stage_profile profile_;
+#endif
+    // minimum level of the sinks (low 8 bits), and the sink::levels_epoch() it was computed at.
+    // add_sink(), remove_sink() and sink::set_level() move the epoch. the changes made through the mutable sinks()
+    // are detected by the size and storage of the sinks vector, saved with the level.
+    std::atomic<uint64_t> sink_level_{0};
+    std::atomic<size_t> sink_level_count_{0};
+    std::atomic<const sink_ptr *> sink_level_data_{nullptr};
+
+    // should_log(lvl), and at least one sink will accept the level: messages that every sink rejects
+    // are neither formatted nor sent to sink_it_() (nor queued by async loggers), but still trigger flush_on().
+    bool log_enabled_(level::level_enum lvl)
+    {
+        if (!should_log(lvl))
+        {
+            return false;
+        }
+        if (sinks_accept_(lvl))
+        {
+            return true;
+        }
+        if (should_flush_(lvl))
+        {
+            flush_rejected_();
+        }
+        return false;
+    }
+
+    bool sinks_accept_(level::level_enum lvl)
+    {
+        auto cached = sink_level_.load(std::memory_order_relaxed);
+        if ((cached >> 8) != sinks::sink::levels_epoch().load(std::memory_order_relaxed) ||
+            sinks_.size() != sink_level_count_.load(std::memory_order_relaxed) ||
+            sinks_.data() != sink_level_data_.load(std::memory_order_relaxed))
+        {
+            cached = update_sink_level_();
+        }
+        return static_cast<int>(lvl) >= static_cast<int>(cached & 0xff);
+    }
+    uint64_t update_sink_level_();
+    void flush_rejected_();
 
     // common implementation for after templated public api has been resolved
     template<typename FormatString, typename... Args>
     void log_(source_loc loc, level::level_enum lvl, const FormatString &fmt, const Args &... args)
     {
-        bool log_enabled = should_log(lvl);
+        bool log_enabled = log_enabled_(lvl);
         bool traceback_enabled = tracer_.enabled();
         if (!log_enabled && !traceback_enabled)
         {
@@ -341,21 +405,46 @@ protected:
         }
         SPDLOG_TRY
         {
-            memory_buf_t buf;
-            fmt::format_to(buf, fmt, args...);
+            // only the backtrace needs this message: store its arguments and format them in dump_backtrace()
+            if (!log_enabled && defer_backtrace_(details::are_deferrable_args<Args...>{}, loc, lvl, fmt, args...))
+            {
+                return;
+            }
+            details::thread_buffer payload_buf(details::thread_buffer::payload);
+            auto &buf = payload_buf.get();
+            {
+                SPDLOG_PROFILE_STAGE(&profile_, details::profiling::format);
+                fmt::format_to(buf, fmt, args...);
+            }
             details::log_msg log_msg(loc, name_, lvl, string_view_t(buf.data(), buf.size()));
             log_it_(log_msg, log_enabled, traceback_enabled);
         }
         SPDLOG_LOGGER_CATCH()
     }
 
+    template<typename FormatString, typename... Args>
+    bool defer_backtrace_(std::true_type, source_loc loc, level::level_enum lvl, const FormatString &fmt, const Args &... args)
+    {
+        details::log_msg log_msg(loc, name_, lvl, string_view_t{});
+        return tracer_.push_back_deferred(log_msg, fmt::to_string_view(fmt), args...);
+    }
+
+    // some of the arguments can't be safely copied: format the message now
+    template<typename FormatString, typename... Args>
+    bool defer_backtrace_(std::false_type, source_loc, level::level_enum, const FormatString &, const Args &...)
+    {
+        return false;
+    }
+
     // log the given message (if the given log level is high enough),
     // and save backtrace (if backtrace is enabled).
     void log_it_(const details::log_msg &log_msg, bool log_enabled, bool traceback_enabled);
     virtual void sink_it_(const details::log_msg &msg);
     virtual void flush_();
+    virtual void flush_dirty_();
     void dump_backtrace_();
     bool should_flush_(const details::log_msg &msg);
+    bool should_flush_(level::level_enum lvl);
 
     // handle errors during logging.
     // default handler prints the error to stderr at max rate of 1 message/sec.
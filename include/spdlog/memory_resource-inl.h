@@ -0,0 +1,81 @@
+// Copyright(c) 2015-present, Gabi Melman & spdlog contributors.
+// Distributed under the MIT License (http://opensource.org/licenses/MIT)
+
+#pragma once
+
+#ifndef SPDLOG_HEADER_ONLY
+#include <spdlog/memory_resource.h>
+#endif
+
+#include <atomic>
+#include <new>
+
+namespace spdlog {
+namespace details {
+
+class new_delete_resource_t final : public memory_resource
+{
+private:
+    void *do_allocate(size_t bytes, size_t alignment) override
+    {
+#ifdef __cpp_aligned_new
+        if (alignment > max_align)
+        {
+            return ::operator new(bytes, std::align_val_t(alignment));
+        }
+#else
+        (void)alignment;
+#endif
+        return ::operator new(bytes);
+    }
+
+    void do_deallocate(void *p, size_t bytes, size_t alignment) override
+    {
+        (void)bytes;
+#ifdef __cpp_aligned_new
+        if (alignment > max_align)
+        {
+            ::operator delete(p, std::align_val_t(alignment));
+            return;
+        }
+#else
+        (void)alignment;
+#endif
+        ::operator delete(p);
+    }
+
+    bool do_is_equal(const memory_resource &other) const SPDLOG_NOEXCEPT override
+    {
+        return this == &other; // a single instance
+    }
+};
+
+SPDLOG_INLINE std::atomic<memory_resource *> &default_resource_ptr()
+{
+    static std::atomic<memory_resource *> resource{new_delete_resource()};
+    return resource;
+}
+
+} // namespace details
+
+SPDLOG_INLINE memory_resource *new_delete_resource() SPDLOG_NOEXCEPT
+{
+    static details::new_delete_resource_t resource;
+    return &resource;
+}
+
+SPDLOG_INLINE memory_resource *get_default_resource() SPDLOG_NOEXCEPT
+{
+    return details::default_resource_ptr().load(std::memory_order_acquire);
+}
+
+SPDLOG_INLINE memory_resource *set_default_resource(memory_resource *resource) SPDLOG_NOEXCEPT
+{
+    if (resource == nullptr)
+    {
+        resource = new_delete_resource();
+    }
+    return details::default_resource_ptr().exchange(resource, std::memory_order_acq_rel);
+}
+
+} // namespace spdlog
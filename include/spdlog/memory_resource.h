@@ -0,0 +1,116 @@
+// Copyright(c) 2015-present, Gabi Melman & spdlog contributors.
+// Distributed under the MIT License (http://opensource.org/licenses/MIT)
+
+#pragma once
+
+// Memory resources, in the style of std::pmr (C++17), for the internal allocations of spdlog:
+// the async queue and its messages (thread_pool), the stored messages (log_msg_buffer, circular_q)
+// and the compiled patterns (pattern_formatter).
+//
+// Each of them takes an optional memory_resource* and keeps it for its whole lifetime.
+// When none is given, the default resource is used (see set_default_resource(), new/delete unless changed).
+// The resource must outlive everything that was given it.
+
+#include <spdlog/common.h>
+
+#include <cstddef>
+#include <type_traits>
+
+namespace spdlog {
+
+class SPDLOG_API memory_resource
+{
+public:
+    static constexpr size_t max_align = alignof(std::max_align_t);
+
+    virtual ~memory_resource() = default;
+
+    void *allocate(size_t bytes, size_t alignment = max_align)
+    {
+        return do_allocate(bytes, alignment);
+    }
+
+    void deallocate(void *p, size_t bytes, size_t alignment = max_align)
+    {
+        do_deallocate(p, bytes, alignment);
+    }
+
+    // can memory allocated from this resource be deallocated by other, and vice versa
+    bool is_equal(const memory_resource &other) const SPDLOG_NOEXCEPT
+    {
+        return this == &other || do_is_equal(other);
+    }
+
+private:
+    virtual void *do_allocate(size_t bytes, size_t alignment) = 0;
+    virtual void do_deallocate(void *p, size_t bytes, size_t alignment) = 0;
+    virtual bool do_is_equal(const memory_resource &other) const SPDLOG_NOEXCEPT = 0;
+};
+
+// resource using the global operator new and delete
+SPDLOG_API memory_resource *new_delete_resource() SPDLOG_NOEXCEPT;
+
+// the resource used when none is given. Thread safe.
+SPDLOG_API memory_resource *get_default_resource() SPDLOG_NOEXCEPT;
+
+// set the default resource (new_delete_resource() if null) and return the previous one.
+// Thread safe, but only affects the objects created afterwards.
+SPDLOG_API memory_resource *set_default_resource(memory_resource *resource) SPDLOG_NOEXCEPT;
+
+// Allocator using a memory resource, for the containers (like std::pmr::polymorphic_allocator).
+// Unlike std::pmr::polymorphic_allocator, the resource follows a container when it is moved or swapped,
+// so moving a container never reallocates its elements.
+template<typename T>
+class polymorphic_allocator
+{
+public:
+    using value_type = T;
+    using propagate_on_container_move_assignment = std::true_type;
+    using propagate_on_container_swap = std::true_type;
+
+    polymorphic_allocator() SPDLOG_NOEXCEPT : resource_(get_default_resource()) {}
+
+    polymorphic_allocator(memory_resource *resource) SPDLOG_NOEXCEPT // NOLINT: implicit, like std::pmr
+        : resource_(resource != nullptr ? resource : get_default_resource())
+    {}
+
+    template<typename U>
+    polymorphic_allocator(const polymorphic_allocator<U> &other) SPDLOG_NOEXCEPT : resource_(other.resource())
+    {}
+
+    T *allocate(size_t n)
+    {
+        return static_cast<T *>(resource_->allocate(n * sizeof(T), alignof(T)));
+    }
+
+    void deallocate(T *p, size_t n)
+    {
+        resource_->deallocate(p, n * sizeof(T), alignof(T));
+    }
+
+    memory_resource *resource() const SPDLOG_NOEXCEPT
+    {
+        return resource_;
+    }
+
+private:
+    memory_resource *resource_;
+};
+
+template<typename T, typename U>
+bool operator==(const polymorphic_allocator<T> &lhs, const polymorphic_allocator<U> &rhs) SPDLOG_NOEXCEPT
+{
+    return lhs.resource()->is_equal(*rhs.resource());
+}
+
+template<typename T, typename U>
+bool operator!=(const polymorphic_allocator<T> &lhs, const polymorphic_allocator<U> &rhs) SPDLOG_NOEXCEPT
+{
+    return !(lhs == rhs);
+}
+
+} // namespace spdlog
+
+#ifdef SPDLOG_HEADER_ONLY
+#include "memory_resource-inl.h"
+#endif
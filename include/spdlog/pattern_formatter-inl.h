@@ -10,6 +10,7 @@
 #include <spdlog/details/fmt_helper.h>
 #include <spdlog/details/log_msg.h>
 #include <spdlog/details/os.h>
+#include <spdlog/details/profiler.h>
 #include <spdlog/fmt/fmt.h>
 #include <spdlog/formatter.h>
 
@@ -20,6 +21,7 @@
 #include <cstring>
 #include <memory>
 #include <mutex>
+#include <new>
 #include <string>
 #include <thread>
 #include <utility>
@@ -656,6 +658,22 @@ public:
     }
 };
 
+// Thread name (see spdlog::set_thread_name())
+template<typename ScopedPadder>
+class thread_name_formatter final : public flag_formatter
+{
+public:
+    explicit thread_name_formatter(padding_info padinfo)
+        : flag_formatter(padinfo)
+    {}
+
+    void format(const details::log_msg &msg, const std::tm &, memory_buf_t &dest) override
+    {
+        ScopedPadder p(msg.thread_name.size(), padinfo_, dest);
+        fmt_helper::append_string_view(msg.thread_name, dest);
+    }
+};
+
 // Current pid
 template<typename ScopedPadder>
 class pid_formatter final : public flag_formatter
@@ -762,16 +780,17 @@ public:
 
     void format(const details::log_msg &msg, const std::tm &, memory_buf_t &dest) override
     {
-        if (msg.source.empty())
+        if (msg.source == nullptr)
         {
             return;
         }
 
+        auto filename = source_filename(*msg.source);
         size_t text_size;
         if (padinfo_.enabled())
         {
             // calc text size for padding based on "filename:line"
-            text_size = std::char_traits<char>::length(msg.source.filename) + ScopedPadder::count_digits(msg.source.line) + 1;
+            text_size = filename.size() + ScopedPadder::count_digits(msg.source->line()) + 1;
         }
         else
         {
@@ -779,9 +798,9 @@ public:
         }
 
         ScopedPadder p(text_size, padinfo_, dest);
-        fmt_helper::append_string_view(msg.source.filename, dest);
+        fmt_helper::append_string_view(filename, dest);
         dest.push_back(':');
-        fmt_helper::append_int(msg.source.line, dest);
+        fmt_helper::append_int(msg.source->line(), dest);
     }
 };
 
@@ -796,13 +815,14 @@ public:
 
     void format(const details::log_msg &msg, const std::tm &, memory_buf_t &dest) override
     {
-        if (msg.source.empty())
+        if (msg.source == nullptr)
         {
             return;
         }
-        size_t text_size = padinfo_.enabled() ? std::char_traits<char>::length(msg.source.filename) : 0;
+        auto filename = source_filename(*msg.source);
+        size_t text_size = padinfo_.enabled() ? filename.size() : 0;
         ScopedPadder p(text_size, padinfo_, dest);
-        fmt_helper::append_string_view(msg.source.filename, dest);
+        fmt_helper::append_string_view(filename, dest);
     }
 };
 
@@ -822,12 +842,13 @@ public:
 
     void format(const details::log_msg &msg, const std::tm &, memory_buf_t &dest) override
     {
-        if (msg.source.empty())
+        if (msg.source == nullptr)
         {
             return;
         }
-        auto filename = basename(msg.source.filename);
-        size_t text_size = padinfo_.enabled() ? std::char_traits<char>::length(filename) : 0;
+        // computed once for each call site of the log macros
+        auto filename = source_short_filename(*msg.source);
+        size_t text_size = padinfo_.enabled() ? filename.size() : 0;
         ScopedPadder p(text_size, padinfo_, dest);
         fmt_helper::append_string_view(filename, dest);
     }
@@ -843,14 +864,14 @@ public:
 
     void format(const details::log_msg &msg, const std::tm &, memory_buf_t &dest) override
     {
-        if (msg.source.empty())
+        if (msg.source == nullptr)
         {
             return;
         }
 
-        auto field_size = ScopedPadder::count_digits(msg.source.line);
+        auto field_size = ScopedPadder::count_digits(msg.source->line());
         ScopedPadder p(field_size, padinfo_, dest);
-        fmt_helper::append_int(msg.source.line, dest);
+        fmt_helper::append_int(msg.source->line(), dest);
     }
 };
 
@@ -865,13 +886,14 @@ public:
 
     void format(const details::log_msg &msg, const std::tm &, memory_buf_t &dest) override
     {
-        if (msg.source.empty())
+        if (msg.source == nullptr)
         {
             return;
         }
-        size_t text_size = padinfo_.enabled() ? std::char_traits<char>::length(msg.source.funcname) : 0;
+        auto funcname = source_funcname(*msg.source);
+        size_t text_size = padinfo_.enabled() ? funcname.size() : 0;
         ScopedPadder p(text_size, padinfo_, dest);
-        fmt_helper::append_string_view(msg.source.funcname, dest);
+        fmt_helper::append_string_view(funcname, dest);
     }
 };
 
@@ -971,13 +993,12 @@ public:
         dest.push_back(' ');
 
         // add source location if present
-        if (!msg.source.empty())
+        if (msg.source != nullptr)
         {
             dest.push_back('[');
-            const char *filename = details::short_filename_formatter<details::null_scoped_padder>::basename(msg.source.filename);
-            fmt_helper::append_string_view(filename, dest);
+            fmt_helper::append_string_view(source_short_filename(*msg.source), dest);
             dest.push_back(':');
-            fmt_helper::append_int(msg.source.line, dest);
+            fmt_helper::append_int(msg.source->line(), dest);
             dest.push_back(']');
             dest.push_back(' ');
         }
@@ -993,11 +1014,13 @@ private:
 } // namespace details
 
 SPDLOG_INLINE pattern_formatter::pattern_formatter(
-    std::string pattern, pattern_time_type time_type, std::string eol, custom_flags custom_user_flags)
+    std::string pattern, pattern_time_type time_type, std::string eol, custom_flags custom_user_flags, memory_resource *resource)
     : pattern_(std::move(pattern))
     , eol_(std::move(eol))
     , pattern_time_type_(time_type)
     , last_log_secs_(0)
+    , resource_(resource != nullptr ? resource : get_default_resource())
+    , formatters_(resource_)
     , custom_handlers_(std::move(custom_user_flags))
 {
     std::memset(&cached_tm_, 0, sizeof(cached_tm_));
@@ -1005,14 +1028,16 @@ SPDLOG_INLINE pattern_formatter::pattern_formatter(
 }
 
 // use by default full formatter for if pattern is not given
-SPDLOG_INLINE pattern_formatter::pattern_formatter(pattern_time_type time_type, std::string eol)
+SPDLOG_INLINE pattern_formatter::pattern_formatter(pattern_time_type time_type, std::string eol, memory_resource *resource)
     : pattern_("%+")
     , eol_(std::move(eol))
     , pattern_time_type_(time_type)
     , last_log_secs_(0)
+    , resource_(resource != nullptr ? resource : get_default_resource())
+    , formatters_(resource_)
 {
     std::memset(&cached_tm_, 0, sizeof(cached_tm_));
-    formatters_.push_back(details::make_unique<details::full_formatter>(details::padding_info{}));
+    formatters_.push_back(make_flag_<details::full_formatter>(details::padding_info{}));
 }
 
 SPDLOG_INLINE std::unique_ptr<formatter> pattern_formatter::clone() const
@@ -1022,11 +1047,12 @@ SPDLOG_INLINE std::unique_ptr<formatter> pattern_formatter::clone() const
     {
         cloned_custom_formatters[it.first] = it.second->clone();
     }
-    return details::make_unique<pattern_formatter>(pattern_, pattern_time_type_, eol_, std::move(cloned_custom_formatters));
+    return details::make_unique<pattern_formatter>(pattern_, pattern_time_type_, eol_, std::move(cloned_custom_formatters), resource_);
 }
 
 SPDLOG_INLINE void pattern_formatter::format(const details::log_msg &msg, memory_buf_t &dest)
 {
+    SPDLOG_PROFILE_STAGE(&details::profiling::sink_profile(), details::profiling::pattern_format);
 #ifndef CEP_SPDLOG_MODIFIED
     auto secs = std::chrono::duration_cast<std::chrono::seconds>(msg.time.time_since_epoch());
     if (secs != last_log_secs_)
@@ -1059,16 +1085,24 @@ SPDLOG_INLINE std::tm pattern_formatter::get_time_(const details::log_msg &msg)
     return details::os::gmtime(log_clock::to_time_t(msg.time));
 }
 
+template<typename T, typename... Args>
+SPDLOG_INLINE std::unique_ptr<T, details::flag_formatter_deleter> pattern_formatter::make_flag_(Args &&... args)
+{
+    void *mem = resource_->allocate(sizeof(T), alignof(T));
+    return std::unique_ptr<T, details::flag_formatter_deleter>(
+        new (mem) T(std::forward<Args>(args)...), details::flag_formatter_deleter{resource_, sizeof(T), alignof(T)});
+}
+
 template<typename Padder>
 SPDLOG_INLINE void pattern_formatter::handle_flag_(char flag, details::padding_info padding)
 {
-    // process custom flags
+    // process custom flags (cloned by the user code, with new)
     auto it = custom_handlers_.find(flag);
     if (it != custom_handlers_.end())
     {
         auto custom_handler = it->second->clone();
         custom_handler->set_padding_info(padding);
-        formatters_.push_back(std::move(custom_handler));
+        formatters_.push_back(details::flag_formatter_ptr(custom_handler.release()));
         return;
     }
 
@@ -1076,178 +1110,182 @@ SPDLOG_INLINE void pattern_formatter::handle_flag_(char flag, details::padding_i
     switch (flag)
     {
     case ('+'): // default formatter
-        formatters_.push_back(details::make_unique<details::full_formatter>(padding));
+        formatters_.push_back(make_flag_<details::full_formatter>(padding));
         break;
 
     case 'n': // logger name
-        formatters_.push_back(details::make_unique<details::name_formatter<Padder>>(padding));
+        formatters_.push_back(make_flag_<details::name_formatter<Padder>>(padding));
         break;
 
     case 'l': // level
-        formatters_.push_back(details::make_unique<details::level_formatter<Padder>>(padding));
+        formatters_.push_back(make_flag_<details::level_formatter<Padder>>(padding));
         break;
 
     case 'L': // short level
-        formatters_.push_back(details::make_unique<details::short_level_formatter<Padder>>(padding));
+        formatters_.push_back(make_flag_<details::short_level_formatter<Padder>>(padding));
         break;
 
     case ('t'): // thread id
-        formatters_.push_back(details::make_unique<details::t_formatter<Padder>>(padding));
+        formatters_.push_back(make_flag_<details::t_formatter<Padder>>(padding));
+        break;
+
+    case ('N'): // thread name
+        formatters_.push_back(make_flag_<details::thread_name_formatter<Padder>>(padding));
         break;
 
     case ('v'): // the message text
-        formatters_.push_back(details::make_unique<details::v_formatter<Padder>>(padding));
+        formatters_.push_back(make_flag_<details::v_formatter<Padder>>(padding));
         break;
 
     case ('a'): // weekday
-        formatters_.push_back(details::make_unique<details::a_formatter<Padder>>(padding));
+        formatters_.push_back(make_flag_<details::a_formatter<Padder>>(padding));
         break;
 
     case ('A'): // short weekday
-        formatters_.push_back(details::make_unique<details::A_formatter<Padder>>(padding));
+        formatters_.push_back(make_flag_<details::A_formatter<Padder>>(padding));
         break;
 
     case ('b'):
     case ('h'): // month
-        formatters_.push_back(details::make_unique<details::b_formatter<Padder>>(padding));
+        formatters_.push_back(make_flag_<details::b_formatter<Padder>>(padding));
         break;
 
     case ('B'): // short month
-        formatters_.push_back(details::make_unique<details::B_formatter<Padder>>(padding));
+        formatters_.push_back(make_flag_<details::B_formatter<Padder>>(padding));
         break;
 
     case ('c'): // datetime
-        formatters_.push_back(details::make_unique<details::c_formatter<Padder>>(padding));
+        formatters_.push_back(make_flag_<details::c_formatter<Padder>>(padding));
         break;
 
     case ('C'): // year 2 digits
-        formatters_.push_back(details::make_unique<details::C_formatter<Padder>>(padding));
+        formatters_.push_back(make_flag_<details::C_formatter<Padder>>(padding));
         break;
 
     case ('Y'): // year 4 digits
-        formatters_.push_back(details::make_unique<details::Y_formatter<Padder>>(padding));
+        formatters_.push_back(make_flag_<details::Y_formatter<Padder>>(padding));
         break;
 
     case ('D'):
     case ('x'): // datetime MM/DD/YY
-        formatters_.push_back(details::make_unique<details::D_formatter<Padder>>(padding));
+        formatters_.push_back(make_flag_<details::D_formatter<Padder>>(padding));
         break;
 
     case ('m'): // month 1-12
-        formatters_.push_back(details::make_unique<details::m_formatter<Padder>>(padding));
+        formatters_.push_back(make_flag_<details::m_formatter<Padder>>(padding));
         break;
 
     case ('d'): // day of month 1-31
-        formatters_.push_back(details::make_unique<details::d_formatter<Padder>>(padding));
+        formatters_.push_back(make_flag_<details::d_formatter<Padder>>(padding));
         break;
 
     case ('H'): // hours 24
-        formatters_.push_back(details::make_unique<details::H_formatter<Padder>>(padding));
+        formatters_.push_back(make_flag_<details::H_formatter<Padder>>(padding));
         break;
 
     case ('I'): // hours 12
-        formatters_.push_back(details::make_unique<details::I_formatter<Padder>>(padding));
+        formatters_.push_back(make_flag_<details::I_formatter<Padder>>(padding));
         break;
 
     case ('M'): // minutes
-        formatters_.push_back(details::make_unique<details::M_formatter<Padder>>(padding));
+        formatters_.push_back(make_flag_<details::M_formatter<Padder>>(padding));
         break;
 
     case ('S'): // seconds
-        formatters_.push_back(details::make_unique<details::S_formatter<Padder>>(padding));
+        formatters_.push_back(make_flag_<details::S_formatter<Padder>>(padding));
         break;
 
     case ('e'): // milliseconds
-        formatters_.push_back(details::make_unique<details::e_formatter<Padder>>(padding));
+        formatters_.push_back(make_flag_<details::e_formatter<Padder>>(padding));
         break;
 
     case ('f'): // microseconds
-        formatters_.push_back(details::make_unique<details::f_formatter<Padder>>(padding));
+        formatters_.push_back(make_flag_<details::f_formatter<Padder>>(padding));
         break;
 
     case ('F'): // nanoseconds
-        formatters_.push_back(details::make_unique<details::F_formatter<Padder>>(padding));
+        formatters_.push_back(make_flag_<details::F_formatter<Padder>>(padding));
         break;
 
     case ('E'): // seconds since epoch
-        formatters_.push_back(details::make_unique<details::E_formatter<Padder>>(padding));
+        formatters_.push_back(make_flag_<details::E_formatter<Padder>>(padding));
         break;
 
     case ('p'): // am/pm
-        formatters_.push_back(details::make_unique<details::p_formatter<Padder>>(padding));
+        formatters_.push_back(make_flag_<details::p_formatter<Padder>>(padding));
         break;
 
     case ('r'): // 12 hour clock 02:55:02 pm
-        formatters_.push_back(details::make_unique<details::r_formatter<Padder>>(padding));
+        formatters_.push_back(make_flag_<details::r_formatter<Padder>>(padding));
         break;
 
     case ('R'): // 24-hour HH:MM time
-        formatters_.push_back(details::make_unique<details::R_formatter<Padder>>(padding));
+        formatters_.push_back(make_flag_<details::R_formatter<Padder>>(padding));
         break;
 
     case ('T'):
     case ('X'): // ISO 8601 time format (HH:MM:SS)
-        formatters_.push_back(details::make_unique<details::T_formatter<Padder>>(padding));
+        formatters_.push_back(make_flag_<details::T_formatter<Padder>>(padding));
         break;
 
     case ('z'): // timezone
-        formatters_.push_back(details::make_unique<details::z_formatter<Padder>>(padding));
+        formatters_.push_back(make_flag_<details::z_formatter<Padder>>(padding));
         break;
 
     case ('P'): // pid
-        formatters_.push_back(details::make_unique<details::pid_formatter<Padder>>(padding));
+        formatters_.push_back(make_flag_<details::pid_formatter<Padder>>(padding));
         break;
 
     case ('^'): // color range start
-        formatters_.push_back(details::make_unique<details::color_start_formatter>(padding));
+        formatters_.push_back(make_flag_<details::color_start_formatter>(padding));
         break;
 
     case ('$'): // color range end
-        formatters_.push_back(details::make_unique<details::color_stop_formatter>(padding));
+        formatters_.push_back(make_flag_<details::color_stop_formatter>(padding));
         break;
 
     case ('@'): // source location (filename:filenumber)
-        formatters_.push_back(details::make_unique<details::source_location_formatter<Padder>>(padding));
+        formatters_.push_back(make_flag_<details::source_location_formatter<Padder>>(padding));
         break;
 
     case ('s'): // short source filename - without directory name
-        formatters_.push_back(details::make_unique<details::short_filename_formatter<Padder>>(padding));
+        formatters_.push_back(make_flag_<details::short_filename_formatter<Padder>>(padding));
         break;
 
     case ('g'): // full source filename
-        formatters_.push_back(details::make_unique<details::source_filename_formatter<Padder>>(padding));
+        formatters_.push_back(make_flag_<details::source_filename_formatter<Padder>>(padding));
         break;
 
     case ('#'): // source line number
-        formatters_.push_back(details::make_unique<details::source_linenum_formatter<Padder>>(padding));
+        formatters_.push_back(make_flag_<details::source_linenum_formatter<Padder>>(padding));
         break;
 
     case ('!'): // source funcname
-        formatters_.push_back(details::make_unique<details::source_funcname_formatter<Padder>>(padding));
+        formatters_.push_back(make_flag_<details::source_funcname_formatter<Padder>>(padding));
         break;
 
     case ('%'): // % char
-        formatters_.push_back(details::make_unique<details::ch_formatter>('%'));
+        formatters_.push_back(make_flag_<details::ch_formatter>('%'));
         break;
 
     case ('u'): // elapsed time since last log message in nanos
-        formatters_.push_back(details::make_unique<details::elapsed_formatter<Padder, std::chrono::nanoseconds>>(padding));
+        formatters_.push_back(make_flag_<details::elapsed_formatter<Padder, std::chrono::nanoseconds>>(padding));
         break;
 
     case ('i'): // elapsed time since last log message in micros
-        formatters_.push_back(details::make_unique<details::elapsed_formatter<Padder, std::chrono::microseconds>>(padding));
+        formatters_.push_back(make_flag_<details::elapsed_formatter<Padder, std::chrono::microseconds>>(padding));
         break;
 
     case ('o'): // elapsed time since last log message in millis
-        formatters_.push_back(details::make_unique<details::elapsed_formatter<Padder, std::chrono::milliseconds>>(padding));
+        formatters_.push_back(make_flag_<details::elapsed_formatter<Padder, std::chrono::milliseconds>>(padding));
         break;
 
     case ('O'): // elapsed time since last log message in seconds
-        formatters_.push_back(details::make_unique<details::elapsed_formatter<Padder, std::chrono::seconds>>(padding));
+        formatters_.push_back(make_flag_<details::elapsed_formatter<Padder, std::chrono::seconds>>(padding));
         break;
 
     default: // Unknown flag appears as is
-        auto unknown_flag = details::make_unique<details::aggregate_formatter>();
+        auto unknown_flag = make_flag_<details::aggregate_formatter>();
         unknown_flag->add_ch('%');
         unknown_flag->add_ch(flag);
         formatters_.push_back((std::move(unknown_flag)));
@@ -1314,7 +1352,7 @@ SPDLOG_INLINE details::padding_info pattern_formatter::handle_padspec_(std::stri
 SPDLOG_INLINE void pattern_formatter::compile_pattern_(const std::string &pattern)
 {
     auto end = pattern.end();
-    std::unique_ptr<details::aggregate_formatter> user_chars;
+    std::unique_ptr<details::aggregate_formatter, details::flag_formatter_deleter> user_chars;
     formatters_.clear();
     for (auto it = pattern.begin(); it != end; ++it)
     {
@@ -1347,7 +1385,7 @@ SPDLOG_INLINE void pattern_formatter::compile_pattern_(const std::string &patter
         {
             if (!user_chars)
             {
-                user_chars = details::make_unique<details::aggregate_formatter>();
+                user_chars = make_flag_<details::aggregate_formatter>();
             }
             user_chars->add_ch(*it);
         }
@@ -7,6 +7,7 @@
 #include <spdlog/details/log_msg.h>
 #include <spdlog/details/os.h>
 #include <spdlog/formatter.h>
+#include <spdlog/memory_resource.h>
 
 #include <chrono>
 #include <ctime>
@@ -61,6 +62,34 @@ protected:
     padding_info padinfo_;
 };
 
+// destroys a flag formatter allocated from the memory resource, or with new if the resource is null
+struct flag_formatter_deleter
+{
+    flag_formatter_deleter() = default;
+    flag_formatter_deleter(memory_resource *r, size_t s, size_t a)
+        : resource(r)
+        , size(s)
+        , alignment(a)
+    {}
+
+    memory_resource *resource = nullptr;
+    size_t size = 0;
+    size_t alignment = 0;
+
+    void operator()(flag_formatter *f) const
+    {
+        if (resource == nullptr)
+        {
+            delete f;
+            return;
+        }
+        f->~flag_formatter();
+        resource->deallocate(f, size, alignment);
+    }
+};
+
+using flag_formatter_ptr = std::unique_ptr<flag_formatter, flag_formatter_deleter>;
+
 } // namespace details
 
 class SPDLOG_API custom_flag_formatter : public details::flag_formatter
@@ -79,11 +108,14 @@ class SPDLOG_API pattern_formatter final : public formatter
 public:
     using custom_flags = std::unordered_map<char, std::unique_ptr<custom_flag_formatter>>;
 
+    // the compiled pattern (the flag formatters) is allocated from the given resource (the default resource if null)
     explicit pattern_formatter(std::string pattern, pattern_time_type time_type = pattern_time_type::local,
-        std::string eol = spdlog::details::os::default_eol, custom_flags custom_user_flags = custom_flags());
+        std::string eol = spdlog::details::os::default_eol, custom_flags custom_user_flags = custom_flags(),
+        memory_resource *resource = nullptr);
 
     // use default pattern is not given
-    explicit pattern_formatter(pattern_time_type time_type = pattern_time_type::local, std::string eol = spdlog::details::os::default_eol);
+    explicit pattern_formatter(pattern_time_type time_type = pattern_time_type::local, std::string eol = spdlog::details::os::default_eol,
+        memory_resource *resource = nullptr);
 
     pattern_formatter(const pattern_formatter &other) = delete;
     pattern_formatter &operator=(const pattern_formatter &other) = delete;
@@ -105,9 +137,14 @@ private:
     pattern_time_type pattern_time_type_;
     std::tm cached_tm_;
     std::chrono::seconds last_log_secs_;
-    std::vector<std::unique_ptr<details::flag_formatter>> formatters_;
+    memory_resource *resource_;
+    std::vector<details::flag_formatter_ptr, polymorphic_allocator<details::flag_formatter_ptr>> formatters_;
     custom_flags custom_handlers_;
 
+    // allocate a flag formatter from resource_
+    template<typename T, typename... Args>
+    std::unique_ptr<T, details::flag_formatter_deleter> make_flag_(Args &&... args);
+
     std::tm get_time_(const details::log_msg &msg);
     template<typename Padder>
     void handle_flag_(char flag, details::padding_info padding);
@@ -8,7 +8,9 @@
 #endif
 
 #include <spdlog/pattern_formatter.h>
+#include <spdlog/details/thread_buffer.h>
 #include <spdlog/details/os.h>
+#include <type_traits>
 
 namespace spdlog {
 namespace sinks {
@@ -25,6 +27,7 @@ SPDLOG_INLINE ansicolor_sink
 #ifndef CEP_SPDLOG_MODIFIED
     , mutex_(ConsoleMutex::mutex())
 #endif
+    , buffer_(target_file)
     , formatter_(details::make_unique<spdlog::pattern_formatter>())
 
 {
@@ -38,6 +41,21 @@ SPDLOG_INLINE ansicolor_sink
     colors_[level::off] = to_string_(reset);
 }
 
+#ifndef CEP_SPDLOG_MODIFIED
+template<typename ConsoleMutex>
+#endif
+SPDLOG_INLINE ansicolor_sink
+#ifndef CEP_SPDLOG_MODIFIED
+    <ConsoleMutex>
+#endif
+    ::~ansicolor_sink()
+{
+#ifndef CEP_SPDLOG_MODIFIED
+    flusher_.reset();
+#endif
+    flush();
+}
+
 #ifndef CEP_SPDLOG_MODIFIED
 template<typename ConsoleMutex>
 #endif
@@ -62,18 +80,20 @@ SPDLOG_INLINE void ansicolor_sink
 #endif
     ::log(const details::log_msg &msg)
 {
-// Wrap the originally formatted message in color codes.
+// Wrap the originally formatted message in color codes, assembled in one buffer and written at once.
 // If color is not supported in the terminal, log as is instead.
 #ifdef CEP_SPDLOG_MODIFIED
 #ifdef CEP_SPDLOG_USE_MUTEX
     cep::Lock_Guard lock{mutex_};
 #endif
 #else
-    std::lock_guard<std::mutex> lock(mutex_t);
+    std::lock_guard<mutex_t> lock(mutex_);
 #endif
+    SPDLOG_PROFILE_SINK_SCOPE(profile_);
     msg.color_range_start = 0;
     msg.color_range_end = 0;
-    memory_buf_t formatted;
+    details::thread_buffer formatted_buf(details::thread_buffer::sink);
+    auto &formatted = formatted_buf.get();
     formatter_->format(msg, formatted);
     if (should_do_colors_ && msg.color_range_end > msg.color_range_start)
     {
@@ -90,7 +110,7 @@ SPDLOG_INLINE void ansicolor_sink
     {
         print_range_(formatted, 0, formatted.size());
     }
-    fflush(target_file_);
+    buffer_.line_done();
 }
 
 #ifndef CEP_SPDLOG_MODIFIED
@@ -107,9 +127,49 @@ SPDLOG_INLINE void ansicolor_sink
     cep::Lock_Guard lock{mutex_};
 #endif
 #else
-    std::lock_guard<std::mutex> lock(mutex_t);
+    std::lock_guard<mutex_t> lock(mutex_);
+#endif
+    buffer_.flush();
+}
+
+#ifndef CEP_SPDLOG_MODIFIED
+template<typename ConsoleMutex>
+#endif
+SPDLOG_INLINE void ansicolor_sink
+#ifndef CEP_SPDLOG_MODIFIED
+    <ConsoleMutex>
+#endif
+    ::set_buffering(console_buffering mode, std::chrono::milliseconds max_latency, size_t block_size)
+{
+#ifndef CEP_SPDLOG_MODIFIED
+    // stop the previous flusher first: it takes the mutex
+    flusher_.reset();
+#endif
+    bool block_mode;
+    {
+#ifdef CEP_SPDLOG_MODIFIED
+#ifdef CEP_SPDLOG_USE_MUTEX
+        cep::Lock_Guard lock{mutex_};
+#endif
+#else
+        std::lock_guard<mutex_t> lock(mutex_);
+#endif
+        buffer_.set_mode(mode, max_latency, block_size);
+        block_mode = buffer_.block_mode();
+    }
+#ifndef CEP_SPDLOG_MODIFIED
+    if (block_mode && !std::is_same<mutex_t, details::null_mutex>::value)
+    {
+        flusher_ = details::make_unique<details::periodic_worker>(
+            [this]() {
+                std::lock_guard<mutex_t> lock(mutex_);
+                buffer_.flush_pending();
+            },
+            max_latency);
+    }
+#else
+    UNUSED(block_mode);
 #endif
-    fflush(target_file_);
 }
 
 #ifndef CEP_SPDLOG_MODIFIED
@@ -126,7 +186,7 @@ SPDLOG_INLINE void ansicolor_sink
     cep::Lock_Guard lock{mutex_};
 #endif
 #else
-    std::lock_guard<std::mutex> lock(mutex_t);
+    std::lock_guard<mutex_t> lock(mutex_);
 #endif
     formatter_ = std::unique_ptr<spdlog::formatter>(new pattern_formatter(pattern));
 }
@@ -145,7 +205,7 @@ SPDLOG_INLINE void ansicolor_sink
     cep::Lock_Guard lock{mutex_};
 #endif
 #else
-    std::lock_guard<std::mutex> lock(mutex_t);
+    std::lock_guard<mutex_t> lock(mutex_);
 #endif
     formatter_ = std::move(sink_formatter);
 }
@@ -194,7 +254,7 @@ SPDLOG_INLINE void ansicolor_sink
 #endif
     ::print_ccode_(const string_view_t &color_code)
 {
-    fwrite(color_code.data(), sizeof(char), color_code.size(), target_file_);
+    buffer_.buf().append(color_code.data(), color_code.data() + color_code.size());
 }
 
 #ifndef CEP_SPDLOG_MODIFIED
@@ -206,7 +266,7 @@ SPDLOG_INLINE void ansicolor_sink
 #endif
     ::print_range_(const memory_buf_t &formatted, size_t start, size_t end)
 {
-    fwrite(formatted.data() + start, sizeof(char), end - start, target_file_);
+    buffer_.buf().append(formatted.data() + start, formatted.data() + end);
 }
 
 #ifndef CEP_SPDLOG_MODIFIED
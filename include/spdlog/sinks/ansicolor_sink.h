@@ -3,9 +3,14 @@
 
 #pragma once
 
+#include <spdlog/details/console_buffer.h>
 #include <spdlog/details/console_globals.h>
 #include <spdlog/details/null_mutex.h>
 #include <spdlog/sinks/sink.h>
+#ifndef CEP_SPDLOG_MODIFIED
+#include <spdlog/details/periodic_worker.h>
+#endif
+#include <chrono>
 #include <memory>
 #include <mutex>
 #include <string>
@@ -36,7 +41,7 @@ public:
 #endif
 
     ansicolor_sink(FILE *target_file, color_mode mode);
-    ~ansicolor_sink() override = default;
+    ~ansicolor_sink() override;
 
     ansicolor_sink(const ansicolor_sink &other) = delete;
     ansicolor_sink(ansicolor_sink &&other) = delete;
@@ -53,6 +58,12 @@ public:
     void set_pattern(const std::string &pattern) final;
     void set_formatter(std::unique_ptr<spdlog::formatter> sink_formatter) override;
 
+    // Line (default) or block buffering (see console_buffering).
+    // In block mode the mt sinks flush the pending messages every max_latency from a background thread,
+    // the st sinks on the next message only.
+    void set_buffering(console_buffering mode, std::chrono::milliseconds max_latency = std::chrono::milliseconds(100),
+        size_t block_size = details::console_buffer::default_block_size);
+
     // Formatting codes
     const string_view_t reset = "\033[m";
     const string_view_t bold = "\033[1m";
@@ -98,8 +109,12 @@ private:
     mutex_t &mutex_;
 #endif
     bool should_do_colors_;
+    details::console_buffer buffer_;
     std::unique_ptr<spdlog::formatter> formatter_;
     std::array<std::string, level::n_levels> colors_;
+#ifndef CEP_SPDLOG_MODIFIED
+    std::unique_ptr<details::periodic_worker> flusher_;
+#endif
     void print_ccode_(const string_view_t &color_code);
     void print_range_(const memory_buf_t &formatted, size_t start, size_t end);
     static std::string to_string_(const string_view_t &sv);
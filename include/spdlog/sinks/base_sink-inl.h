@@ -25,8 +25,12 @@ SPDLOG_INLINE spdlog::sinks::base_sink<Mutex>::base_sink(std::unique_ptr<spdlog:
 template<typename Mutex>
 void SPDLOG_INLINE spdlog::sinks::base_sink<Mutex>::log(const details::log_msg &msg)
 {
-    std::lock_guard<Mutex> lock(mutex_);
-    sink_it_(msg);
+    {
+        std::lock_guard<Mutex> lock(mutex_);
+        SPDLOG_PROFILE_SINK_SCOPE(profile_);
+        sink_it_(msg);
+    }
+    after_sink_it_();
 }
 
 template<typename Mutex>
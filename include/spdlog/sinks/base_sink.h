@@ -11,6 +11,7 @@
 
 #include <spdlog/common.h>
 #include <spdlog/details/log_msg.h>
+#include <spdlog/details/thread_buffer.h>
 #include <spdlog/sinks/sink.h>
 
 namespace spdlog {
@@ -43,6 +44,9 @@ protected:
     virtual void flush_() = 0;
     virtual void set_pattern_(const std::string &pattern);
     virtual void set_formatter_(std::unique_ptr<spdlog::formatter> sink_formatter);
+    // called by log() after the mutex is released (e.g. to wait until the message is durable without
+    // blocking the other producers)
+    virtual void after_sink_it_() {}
 };
 } // namespace sinks
 } // namespace spdlog
@@ -28,7 +28,8 @@ SPDLOG_INLINE const filename_t &basic_file_sink<Mutex>::filename() const
 template<typename Mutex>
 SPDLOG_INLINE void basic_file_sink<Mutex>::sink_it_(const details::log_msg &msg)
 {
-    memory_buf_t formatted;
+    details::thread_buffer formatted_buf(details::thread_buffer::sink);
+    auto &formatted = formatted_buf.get();
     base_sink<Mutex>::formatter_->format(msg, formatted);
     file_helper_.write(formatted);
 }
@@ -39,5 +40,20 @@ SPDLOG_INLINE void basic_file_sink<Mutex>::flush_()
     file_helper_.flush();
 }
 
+#ifndef CEP_SPDLOG_MODIFIED
+template<typename Mutex>
+SPDLOG_INLINE void basic_file_sink<Mutex>::enable_durability(std::chrono::microseconds window)
+{
+    std::lock_guard<Mutex> lock(base_sink<Mutex>::mutex_);
+    file_helper_.enable_group_commit(window);
+}
+
+template<typename Mutex>
+SPDLOG_INLINE void basic_file_sink<Mutex>::after_sink_it_()
+{
+    file_helper_.wait_durable();
+}
+#endif
+
 } // namespace sinks
 } // namespace spdlog
@@ -8,6 +8,7 @@
 #include <spdlog/sinks/base_sink.h>
 #include <spdlog/details/synchronous_factory.h>
 
+#include <chrono>
 #include <mutex>
 #include <string>
 
@@ -22,10 +23,19 @@ class basic_file_sink final : public base_sink<Mutex>
 public:
     explicit basic_file_sink(const filename_t &filename, bool truncate = false);
     const filename_t &filename() const;
+#ifndef CEP_SPDLOG_MODIFIED
+    // Durable mode (group commit): log() returns once the message is on disk (fdatasync).
+    // The messages logged by other threads meanwhile are written and synced together, a window > 0 makes
+    // the groups larger at the cost of latency (see details/group_commit.h). Call it before logging.
+    void enable_durability(std::chrono::microseconds window = std::chrono::microseconds::zero());
+#endif
 
 protected:
     void sink_it_(const details::log_msg &msg) override;
     void flush_() override;
+#ifndef CEP_SPDLOG_MODIFIED
+    void after_sink_it_() override;
+#endif
 
 private:
     details::file_helper file_helper_;
@@ -0,0 +1,160 @@
+// Copyright(c) 2015-present, Gabi Melman & spdlog contributors.
+// Distributed under the MIT License (http://opensource.org/licenses/MIT)
+
+#pragma once
+
+#ifndef SPDLOG_HEADER_ONLY
+#include <spdlog/sinks/compressed_rotating_file_sink.h>
+#endif
+
+#include <spdlog/common.h>
+
+#include <spdlog/details/file_helper.h>
+#include <spdlog/details/lz4_block.h>
+#include <spdlog/details/null_mutex.h>
+#include <spdlog/details/os.h>
+#include <spdlog/sinks/rotating_file_sink.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <mutex>
+#include <string>
+
+namespace spdlog {
+namespace sinks {
+
+template<typename Mutex>
+const std::size_t compressed_rotating_file_sink<Mutex>::default_block_size;
+
+template<typename Mutex>
+SPDLOG_INLINE compressed_rotating_file_sink<Mutex>::compressed_rotating_file_sink(
+    filename_t base_filename, std::size_t max_size, std::size_t max_files, std::size_t block_size, bool rotate_on_open)
+    : base_filename_(std::move(base_filename))
+    , max_size_(max_size)
+    , max_files_(max_files)
+    , block_size_((std::min)((std::max)(block_size, std::size_t(1)), details::lz4::max_block_size))
+{
+    file_helper_.open(calc_filename(base_filename_, 0));
+    current_size_ = file_helper_.size(); // expensive. called only once
+    if (rotate_on_open && current_size_ > 0)
+    {
+        rotate_();
+    }
+    write_header_();
+}
+
+template<typename Mutex>
+SPDLOG_INLINE compressed_rotating_file_sink<Mutex>::~compressed_rotating_file_sink()
+{
+    SPDLOG_TRY
+    {
+        write_pending_();
+        file_helper_.flush();
+    }
+    SPDLOG_CATCH_ALL() {}
+}
+
+// calc filename according to index and file extension if exists.
+// e.g. calc_filename("logs/mylog.lz4, 3) => "logs/mylog.3.lz4".
+template<typename Mutex>
+SPDLOG_INLINE filename_t compressed_rotating_file_sink<Mutex>::calc_filename(const filename_t &filename, std::size_t index)
+{
+    return rotating_file_sink<Mutex>::calc_filename(filename, index);
+}
+
+template<typename Mutex>
+SPDLOG_INLINE filename_t compressed_rotating_file_sink<Mutex>::filename()
+{
+    std::lock_guard<Mutex> lock(base_sink<Mutex>::mutex_);
+    return file_helper_.filename();
+}
+
+template<typename Mutex>
+SPDLOG_INLINE void compressed_rotating_file_sink<Mutex>::sink_it_(const details::log_msg &msg)
+{
+    base_sink<Mutex>::formatter_->format(msg, pending_);
+    if (pending_.size() >= block_size_)
+    {
+        write_pending_();
+    }
+}
+
+template<typename Mutex>
+SPDLOG_INLINE void compressed_rotating_file_sink<Mutex>::flush_()
+{
+    write_pending_();
+    file_helper_.flush();
+}
+
+template<typename Mutex>
+SPDLOG_INLINE void compressed_rotating_file_sink<Mutex>::write_pending_()
+{
+    const auto *data = pending_.data();
+    auto remaining = pending_.size();
+    while (remaining > 0)
+    {
+        auto n = (std::min)(remaining, details::lz4::max_block_size);
+
+        // each block is prefixed with its compressed size
+        compressed_.clear();
+        auto block_size = details::lz4::compress_block(data, n, compressed_);
+        memory_buf_t size_prefix;
+        details::lz4::append_le32(static_cast<uint32_t>(block_size), size_prefix);
+        auto framed_size = size_prefix.size() + block_size;
+
+        // never rotate a file that contains the header only
+        if (current_size_ + framed_size > max_size_ && current_size_ > 4)
+        {
+            rotate_();
+        }
+        file_helper_.write(size_prefix);
+        file_helper_.write(compressed_);
+        current_size_ += framed_size;
+
+        data += n;
+        remaining -= n;
+    }
+    pending_.clear();
+}
+
+// Rotate files:
+// log.lz4 -> log.1.lz4
+// log.1.lz4 -> log.2.lz4
+// log.2.lz4 -> log.3.lz4
+// log.3.lz4 -> delete
+template<typename Mutex>
+SPDLOG_INLINE void compressed_rotating_file_sink<Mutex>::rotate_()
+{
+    using details::os::filename_to_str;
+    file_helper_.close();
+    filename_t failed_src, failed_target;
+    bool shifted = rotating_file_sink<Mutex>::shift_files(base_filename_, max_files_, failed_src, failed_target);
+    auto rename_errno = errno;
+    // on failure too: truncate the log file anyway to prevent it to grow beyond its limit,
+    // and start it with the header so the next blocks make a valid frame
+    file_helper_.reopen(true);
+    current_size_ = 0;
+    write_header_();
+    if (!shifted)
+    {
+        throw_spdlog_ex("compressed_rotating_file_sink: failed renaming " + filename_to_str(failed_src) + " to " +
+                            filename_to_str(failed_target),
+            rename_errno);
+    }
+}
+
+template<typename Mutex>
+SPDLOG_INLINE void compressed_rotating_file_sink<Mutex>::write_header_()
+{
+    if (current_size_ > 0)
+    {
+        return;
+    }
+    memory_buf_t header;
+    details::lz4::append_le32(details::lz4::legacy_magic, header);
+    file_helper_.write(header);
+    current_size_ = header.size();
+}
+
+} // namespace sinks
+} // namespace spdlog
@@ -0,0 +1,99 @@
+// Copyright(c) 2015-present, Gabi Melman & spdlog contributors.
+// Distributed under the MIT License (http://opensource.org/licenses/MIT)
+
+#pragma once
+
+#include <spdlog/sinks/base_sink.h>
+#include <spdlog/details/file_helper.h>
+#include <spdlog/details/null_mutex.h>
+#include <spdlog/details/synchronous_factory.h>
+
+#include <chrono>
+#include <mutex>
+#include <string>
+
+namespace spdlog {
+namespace sinks {
+
+//
+// Rotating file sink that writes lz4 compressed files.
+//
+// Formatted messages are accumulated until block_size bytes are pending (or until flush),
+// and then compressed as a single independent lz4 block. A crash loses at most the pending
+// block, and the files can be read with "lz4 -d" or details::lz4::decompress_frame().
+//
+// Rotation is based on the compressed size of the file, and follows the
+// rotating_file_sink naming scheme:
+// log.lz4 -> log.1.lz4 -> log.2.lz4 ... -> delete
+//
+// Compression happens in the thread that calls the sink (the thread pool thread for async loggers).
+//
+template<typename Mutex>
+class compressed_rotating_file_sink final : public base_sink<Mutex>
+{
+public:
+    static const std::size_t default_block_size = 256 * 1024;
+
+    compressed_rotating_file_sink(filename_t base_filename, std::size_t max_size, std::size_t max_files,
+        std::size_t block_size = default_block_size, bool rotate_on_open = false);
+    ~compressed_rotating_file_sink() override;
+    static filename_t calc_filename(const filename_t &filename, std::size_t index);
+    filename_t filename();
+
+protected:
+    void sink_it_(const details::log_msg &msg) override;
+    void flush_() override;
+
+private:
+    // compress the pending data into a new block and write it to the file.
+    // rotate first if the block would make the file grow beyond max_size_.
+    void write_pending_();
+
+    // Rotate files:
+    // log.lz4 -> log.1.lz4
+    // log.1.lz4 -> log.2.lz4
+    // log.2.lz4 -> log.3.lz4
+    // log.3.lz4 -> delete
+    // and start the new file with the frame header.
+    void rotate_();
+
+    // write the frame header if the current file is empty
+    void write_header_();
+
+    filename_t base_filename_;
+    std::size_t max_size_;
+    std::size_t max_files_;
+    std::size_t block_size_;
+    std::size_t current_size_;
+    memory_buf_t pending_;
+    memory_buf_t compressed_;
+    details::file_helper file_helper_;
+};
+
+using compressed_rotating_file_sink_mt = compressed_rotating_file_sink<std::mutex>;
+using compressed_rotating_file_sink_st = compressed_rotating_file_sink<details::null_mutex>;
+
+} // namespace sinks
+
+//
+// factory functions
+//
+
+template<typename Factory = spdlog::synchronous_factory>
+inline std::shared_ptr<logger> compressed_rotating_logger_mt(const std::string &logger_name, const filename_t &filename,
+    size_t max_file_size, size_t max_files, size_t block_size = sinks::compressed_rotating_file_sink_mt::default_block_size)
+{
+    return Factory::template create<sinks::compressed_rotating_file_sink_mt>(logger_name, filename, max_file_size, max_files, block_size);
+}
+
+template<typename Factory = spdlog::synchronous_factory>
+inline std::shared_ptr<logger> compressed_rotating_logger_st(const std::string &logger_name, const filename_t &filename,
+    size_t max_file_size, size_t max_files, size_t block_size = sinks::compressed_rotating_file_sink_st::default_block_size)
+{
+    return Factory::template create<sinks::compressed_rotating_file_sink_st>(logger_name, filename, max_file_size, max_files, block_size);
+}
+} // namespace spdlog
+
+#ifdef SPDLOG_HEADER_ONLY
+#include "compressed_rotating_file_sink-inl.h"
+#endif
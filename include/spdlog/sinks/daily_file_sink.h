@@ -4,6 +4,7 @@
 #pragma once
 
 #include <spdlog/common.h>
+#include <spdlog/details/file_archiver.h>
 #include <spdlog/details/file_helper.h>
 #include <spdlog/details/null_mutex.h>
 #include <spdlog/fmt/fmt.h>
@@ -40,6 +41,8 @@ struct daily_filename_calculator
  * Rotating file sink based on date.
  * If truncate != false , the created file will be truncated.
  * If max_files > 0, retain only the last max_files and delete previous.
+ * If a rotation hook is set (e.g. details::file_archiver::make_hook()), each previous file is handed over
+ * to the hook instead, which owns it from then on (max_files is not used in this case).
  */
 template<typename Mutex, typename FileNameCalc = daily_filename_calculator>
 class daily_file_sink final : public base_sink<Mutex>
@@ -76,23 +79,50 @@ public:
         return file_helper_.filename();
     }
 
+    void set_rotation_hook(details::rotation_hook hook)
+    {
+        std::lock_guard<Mutex> lock(base_sink<Mutex>::mutex_);
+        rotation_hook_ = std::move(hook);
+    }
+
+#ifndef CEP_SPDLOG_MODIFIED
+    // Durable mode (group commit): log() returns once the message is on disk (fdatasync).
+    // The messages logged by other threads meanwhile are written and synced together, a window > 0 makes
+    // the groups larger at the cost of latency (see details/group_commit.h). Call it before logging.
+    void enable_durability(std::chrono::microseconds window = std::chrono::microseconds::zero())
+    {
+        std::lock_guard<Mutex> lock(base_sink<Mutex>::mutex_);
+        file_helper_.enable_group_commit(window);
+    }
+#endif
+
 protected:
     void sink_it_(const details::log_msg &msg) override
     {
         auto time = msg.time;
         bool should_rotate = time >= rotation_tp_;
+        filename_t old_filename;
         if (should_rotate)
         {
             auto filename = FileNameCalc::calc_filename(base_filename_, now_tm(time));
+            if (rotation_hook_ && filename != file_helper_.filename())
+            {
+                old_filename = file_helper_.filename();
+            }
             file_helper_.open(filename, truncate_);
             rotation_tp_ = next_rotation_tp_();
         }
-        memory_buf_t formatted;
+        details::thread_buffer formatted_buf(details::thread_buffer::sink);
+        auto &formatted = formatted_buf.get();
         base_sink<Mutex>::formatter_->format(msg, formatted);
         file_helper_.write(formatted);
 
         // Do the cleaning only at the end because it might throw on failure.
-        if (should_rotate && max_files_ > 0)
+        if (!old_filename.empty())
+        {
+            rotation_hook_(old_filename);
+        }
+        else if (should_rotate && max_files_ > 0 && !rotation_hook_)
         {
             delete_old_();
         }
@@ -103,6 +133,13 @@ protected:
         file_helper_.flush();
     }
 
+#ifndef CEP_SPDLOG_MODIFIED
+    void after_sink_it_() override
+    {
+        file_helper_.wait_durable();
+    }
+#endif
+
 private:
     void init_filenames_q_()
     {
@@ -178,6 +215,7 @@ private:
     bool truncate_;
     uint16_t max_files_;
     details::circular_q<filename_t> filenames_q_;
+    details::rotation_hook rotation_hook_;
 };
 
 using daily_file_sink_mt = daily_file_sink<std::mutex>;
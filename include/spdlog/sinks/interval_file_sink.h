@@ -0,0 +1,277 @@
+// Copyright(c) 2015-present, Gabi Melman & spdlog contributors.
+// Distributed under the MIT License (http://opensource.org/licenses/MIT)
+
+#pragma once
+
+#include <spdlog/common.h>
+#include <spdlog/details/file_archiver.h>
+#include <spdlog/details/file_helper.h>
+#include <spdlog/details/null_mutex.h>
+#include <spdlog/fmt/fmt.h>
+#include <spdlog/sinks/base_sink.h>
+#include <spdlog/details/os.h>
+#include <spdlog/details/circular_q.h>
+#include <spdlog/details/synchronous_factory.h>
+
+#include <chrono>
+#include <cstdio>
+#include <ctime>
+#include <cwchar>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace spdlog {
+namespace sinks {
+
+/*
+ * Generator of interval log file names from a strftime style template.
+ * e.g. "logs/app_%Y-%m-%d_%H-%M.txt" => "logs/app_2020-01-31_13-15.txt"
+ */
+struct interval_filename_calculator
+{
+    // Create filename from the template and the start time of the interval
+    static filename_t calc_filename(const filename_t &filename_template, const tm &start_tm)
+    {
+        if (filename_template.empty())
+        {
+            return filename_template;
+        }
+
+        std::vector<filename_t::value_type> buf(filename_template.size() + 64);
+        for (;;)
+        {
+#if defined(_WIN32) && defined(SPDLOG_WCHAR_FILENAMES)
+            auto len = std::wcsftime(buf.data(), buf.size(), filename_template.c_str(), &start_tm);
+#else
+            auto len = std::strftime(buf.data(), buf.size(), filename_template.c_str(), &start_tm);
+#endif
+            // strftime returns 0 if the result doesn't fit
+            if (len > 0 || buf.size() > 4096)
+            {
+                return filename_t(buf.data(), len);
+            }
+            buf.resize(buf.size() * 2);
+        }
+    }
+};
+
+/*
+ * Rotating file sink based on time intervals (e.g. every hour, or every 15 minutes).
+ * Interval boundaries are aligned to the local midnight: with a 15 minutes interval the files
+ * are rotated at 00:00, 00:15, 00:30... Intervals that don't divide a day are restarted at
+ * midnight (e.g. 7 hours: 00:00, 07:00, 14:00, 21:00, 00:00...).
+ *
+ * The file of each interval is named by formatting the filename template with the interval start time.
+ * The next rotation time is precomputed, so the check on each message is a single integer comparison.
+ *
+ * If truncate != false , the created file will be truncated.
+ * If max_files > 0, retain only the last max_files and delete previous.
+ * If a rotation hook is set (e.g. details::file_archiver::make_hook()), each previous file is handed over
+ * to the hook instead, which owns it from then on (max_files is not used in this case).
+ */
+template<typename Mutex, typename FileNameCalc = interval_filename_calculator>
+class interval_file_sink final : public base_sink<Mutex>
+{
+public:
+    // create interval file sink which rotates every interval (at most 24 hours)
+    interval_file_sink(filename_t filename_template, log_clock::duration interval, bool truncate = false, uint16_t max_files = 0)
+        : filename_template_(std::move(filename_template))
+        , interval_(interval)
+        , truncate_(truncate)
+        , max_files_(max_files)
+        , filenames_q_()
+    {
+        if (interval_ <= log_clock::duration::zero() || interval_ > std::chrono::hours(24))
+        {
+            throw_spdlog_ex("interval_file_sink: Invalid rotation interval in ctor");
+        }
+
+        update_rotation_tp_(log_clock::now());
+        file_helper_.open(FileNameCalc::calc_filename(filename_template_, now_tm(interval_start_)), truncate_);
+
+        if (max_files_ > 0)
+        {
+            init_filenames_q_();
+        }
+    }
+
+    filename_t filename()
+    {
+        std::lock_guard<Mutex> lock(base_sink<Mutex>::mutex_);
+        return file_helper_.filename();
+    }
+
+    void set_rotation_hook(details::rotation_hook hook)
+    {
+        std::lock_guard<Mutex> lock(base_sink<Mutex>::mutex_);
+        rotation_hook_ = std::move(hook);
+    }
+
+protected:
+    void sink_it_(const details::log_msg &msg) override
+    {
+        bool should_rotate = false;
+        filename_t old_filename;
+        if (msg.time.time_since_epoch().count() >= rotation_ticks_)
+        {
+            update_rotation_tp_(msg.time);
+            auto filename = FileNameCalc::calc_filename(filename_template_, now_tm(interval_start_));
+            // a template coarser than the interval (e.g. %H with 15 minutes) gives the same file: keep it open
+            should_rotate = filename != file_helper_.filename();
+            if (should_rotate)
+            {
+                if (rotation_hook_)
+                {
+                    old_filename = file_helper_.filename();
+                }
+                file_helper_.open(filename, truncate_);
+            }
+        }
+        details::thread_buffer formatted_buf(details::thread_buffer::sink);
+        auto &formatted = formatted_buf.get();
+        base_sink<Mutex>::formatter_->format(msg, formatted);
+        file_helper_.write(formatted);
+
+        // Do the cleaning only at the end because it might throw on failure.
+        if (!old_filename.empty())
+        {
+            rotation_hook_(old_filename);
+        }
+        else if (should_rotate && max_files_ > 0 && !rotation_hook_)
+        {
+            delete_old_();
+        }
+    }
+
+    void flush_() override
+    {
+        file_helper_.flush();
+    }
+
+private:
+    void init_filenames_q_()
+    {
+        using details::os::path_exists;
+
+        filenames_q_ = details::circular_q<filename_t>(static_cast<size_t>(max_files_));
+        std::vector<filename_t> filenames;
+        auto start = interval_start_;
+        // the consecutive intervals of a coarse template share a file: look back up to max_files days
+        auto oldest_start = interval_start_ - std::chrono::hours(24) * (max_files_ + 1);
+        while (filenames.size() < max_files_ && start > oldest_start)
+        {
+            auto filename = FileNameCalc::calc_filename(filename_template_, now_tm(start));
+            start -= interval_;
+            if (!filenames.empty() && filename == filenames.back())
+            {
+                continue;
+            }
+            if (!path_exists(filename))
+            {
+                break;
+            }
+            filenames.emplace_back(filename);
+        }
+        for (auto iter = filenames.rbegin(); iter != filenames.rend(); ++iter)
+        {
+            filenames_q_.push_back(std::move(*iter));
+        }
+    }
+
+    tm now_tm(log_clock::time_point tp)
+    {
+        time_t tnow = log_clock::to_time_t(tp);
+        return spdlog::details::os::localtime(tnow);
+    }
+
+    // local midnight of the day of tp, plus the given number of days
+    log_clock::time_point midnight_(log_clock::time_point tp, int days)
+    {
+        tm date = now_tm(tp);
+        date.tm_mday += days;
+        date.tm_hour = 0;
+        date.tm_min = 0;
+        date.tm_sec = 0;
+        date.tm_isdst = -1;
+        return log_clock::from_time_t(std::mktime(&date));
+    }
+
+    // compute the start of the interval containing tp, and the start of the next one.
+    void update_rotation_tp_(log_clock::time_point tp)
+    {
+        auto midnight = midnight_(tp, 0);
+        interval_start_ = midnight + ((tp - midnight) / interval_) * interval_;
+        auto next_rotation = (std::min)(interval_start_ + interval_, midnight_(tp, 1));
+        rotation_ticks_ = next_rotation.time_since_epoch().count();
+    }
+
+    // Delete the file N rotations ago.
+    // Throw spdlog_ex on failure to delete the old file.
+    void delete_old_()
+    {
+        using details::os::filename_to_str;
+        using details::os::remove_if_exists;
+
+        filename_t current_file = file_helper_.filename();
+        if (filenames_q_.full())
+        {
+            auto old_filename = std::move(filenames_q_.front());
+            filenames_q_.pop_front();
+            bool ok = remove_if_exists(old_filename) == 0;
+            if (!ok)
+            {
+                filenames_q_.push_back(std::move(current_file));
+                throw_spdlog_ex("Failed removing interval file " + filename_to_str(old_filename), errno);
+            }
+        }
+        filenames_q_.push_back(std::move(current_file));
+    }
+
+    filename_t filename_template_;
+    log_clock::duration interval_;
+    log_clock::time_point interval_start_;
+    log_clock::rep rotation_ticks_; // next rotation time, as ticks since epoch
+    details::file_helper file_helper_;
+    bool truncate_;
+    uint16_t max_files_;
+    details::circular_q<filename_t> filenames_q_;
+    details::rotation_hook rotation_hook_;
+};
+
+using interval_file_sink_mt = interval_file_sink<std::mutex>;
+using interval_file_sink_st = interval_file_sink<details::null_mutex>;
+
+} // namespace sinks
+
+//
+// factory functions
+//
+template<typename Factory = spdlog::synchronous_factory>
+inline std::shared_ptr<logger> interval_logger_mt(const std::string &logger_name, const filename_t &filename_template,
+    log_clock::duration interval, bool truncate = false, uint16_t max_files = 0)
+{
+    return Factory::template create<sinks::interval_file_sink_mt>(logger_name, filename_template, interval, truncate, max_files);
+}
+
+template<typename Factory = spdlog::synchronous_factory>
+inline std::shared_ptr<logger> interval_logger_st(const std::string &logger_name, const filename_t &filename_template,
+    log_clock::duration interval, bool truncate = false, uint16_t max_files = 0)
+{
+    return Factory::template create<sinks::interval_file_sink_st>(logger_name, filename_template, interval, truncate, max_files);
+}
+
+template<typename Factory = spdlog::synchronous_factory>
+inline std::shared_ptr<logger> hourly_logger_mt(
+    const std::string &logger_name, const filename_t &filename_template, bool truncate = false, uint16_t max_files = 0)
+{
+    return interval_logger_mt<Factory>(logger_name, filename_template, std::chrono::hours(1), truncate, max_files);
+}
+
+template<typename Factory = spdlog::synchronous_factory>
+inline std::shared_ptr<logger> hourly_logger_st(
+    const std::string &logger_name, const filename_t &filename_template, bool truncate = false, uint16_t max_files = 0)
+{
+    return interval_logger_st<Factory>(logger_name, filename_template, std::chrono::hours(1), truncate, max_files);
+}
+} // namespace spdlog
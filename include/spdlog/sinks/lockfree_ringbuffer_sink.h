@@ -0,0 +1,317 @@
+// Copyright(c) 2015-present, Gabi Melman & spdlog contributors.
+// Distributed under the MIT License (http://opensource.org/licenses/MIT)
+
+#pragma once
+
+#include "spdlog/sinks/sink.h"
+#include "spdlog/details/log_msg.h"
+#include "spdlog/details/synchronous_factory.h"
+#include "spdlog/pattern_formatter.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace spdlog {
+namespace sinks {
+
+/*
+ * Lock free ring buffer sink (in-memory flight recorder).
+ *
+ * The messages are stored as variable length records in a single preallocated byte arena:
+ * a writer reserves its bytes with one fetch_add on the arena head, copies the record and
+ * publishes its position in an index ring. Writers never take a lock and never allocate.
+ * Messages longer than 1/8 of the arena are truncated.
+ *
+ * Readers (snapshot(), last_formatted()) never block the writers: the arena head is the
+ * sequence of a seqlock. A record is copied, and kept only if the head did not move over it
+ * while it was copied; overwritten records are skipped.
+ */
+class lockfree_ringbuffer_sink final : public sink
+{
+public:
+    // a record of a snapshot. the views refer to the snapshot buffer.
+    struct record
+    {
+        log_clock::time_point time;
+        level::level_enum level;
+        size_t thread_id;
+        const details::callsite *source; // see log_msg::source
+        string_view_t logger_name;
+        string_view_t thread_name;
+        string_view_t payload;
+
+        details::log_msg to_log_msg() const
+        {
+            details::log_msg msg(time, source_loc{}, logger_name, level, payload);
+            msg.source = source;
+            msg.thread_id = thread_id;
+            msg.thread_name = thread_name;
+            return msg;
+        }
+    };
+
+    // reusable snapshot: once its buffers have grown, taking a new snapshot doesn't allocate
+    class snapshot_type
+    {
+    public:
+        const std::vector<record> &records() const
+        {
+            return records_;
+        }
+
+    private:
+        friend class lockfree_ringbuffer_sink;
+        std::vector<uint64_t> positions_;
+        std::vector<size_t> offsets_; // of the copied records in data_, newest first
+        std::vector<char> data_;
+        std::vector<record> records_;
+    };
+
+    // arena_size is rounded up to a power of 2 (at least 4KB)
+    explicit lockfree_ringbuffer_sink(size_t arena_size, std::unique_ptr<spdlog::formatter> formatter = nullptr)
+        : capacity_(round_up_pow2_((std::max)(arena_size, size_t(4096))))
+        , arena_(new char[capacity_])
+        , index_size_(capacity_ / min_record_size)
+        , index_(new std::atomic<uint64_t>[index_size_])
+        , formatter_(formatter ? std::move(formatter) : details::make_unique<spdlog::pattern_formatter>())
+    {
+        std::memset(arena_.get(), 0, capacity_);
+        for (size_t i = 0; i < index_size_; i++)
+        {
+            index_[i].store(empty_slot, std::memory_order_relaxed);
+        }
+    }
+
+    lockfree_ringbuffer_sink(const lockfree_ringbuffer_sink &) = delete;
+    lockfree_ringbuffer_sink &operator=(const lockfree_ringbuffer_sink &) = delete;
+
+    void log(const details::log_msg &msg) override
+    {
+        record_header header;
+        header.time_ns = std::chrono::duration_cast<std::chrono::nanoseconds>(msg.time.time_since_epoch()).count();
+        header.thread_id = static_cast<uint64_t>(msg.thread_id);
+        header.source = msg.source;
+        header.level = static_cast<uint16_t>(msg.level);
+        header.logger_name_size = static_cast<uint16_t>((std::min)(msg.logger_name.size(), size_t(255)));
+        header.thread_name_size = static_cast<uint16_t>((std::min)(msg.thread_name.size(), size_t(255)));
+
+        auto fixed_size = sizeof(record_header) + header.logger_name_size + header.thread_name_size;
+        auto max_payload = capacity_ / 8 > fixed_size ? capacity_ / 8 - fixed_size : 0;
+        header.payload_size = static_cast<uint32_t>((std::min)(msg.payload.size(), max_payload));
+        auto size = fixed_size + header.payload_size;
+        header.size = static_cast<uint32_t>((size + 7) & ~size_t(7));
+
+        // reserve, then write: a reader that copied these bytes sees the new head when it validates
+        auto pos = head_.fetch_add(header.size, std::memory_order_acq_rel);
+        std::atomic_thread_fence(std::memory_order_release);
+        auto at = pos;
+        at = write_(at, &header, sizeof(header));
+        at = write_(at, msg.logger_name.data(), header.logger_name_size);
+        at = write_(at, msg.thread_name.data(), header.thread_name_size);
+        write_(at, msg.payload.data(), header.payload_size);
+
+        auto slot = next_slot_.fetch_add(1, std::memory_order_relaxed);
+        index_[slot & (index_size_ - 1)].store(pos, std::memory_order_release);
+    }
+
+    void flush() override {}
+
+    void set_pattern(const std::string &pattern) override
+    {
+        set_formatter(details::make_unique<spdlog::pattern_formatter>(pattern));
+    }
+
+    // the formatter is used by last_formatted() only (the writers don't format)
+    void set_formatter(std::unique_ptr<spdlog::formatter> sink_formatter) override
+    {
+        std::lock_guard<std::mutex> lock(formatter_mutex_);
+        formatter_ = std::move(sink_formatter);
+    }
+
+    // copy the last lim records (all available if 0), oldest first.
+    void snapshot(snapshot_type &snap, size_t lim = 0) const
+    {
+        snap.positions_.clear();
+        snap.offsets_.clear();
+        snap.data_.clear();
+        snap.records_.clear();
+
+        auto last = next_slot_.load(std::memory_order_acquire);
+        auto n_slots = (std::min)(last, static_cast<uint64_t>(index_size_));
+        for (uint64_t slot = last - n_slots; slot < last; slot++)
+        {
+            auto pos = index_[slot & (index_size_ - 1)].load(std::memory_order_acquire);
+            if (pos != empty_slot)
+            {
+                snap.positions_.push_back(pos);
+            }
+        }
+        std::sort(snap.positions_.begin(), snap.positions_.end());
+        snap.positions_.erase(std::unique(snap.positions_.begin(), snap.positions_.end()), snap.positions_.end());
+
+        // newest first, so the copy stops at the first overwritten record
+        for (auto it = snap.positions_.rbegin(); it != snap.positions_.rend(); ++it)
+        {
+            if (lim > 0 && snap.offsets_.size() == lim)
+            {
+                break;
+            }
+            auto offset = snap.data_.size();
+            if (!copy_record_(*it, snap.data_))
+            {
+                break;
+            }
+            snap.offsets_.push_back(offset);
+        }
+
+        // parse once all the records are copied: data_ doesn't move anymore
+        for (auto it = snap.offsets_.rbegin(); it != snap.offsets_.rend(); ++it)
+        {
+            snap.records_.push_back(parse_record_(snap.data_.data() + *it));
+        }
+    }
+
+    std::vector<std::string> last_formatted(size_t lim = 0)
+    {
+        snapshot_type snap;
+        snapshot(snap, lim);
+        std::vector<std::string> ret;
+        ret.reserve(snap.records().size());
+        std::lock_guard<std::mutex> lock(formatter_mutex_);
+        for (auto &r : snap.records())
+        {
+            memory_buf_t formatted;
+            formatter_->format(r.to_log_msg(), formatted);
+            ret.push_back(fmt::to_string(formatted));
+        }
+        return ret;
+    }
+
+    size_t arena_size() const
+    {
+        return capacity_;
+    }
+
+private:
+    // a power of 2, at most sizeof(record_header)
+    static SPDLOG_CONSTEXPR const size_t min_record_size = 32;
+    static SPDLOG_CONSTEXPR const uint64_t empty_slot = ~uint64_t(0);
+
+    struct record_header
+    {
+        uint32_t size; // including the header and the padding
+        uint32_t payload_size;
+        uint16_t level;
+        uint16_t logger_name_size;
+        uint16_t thread_name_size;
+        uint16_t reserved = 0;
+        int64_t time_ns;
+        uint64_t thread_id;
+        const details::callsite *source;
+    };
+    static_assert(sizeof(record_header) >= min_record_size, "records are at least min_record_size bytes");
+
+    static size_t round_up_pow2_(size_t n)
+    {
+        size_t p = 1;
+        while (p < n)
+        {
+            p <<= 1;
+        }
+        return p;
+    }
+
+    // copy to the arena at the given absolute position (wrapping around), return the next position
+    uint64_t write_(uint64_t pos, const void *src, size_t n)
+    {
+        auto offset = static_cast<size_t>(pos & (capacity_ - 1));
+        auto first = (std::min)(n, capacity_ - offset);
+        std::memcpy(arena_.get() + offset, src, first);
+        std::memcpy(arena_.get(), static_cast<const char *>(src) + first, n - first);
+        return pos + n;
+    }
+
+    void read_(uint64_t pos, void *dest, size_t n) const
+    {
+        auto offset = static_cast<size_t>(pos & (capacity_ - 1));
+        auto first = (std::min)(n, capacity_ - offset);
+        std::memcpy(dest, arena_.get() + offset, first);
+        std::memcpy(static_cast<char *>(dest) + first, arena_.get(), n - first);
+    }
+
+    // no writer reserved the bytes of the record at pos for a new record (seqlock validation).
+    // called after reading the record: the fence orders the reads before the head load.
+    bool still_valid_(uint64_t pos) const
+    {
+        std::atomic_thread_fence(std::memory_order_acquire);
+        return head_.load(std::memory_order_relaxed) - pos <= capacity_;
+    }
+
+    // append the record at pos to dest. return false (dest unchanged) if it was overwritten.
+    bool copy_record_(uint64_t pos, std::vector<char> &dest) const
+    {
+        if (head_.load(std::memory_order_acquire) - pos > capacity_)
+        {
+            return false;
+        }
+        record_header header;
+        read_(pos, &header, sizeof(header));
+        if (!still_valid_(pos) || header.size < sizeof(header) || header.size > capacity_ / 2)
+        {
+            return false;
+        }
+        auto offset = dest.size();
+        dest.resize(offset + header.size);
+        read_(pos, dest.data() + offset, header.size);
+        if (!still_valid_(pos))
+        {
+            dest.resize(offset);
+            return false;
+        }
+        return true;
+    }
+
+    static record parse_record_(const char *p)
+    {
+        record_header header;
+        std::memcpy(&header, p, sizeof(header));
+        const char *names = p + sizeof(header);
+        record r;
+        r.time = log_clock::time_point(std::chrono::duration_cast<log_clock::duration>(std::chrono::nanoseconds(header.time_ns)));
+        r.level = static_cast<level::level_enum>(header.level);
+        r.thread_id = static_cast<size_t>(header.thread_id);
+        r.source = header.source;
+        r.logger_name = string_view_t(names, header.logger_name_size);
+        r.thread_name = string_view_t(names + header.logger_name_size, header.thread_name_size);
+        r.payload = string_view_t(names + header.logger_name_size + header.thread_name_size, header.payload_size);
+        return r;
+    }
+
+    const size_t capacity_;
+    std::unique_ptr<char[]> arena_;
+    const size_t index_size_;
+    std::unique_ptr<std::atomic<uint64_t>[]> index_;
+    std::atomic<uint64_t> head_{0};
+    std::atomic<uint64_t> next_slot_{0};
+
+    std::mutex formatter_mutex_;
+    std::unique_ptr<spdlog::formatter> formatter_;
+};
+
+} // namespace sinks
+
+//
+// factory functions
+//
+template<typename Factory = spdlog::synchronous_factory>
+inline std::shared_ptr<logger> lockfree_ringbuffer_logger(const std::string &logger_name, size_t arena_size)
+{
+    return Factory::template create<sinks::lockfree_ringbuffer_sink>(logger_name, arena_size);
+}
+
+} // namespace spdlog
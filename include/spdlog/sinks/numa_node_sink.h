@@ -0,0 +1,95 @@
+// Copyright(c) 2015-present, Gabi Melman & spdlog contributors.
+// Distributed under the MIT License (http://opensource.org/licenses/MIT)
+
+#pragma once
+
+#include <spdlog/common.h>
+#include <spdlog/details/numa.h>
+#include <spdlog/sinks/sink.h>
+
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+
+// Sink with a target sink per NUMA node: each message goes to the target of the node of the calling CPU.
+//
+// With a per node thread pool (spdlog::init_thread_pool(.., numa_policy::per_node)), the calling thread is
+// the worker bound to the node the message was logged on: each node writes to its own target (e.g. a file per node)
+// and no lock or buffer is shared between the nodes.
+// The messages of node n go to targets[n % targets.size()].
+//
+// flush(), set_pattern() and set_formatter() apply to all the targets.
+
+namespace spdlog {
+namespace sinks {
+
+class numa_node_sink final : public sink
+{
+public:
+    explicit numa_node_sink(std::vector<sink_ptr> targets)
+        : targets_(std::move(targets))
+    {
+        if (targets_.empty())
+        {
+            throw_spdlog_ex("numa_node_sink: no target sink");
+        }
+    }
+
+    // a target per node of this machine, created by make_target(node)
+    explicit numa_node_sink(const std::function<sink_ptr(size_t node)> &make_target)
+    {
+        for (size_t node = 0; node < topology_.nodes_count(); node++)
+        {
+            targets_.push_back(make_target(node));
+        }
+    }
+
+    numa_node_sink(const numa_node_sink &) = delete;
+    numa_node_sink &operator=(const numa_node_sink &) = delete;
+
+    void log(const details::log_msg &msg) override
+    {
+        auto &target = targets_[topology_.current_node() % targets_.size()];
+        if (target->should_log(msg.level))
+        {
+            target->log(msg);
+        }
+    }
+
+    void flush() override
+    {
+        for (auto &target : targets_)
+        {
+            target->flush();
+        }
+    }
+
+    void set_pattern(const std::string &pattern) override
+    {
+        for (auto &target : targets_)
+        {
+            target->set_pattern(pattern);
+        }
+    }
+
+    void set_formatter(std::unique_ptr<spdlog::formatter> sink_formatter) override
+    {
+        for (auto &target : targets_)
+        {
+            target->set_formatter(sink_formatter->clone());
+        }
+    }
+
+    const std::vector<sink_ptr> &targets() const
+    {
+        return targets_;
+    }
+
+private:
+    const details::numa_topology &topology_ = details::numa_topology::instance();
+    std::vector<sink_ptr> targets_;
+};
+
+} // namespace sinks
+} // namespace spdlog
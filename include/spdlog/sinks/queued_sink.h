@@ -0,0 +1,153 @@
+// Copyright(c) 2015-present, Gabi Melman & spdlog contributors.
+// Distributed under the MIT License (http://opensource.org/licenses/MIT)
+
+#pragma once
+
+#include <spdlog/common.h>
+#include <spdlog/async_logger.h>
+#include <spdlog/details/mpmc_blocking_q.h>
+#include <spdlog/details/thread_pool.h>
+#include <spdlog/sinks/sink.h>
+
+#include <atomic>
+#include <memory>
+#include <string>
+#include <thread>
+
+// Sink with its own bounded queue and worker thread (parallel sink fan-out).
+//
+// log() copies the message to the queue and returns; the worker thread passes it to the target sink.
+// When each sink of an async logger is wrapped in a queued_sink, the sinks progress concurrently:
+// a slow sink (tcp, syslog..) backs up its own queue only, instead of delaying the other sinks
+// and the following messages in the thread pool.
+// When the queue is full, log() blocks or discards the oldest message, depending on the sink's overflow policy.
+// flush() is queued too, so it runs after the messages logged before it.
+//
+// The target is called by the worker thread, and by set_pattern()/set_formatter() from the calling thread:
+// it should be a _mt sink.
+
+namespace spdlog {
+namespace sinks {
+
+class queued_sink final : public sink
+{
+public:
+    queued_sink(sink_ptr target, size_t queue_size, async_overflow_policy overflow_policy = async_overflow_policy::block)
+        : target_(std::move(target))
+        , overflow_policy_(overflow_policy)
+        , q_(queue_size)
+    {
+        worker_ = std::thread([this] { worker_loop_(); });
+    }
+
+    // log the remaining messages, then stop the worker
+    ~queued_sink() override
+    {
+        SPDLOG_TRY
+        {
+            q_.enqueue(details::async_msg(details::async_msg_type::terminate));
+            worker_.join();
+        }
+        SPDLOG_CATCH_ALL() {}
+    }
+
+    queued_sink(const queued_sink &) = delete;
+    queued_sink &operator=(const queued_sink &) = delete;
+
+    // the messages below the level of the target are not queued
+    void log(const details::log_msg &msg) override
+    {
+        if (target_->should_log(msg.level))
+        {
+            post_(details::async_msg(nullptr, details::async_msg_type::log, msg));
+        }
+    }
+
+    void flush() override
+    {
+        post_(details::async_msg(details::async_msg_type::flush));
+    }
+
+    void set_pattern(const std::string &pattern) override
+    {
+        target_->set_pattern(pattern);
+    }
+
+    void set_formatter(std::unique_ptr<spdlog::formatter> sink_formatter) override
+    {
+        target_->set_formatter(std::move(sink_formatter));
+    }
+
+    const sink_ptr &target() const
+    {
+        return target_;
+    }
+
+    // messages discarded by the overrun_oldest policy
+    size_t dropped()
+    {
+        return q_.overrun_counter();
+    }
+
+    // messages passed to the target
+    size_t logged() const
+    {
+        return logged_.load(std::memory_order_relaxed);
+    }
+
+private:
+    void post_(details::async_msg &&msg)
+    {
+        if (overflow_policy_ == async_overflow_policy::block)
+        {
+            q_.enqueue(std::move(msg));
+        }
+        else
+        {
+            q_.enqueue_nowait(std::move(msg));
+        }
+    }
+
+    void worker_loop_()
+    {
+        details::async_msg msg;
+        for (;;)
+        {
+            if (!q_.dequeue_for(msg, std::chrono::seconds(10)))
+            {
+                continue;
+            }
+            switch (msg.msg_type)
+            {
+            case details::async_msg_type::log:
+                SPDLOG_TRY
+                {
+                    target_->log(msg);
+                }
+                SPDLOG_CATCH_ALL() {} // the error can't be reported to the logger from here
+                logged_.fetch_add(1, std::memory_order_relaxed);
+                break;
+            case details::async_msg_type::flush:
+                SPDLOG_TRY
+                {
+                    target_->flush();
+                }
+                SPDLOG_CATCH_ALL() {}
+                break;
+            case details::async_msg_type::terminate:
+                return;
+            default:
+                break;
+            }
+        }
+    }
+
+    sink_ptr target_;
+    async_overflow_policy overflow_policy_;
+    details::mpmc_blocking_queue<details::async_msg> q_;
+    std::atomic<size_t> logged_{0};
+    std::thread worker_;
+};
+
+} // namespace sinks
+} // namespace spdlog
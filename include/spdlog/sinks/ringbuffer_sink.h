@@ -58,7 +58,7 @@ public:
 protected:
     void sink_it_(const details::log_msg &msg) override
     {
-        q_.push_back(details::log_msg_buffer{msg});
+        q_.push_back_with([&msg](details::log_msg_buffer &slot) { slot.assign(msg); });
     }
     void flush_() override {}
 
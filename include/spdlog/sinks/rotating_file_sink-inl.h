@@ -38,6 +38,21 @@ SPDLOG_INLINE rotating_file_sink<Mutex>::rotating_file_sink(
     }
 }
 
+template<typename Mutex>
+SPDLOG_INLINE rotating_file_sink<Mutex>::~rotating_file_sink()
+{
+    // complete the pending rotations first
+    rotation_worker_.reset();
+
+    // the pre-created file is empty and no longer needed
+    std::lock_guard<std::mutex> lock(next_file_mutex_);
+    if (!next_file_.filename().empty())
+    {
+        next_file_.close();
+        (void)details::os::remove(next_file_.filename());
+    }
+}
+
 // calc filename according to index and file extension if exists.
 // e.g. calc_filename("logs/mylog.txt, 3) => "logs/mylog.3.txt".
 template<typename Mutex>
@@ -60,10 +75,38 @@ SPDLOG_INLINE filename_t rotating_file_sink<Mutex>::filename()
     return file_helper_.filename();
 }
 
+template<typename Mutex>
+SPDLOG_INLINE void rotating_file_sink<Mutex>::set_rotation_hook(details::rotation_hook hook)
+{
+    std::lock_guard<Mutex> lock(base_sink<Mutex>::mutex_);
+    rotation_hook_ = std::move(hook);
+}
+
+template<typename Mutex>
+SPDLOG_INLINE void rotating_file_sink<Mutex>::enable_async_rotation(bool precreate_next_file)
+{
+#ifdef _WIN32
+    (void)precreate_next_file;
+#else
+    std::lock_guard<Mutex> lock(base_sink<Mutex>::mutex_);
+    if (rotation_worker_)
+    {
+        return;
+    }
+    precreate_next_ = precreate_next_file;
+    rotation_worker_ = details::make_unique<details::task_worker>();
+    if (precreate_next_)
+    {
+        rotation_worker_->post([this]() { this->precreate_next_file_(); });
+    }
+#endif
+}
+
 template<typename Mutex>
 SPDLOG_INLINE void rotating_file_sink<Mutex>::sink_it_(const details::log_msg &msg)
 {
-    memory_buf_t formatted;
+    details::thread_buffer formatted_buf(details::thread_buffer::sink);
+    auto &formatted = formatted_buf.get();
     base_sink<Mutex>::formatter_->format(msg, formatted);
     current_size_ += formatted.size();
     if (current_size_ > max_size_)
@@ -80,6 +123,21 @@ SPDLOG_INLINE void rotating_file_sink<Mutex>::flush_()
     file_helper_.flush();
 }
 
+#ifndef CEP_SPDLOG_MODIFIED
+template<typename Mutex>
+SPDLOG_INLINE void rotating_file_sink<Mutex>::enable_durability(std::chrono::microseconds window)
+{
+    std::lock_guard<Mutex> lock(base_sink<Mutex>::mutex_);
+    file_helper_.enable_group_commit(window);
+}
+
+template<typename Mutex>
+SPDLOG_INLINE void rotating_file_sink<Mutex>::after_sink_it_()
+{
+    file_helper_.wait_durable();
+}
+#endif
+
 // Rotate files:
 // log.txt -> log.1.txt
 // log.1.txt -> log.2.txt
@@ -89,16 +147,46 @@ template<typename Mutex>
 SPDLOG_INLINE void rotating_file_sink<Mutex>::rotate_()
 {
     using details::os::filename_to_str;
-    using details::os::path_exists;
+    if (rotation_hook_)
+    {
+        file_helper_.close();
+        rotate_to_hook_();
+        return;
+    }
+    if (rotation_worker_)
+    {
+        if (rotate_async_())
+        {
+            return;
+        }
+        rotation_worker_->wait_idle(); // don't race with the pending cascades
+    }
     file_helper_.close();
-    for (auto i = max_files_; i > 0; --i)
+    filename_t failed_src, failed_target;
+    if (!shift_files(base_filename_, max_files_, failed_src, failed_target))
     {
-        filename_t src = calc_filename(base_filename_, i - 1);
+        auto rename_errno = errno;
+        file_helper_.reopen(true); // truncate the log file anyway to prevent it to grow beyond its limit!
+        current_size_ = 0;
+        throw_spdlog_ex(
+            "rotating_file_sink: failed renaming " + filename_to_str(failed_src) + " to " + filename_to_str(failed_target), rename_errno);
+    }
+    file_helper_.reopen(true);
+}
+
+template<typename Mutex>
+SPDLOG_INLINE bool rotating_file_sink<Mutex>::shift_files(
+    const filename_t &base_filename, std::size_t max_files, filename_t &failed_src, filename_t &failed_target)
+{
+    using details::os::path_exists;
+    for (auto i = max_files; i > 0; --i)
+    {
+        filename_t src = calc_filename(base_filename, i - 1);
         if (!path_exists(src))
         {
             continue;
         }
-        filename_t target = calc_filename(base_filename_, i);
+        filename_t target = calc_filename(base_filename, i);
 
         if (!rename_file_(src, target))
         {
@@ -108,13 +196,118 @@ SPDLOG_INLINE void rotating_file_sink<Mutex>::rotate_()
             details::os::sleep_for_millis(100);
             if (!rename_file_(src, target))
             {
-                file_helper_.reopen(true); // truncate the log file anyway to prevent it to grow beyond its limit!
-                current_size_ = 0;
-                throw_spdlog_ex("rotating_file_sink: failed renaming " + filename_to_str(src) + " to " + filename_to_str(target), errno);
+                failed_src = std::move(src);
+                failed_target = std::move(target);
+                return false;
             }
         }
     }
+    return true;
+}
+
+template<typename Mutex>
+SPDLOG_INLINE void rotating_file_sink<Mutex>::rotate_to_hook_()
+{
+    using details::os::filename_to_str;
+
+    filename_t basename, ext;
+    std::tie(basename, ext) = details::file_helper::split_by_extension(base_filename_);
+    auto now_tm = details::os::localtime();
+    filename_t target = fmt::format(SPDLOG_FILENAME_T("{}_{:04d}-{:02d}-{:02d}_{:02d}-{:02d}-{:02d}.{}{}"), basename, now_tm.tm_year + 1900,
+        now_tm.tm_mon + 1, now_tm.tm_mday, now_tm.tm_hour, now_tm.tm_min, now_tm.tm_sec, ++rotation_seq_, ext);
+
+    if (!rename_file_(base_filename_, target))
+    {
+        details::os::sleep_for_millis(100);
+        if (!rename_file_(base_filename_, target))
+        {
+            file_helper_.reopen(true); // truncate the log file anyway to prevent it to grow beyond its limit!
+            current_size_ = 0;
+            throw_spdlog_ex(
+                "rotating_file_sink: failed renaming " + filename_to_str(base_filename_) + " to " + filename_to_str(target), errno);
+        }
+    }
     file_helper_.reopen(true);
+    rotation_hook_(target);
+}
+
+template<typename Mutex>
+SPDLOG_INLINE bool rotating_file_sink<Mutex>::rotate_async_()
+{
+    filename_t basename, ext;
+    std::tie(basename, ext) = details::file_helper::split_by_extension(base_filename_);
+    filename_t pending_filename = fmt::format(SPDLOG_FILENAME_T("{}.rotating-{}{}"), basename, ++rotation_seq_, ext);
+
+    // move the full file out of the way. it stays open, so a failure here leaves everything as it was.
+    if (!file_helper_.rename(pending_filename))
+    {
+        return false;
+    }
+
+    // switch to the pre-created file if ready, or create a new one
+    details::file_helper full_file;
+    {
+        std::lock_guard<std::mutex> lock(next_file_mutex_);
+        if (!next_file_.filename().empty() && next_file_.rename(base_filename_))
+        {
+            file_helper_.swap(next_file_);
+            next_file_.swap(full_file);
+        }
+    }
+    if (full_file.filename().empty())
+    {
+        file_helper_.open(base_filename_, true);
+    }
+
+    rotation_worker_->post([this, pending_filename]() { this->shift_files_(pending_filename); });
+    if (precreate_next_)
+    {
+        rotation_worker_->post([this]() { this->precreate_next_file_(); });
+    }
+    return true;
+}
+
+// Runs in the rotation worker:
+// log.2.txt -> log.3.txt
+// log.1.txt -> log.2.txt
+// log.rotating-N.txt -> log.1.txt
+template<typename Mutex>
+SPDLOG_INLINE void rotating_file_sink<Mutex>::shift_files_(const filename_t &pending_filename)
+{
+    using details::os::path_exists;
+    for (auto i = max_files_; i > 1; --i)
+    {
+        filename_t src = calc_filename(base_filename_, i - 1);
+        if (!path_exists(src))
+        {
+            continue;
+        }
+        filename_t target = calc_filename(base_filename_, i);
+        if (!rename_file_(src, target))
+        {
+            details::os::sleep_for_millis(100);
+            (void)rename_file_(src, target);
+        }
+    }
+
+    if (max_files_ == 0 || !rename_file_(pending_filename, calc_filename(base_filename_, 1)))
+    {
+        // no room for it: delete it to prevent the logs to grow beyond their limit.
+        (void)details::os::remove(pending_filename);
+    }
+}
+
+// Runs in the rotation worker
+template<typename Mutex>
+SPDLOG_INLINE void rotating_file_sink<Mutex>::precreate_next_file_()
+{
+    filename_t basename, ext;
+    std::tie(basename, ext) = details::file_helper::split_by_extension(base_filename_);
+
+    details::file_helper next_file;
+    next_file.open(fmt::format(SPDLOG_FILENAME_T("{}.next{}"), basename, ext), true);
+    std::lock_guard<std::mutex> lock(next_file_mutex_);
+    next_file_.swap(next_file);
 }
 
 // delete the target if exists, and rename the src file  to target
@@ -4,11 +4,14 @@
 #pragma once
 
 #include <spdlog/sinks/base_sink.h>
+#include <spdlog/details/file_archiver.h>
 #include <spdlog/details/file_helper.h>
 #include <spdlog/details/null_mutex.h>
 #include <spdlog/details/synchronous_factory.h>
+#include <spdlog/details/task_worker.h>
 
 #include <chrono>
+#include <memory>
 #include <mutex>
 #include <string>
 
@@ -18,17 +21,48 @@ namespace sinks {
 //
 // Rotating file sink based on size
 //
+// If a rotation hook is set (e.g. details::file_archiver::make_hook()), each rotated file is renamed
+// to a unique name (log.txt -> log_YYYY-MM-DD_hh-mm-ss.N.txt) and handed over to the hook, which owns it
+// from then on. max_files is not used in this case.
+//
+// If async rotation is enabled, the logging thread only switches to a new file (renaming the full one
+// to log.rotating-N.txt) and the rename cascade is performed by a background thread.
+// With precreate_next_file, the next file (log.next.txt) is created in advance by the background thread,
+// so the switch costs two renames and no open.
+//
 template<typename Mutex>
 class rotating_file_sink final : public base_sink<Mutex>
 {
 public:
     rotating_file_sink(filename_t base_filename, std::size_t max_size, std::size_t max_files, bool rotate_on_open = false);
+    ~rotating_file_sink() override;
     static filename_t calc_filename(const filename_t &filename, std::size_t index);
     filename_t filename();
+    void set_rotation_hook(details::rotation_hook hook);
+
+    // Rename log.txt -> log.1.txt -> ... -> log.<max_files>.txt, deleting the last one (the files must be closed).
+    // Return false if a rename failed even after a retry, and set failed_src and failed_target to its names.
+    // Also used by compressed_rotating_file_sink.
+    static bool shift_files(
+        const filename_t &base_filename, std::size_t max_files, filename_t &failed_src, filename_t &failed_target);
+
+    // Perform the rename cascade in a background thread (see above).
+    // Not supported under windows (open files cannot be renamed), where rotation stays synchronous.
+    void enable_async_rotation(bool precreate_next_file = true);
+
+#ifndef CEP_SPDLOG_MODIFIED
+    // Durable mode (group commit): log() returns once the message is on disk (fdatasync).
+    // The messages logged by other threads meanwhile are written and synced together, a window > 0 makes
+    // the groups larger at the cost of latency (see details/group_commit.h). Call it before logging.
+    void enable_durability(std::chrono::microseconds window = std::chrono::microseconds::zero());
+#endif
 
 protected:
     void sink_it_(const details::log_msg &msg) override;
     void flush_() override;
+#ifndef CEP_SPDLOG_MODIFIED
+    void after_sink_it_() override;
+#endif
 
 private:
     // Rotate files:
@@ -38,15 +72,34 @@ private:
     // log.3.txt -> delete
     void rotate_();
 
+    // rename the current file to a unique name and pass it to the rotation hook.
+    void rotate_to_hook_();
+
+    // switch to a new file and post the rename cascade to the rotation worker.
+    // return false if the switch failed, in which case the caller rotates synchronously.
+    bool rotate_async_();
+
+    // rotation worker tasks
+    void shift_files_(const filename_t &pending_filename);
+    void precreate_next_file_();
+
     // delete the target if exists, and rename the src file  to target
     // return true on success, false otherwise.
-    bool rename_file_(const filename_t &src_filename, const filename_t &target_filename);
+    static bool rename_file_(const filename_t &src_filename, const filename_t &target_filename);
 
     filename_t base_filename_;
     std::size_t max_size_;
     std::size_t max_files_;
     std::size_t current_size_;
     details::file_helper file_helper_;
+    details::rotation_hook rotation_hook_;
+    std::size_t rotation_seq_ = 0;
+
+    // async rotation
+    bool precreate_next_ = false;
+    std::mutex next_file_mutex_; // protects next_file_ (shared with the rotation worker)
+    details::file_helper next_file_;
+    std::unique_ptr<details::task_worker> rotation_worker_; // must be last, so its tasks complete before the other members are destroyed
 };
 
 using rotating_file_sink_mt = rotating_file_sink<std::mutex>;
@@ -17,9 +17,30 @@ SPDLOG_INLINE bool spdlog::sinks::sink::should_log(spdlog::level::level_enum msg
 SPDLOG_INLINE void spdlog::sinks::sink::set_level(level::level_enum log_level)
 {
     level_.store(log_level, std::memory_order_relaxed);
+    levels_epoch().fetch_add(1, std::memory_order_release);
 }
 
 SPDLOG_INLINE spdlog::level::level_enum spdlog::sinks::sink::level() const
 {
     return static_cast<spdlog::level::level_enum>(level_.load(std::memory_order_relaxed));
 }
+
+SPDLOG_INLINE std::atomic<uint64_t> &spdlog::sinks::sink::levels_epoch()
+{
+    // starts at 1: 0 is the epoch of a logger that never computed its minimum sink level
+    static std::atomic<uint64_t> epoch{1};
+    return epoch;
+}
+
+SPDLOG_INLINE void spdlog::sinks::sink::set_max_unflushed_bytes(size_t max_bytes)
+{
+    max_unflushed_bytes_.store(max_bytes, std::memory_order_relaxed);
+}
+
+SPDLOG_INLINE void spdlog::sinks::sink::flush_tracked()
+{
+    // data written during the flush stays dirty
+    auto written = written_bytes_.load(std::memory_order_relaxed);
+    flush();
+    flushed_bytes_.store(written, std::memory_order_relaxed);
+}
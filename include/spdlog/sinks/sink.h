@@ -4,6 +4,7 @@
 #pragma once
 
 #include <spdlog/details/log_msg.h>
+#include <spdlog/details/profiler.h>
 #include <spdlog/formatter.h>
 
 namespace spdlog {
@@ -22,9 +23,55 @@ public:
     level::level_enum level() const;
     bool should_log(level::level_enum msg_level) const;
 
+    // incremented when the level of a sink changes, so loggers recompute their minimum sink level
+    static std::atomic<uint64_t> &levels_epoch();
+
+    // Unflushed data, counted by the loggers (payload size + 1 per message, so empty messages count) and used by the flush scheduler
+    // (see spdlog::flush_every(logger, interval)) to flush dirty sinks only.
+    // A sink written since its last flush_tracked() is never seen as clean.
+    bool dirty() const
+    {
+        return written_bytes_.load(std::memory_order_relaxed) != flushed_bytes_.load(std::memory_order_relaxed);
+    }
+
+    size_t unflushed_bytes() const
+    {
+        auto written = written_bytes_.load(std::memory_order_relaxed);
+        return static_cast<size_t>(written - flushed_bytes_.load(std::memory_order_relaxed));
+    }
+
+    // flush as soon as max_bytes are unflushed (0 - the default - means no limit)
+    void set_max_unflushed_bytes(size_t max_bytes);
+
+    // called by the loggers after log(). returns true if the sink should be flushed now (max_unflushed_bytes reached)
+    bool count_written(size_t bytes)
+    {
+        // read-modify-write: several loggers (threads) may share the sink, and this is called outside of its mutex
+        auto written = written_bytes_.fetch_add(bytes + 1, std::memory_order_relaxed) + bytes + 1;
+        auto max_bytes = max_unflushed_bytes_.load(std::memory_order_relaxed);
+        return max_bytes != 0 && written - flushed_bytes_.load(std::memory_order_relaxed) >= max_bytes;
+    }
+
+    // flush(), and mark the data counted so far as flushed
+    void flush_tracked();
+
+#ifdef SPDLOG_ENABLE_PROFILING
+    // cycles spent in the pattern_format and sink_write stages of this sink (see details/profiler.h)
+    details::profiling::stage_profile &profile()
+    {
+        return profile_;
+    }
+#endif
+
 protected:
     // sink log level - default is all
     level_t level_{level::trace};
+    std::atomic<uint64_t> written_bytes_{0};
+    std::atomic<uint64_t> flushed_bytes_{0};
+    std::atomic<size_t> max_unflushed_bytes_{0};
+#ifdef SPDLOG_ENABLE_PROFILING
+    details::profiling::stage_profile profile_;
+#endif
 };
 
 } // namespace sinks
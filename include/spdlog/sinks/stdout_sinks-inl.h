@@ -8,8 +8,10 @@
 #endif
 
 #include <spdlog/details/console_globals.h>
+#include <spdlog/details/thread_buffer.h>
 #include <spdlog/pattern_formatter.h>
 #include <memory>
+#include <type_traits>
 
 namespace spdlog {
 
@@ -29,9 +31,26 @@ SPDLOG_INLINE stdout_sink_base
     ,
 #endif
     file_(file)
+    , buffer_(file)
     , formatter_(details::make_unique<spdlog::pattern_formatter>())
 {}
 
+#ifndef CEP_SPDLOG_MODIFIED
+template<typename ConsoleMutex>
+#endif
+SPDLOG_INLINE stdout_sink_base
+#ifndef CEP_SPDLOG_MODIFIED
+    <ConsoleMutex>
+#endif
+    ::~stdout_sink_base()
+{
+#ifndef CEP_SPDLOG_MODIFIED
+    flusher_.reset();
+    deliverer_.reset();
+#endif
+    flush();
+}
+
 #ifndef CEP_SPDLOG_MODIFIED
 template<typename ConsoleMutex>
 #endif
@@ -46,21 +65,27 @@ SPDLOG_INLINE void stdout_sink_base
     cep::Lock_Guard lock{mutex_};
 #endif
 #else
-    std::lock_guard<std::mutex> lock(mutex_t);
+    std::lock_guard<mutex_t> lock(mutex_);
 #endif
-    memory_buf_t formatted;
+    SPDLOG_PROFILE_SINK_SCOPE(profile_);
+    details::thread_buffer formatted_buf(details::thread_buffer::sink);
+    auto &formatted = formatted_buf.get();
     formatter_->format(msg, formatted);
 
+    if (batches_)
+    {
+        batches_->push(string_view_t(formatted.data(), formatted.size()));
+    }
 #ifdef CEP_SPDLOG_MODIFIED
-    if (custom_log_handler_)
+    else if (custom_log_handler_)
     {
         custom_log_handler_(formatted);
     }
-    else
 #endif
+    else
     {
-        fwrite(formatted.data(), sizeof(char), formatted.size(), file_);
-        fflush(file_); // flush every line to terminal
+        buffer_.buf().append(formatted.data(), formatted.data() + formatted.size());
+        buffer_.line_done();
     }
 }
 
@@ -80,14 +105,57 @@ SPDLOG_INLINE void stdout_sink_base
 #endif
     ::flush()
 {
+    {
 #ifdef CEP_SPDLOG_MODIFIED
 #ifdef CEP_SPDLOG_USE_MUTEX
-    cep::Lock_Guard lock{mutex_};
+        cep::Lock_Guard lock{mutex_};
 #endif
 #else
-    std::lock_guard<std::mutex> lock(mutex_t);
+        std::lock_guard<mutex_t> lock(mutex_);
+#endif
+        buffer_.flush();
+    }
+    deliver_batches();
+}
+
+#ifndef CEP_SPDLOG_MODIFIED
+template<typename ConsoleMutex>
+#endif
+SPDLOG_INLINE void stdout_sink_base
+#ifndef CEP_SPDLOG_MODIFIED
+    <ConsoleMutex>
+#endif
+    ::set_buffering(console_buffering mode, std::chrono::milliseconds max_latency, size_t block_size)
+{
+#ifndef CEP_SPDLOG_MODIFIED
+    // stop the previous flusher first: it takes the mutex
+    flusher_.reset();
+#endif
+    bool block_mode;
+    {
+#ifdef CEP_SPDLOG_MODIFIED
+#ifdef CEP_SPDLOG_USE_MUTEX
+        cep::Lock_Guard lock{mutex_};
+#endif
+#else
+        std::lock_guard<mutex_t> lock(mutex_);
+#endif
+        buffer_.set_mode(mode, max_latency, block_size);
+        block_mode = buffer_.block_mode();
+    }
+#ifndef CEP_SPDLOG_MODIFIED
+    if (block_mode && !std::is_same<mutex_t, details::null_mutex>::value)
+    {
+        flusher_ = details::make_unique<details::periodic_worker>(
+            [this]() {
+                std::lock_guard<mutex_t> lock(mutex_);
+                buffer_.flush_pending();
+            },
+            max_latency);
+    }
+#else
+    UNUSED(block_mode);
 #endif
-    fflush(file_);
 }
 
 #ifndef CEP_SPDLOG_MODIFIED
@@ -104,7 +172,7 @@ SPDLOG_INLINE void stdout_sink_base
     cep::Lock_Guard lock{mutex_};
 #endif
 #else
-    std::lock_guard<std::mutex> lock(mutex_t);
+    std::lock_guard<mutex_t> lock(mutex_);
 #endif
     formatter_ = std::unique_ptr<spdlog::formatter>(new pattern_formatter(pattern));
 }
@@ -123,11 +191,157 @@ SPDLOG_INLINE void stdout_sink_base
     cep::Lock_Guard lock{mutex_};
 #endif
 #else
-    std::lock_guard<std::mutex> lock(mutex_t);
+    std::lock_guard<mutex_t> lock(mutex_);
 #endif
     formatter_ = std::move(sink_formatter);
 }
 
+#ifndef CEP_SPDLOG_MODIFIED
+template<typename ConsoleMutex>
+#endif
+SPDLOG_INLINE void stdout_sink_base
+#ifndef CEP_SPDLOG_MODIFIED
+    <ConsoleMutex>
+#endif
+    ::set_batch_handler(batch_log_handler handler, std::chrono::milliseconds interval, size_t max_lines, size_t max_bytes)
+{
+#ifndef CEP_SPDLOG_MODIFIED
+    // stop the previous deliverer first: it takes the mutexes
+    deliverer_.reset();
+#endif
+    bool enabled = static_cast<bool>(handler);
+    {
+#ifdef CEP_SPDLOG_MODIFIED
+#ifdef CEP_SPDLOG_USE_MUTEX
+        cep::Lock_Guard delivery_lock{delivery_mutex_};
+#endif
+#else
+        std::lock_guard<std::mutex> delivery_lock(delivery_mutex_);
+#endif
+        {
+#ifdef CEP_SPDLOG_MODIFIED
+#ifdef CEP_SPDLOG_USE_MUTEX
+            cep::Lock_Guard lock{mutex_};
+#endif
+#else
+            std::lock_guard<mutex_t> lock(mutex_);
+#endif
+            delivering_.clear();
+            if (batches_)
+            {
+                batches_->take(delivering_);
+            }
+            batches_ = enabled ? details::make_unique<details::batch_queue>(max_lines, max_bytes) : nullptr;
+        }
+        // the remaining messages go to the previous handler
+        deliver_(batch_handler_);
+        batch_handler_ = std::move(handler);
+    }
+#ifndef CEP_SPDLOG_MODIFIED
+    if (enabled && !std::is_same<mutex_t, details::null_mutex>::value)
+    {
+        deliverer_ = details::make_unique<details::periodic_worker>([this]() { deliver_batches(); }, interval);
+    }
+#else
+    UNUSED(interval);
+#endif
+}
+
+#ifndef CEP_SPDLOG_MODIFIED
+template<typename ConsoleMutex>
+#endif
+SPDLOG_INLINE void stdout_sink_base
+#ifndef CEP_SPDLOG_MODIFIED
+    <ConsoleMutex>
+#endif
+    ::deliver_batches()
+{
+#ifdef CEP_SPDLOG_MODIFIED
+#ifdef CEP_SPDLOG_USE_MUTEX
+    cep::Lock_Guard delivery_lock{delivery_mutex_};
+#endif
+#else
+    std::lock_guard<std::mutex> delivery_lock(delivery_mutex_);
+#endif
+    {
+#ifdef CEP_SPDLOG_MODIFIED
+#ifdef CEP_SPDLOG_USE_MUTEX
+        cep::Lock_Guard lock{mutex_};
+#endif
+#else
+        std::lock_guard<mutex_t> lock(mutex_);
+#endif
+        if (!batches_ || batches_->empty())
+        {
+            return;
+        }
+        batches_->take(delivering_);
+    }
+    // batches_ is replaced under delivery_mutex_ only
+    batches_->add_delivered(delivering_.ends.size());
+    deliver_(batch_handler_);
+}
+
+#ifndef CEP_SPDLOG_MODIFIED
+template<typename ConsoleMutex>
+#endif
+SPDLOG_INLINE size_t stdout_sink_base
+#ifndef CEP_SPDLOG_MODIFIED
+    <ConsoleMutex>
+#endif
+    ::dropped_messages()
+{
+#ifdef CEP_SPDLOG_MODIFIED
+#ifdef CEP_SPDLOG_USE_MUTEX
+    cep::Lock_Guard lock{mutex_};
+#endif
+#else
+    std::lock_guard<mutex_t> lock(mutex_);
+#endif
+    return batches_ ? batches_->dropped() : 0;
+}
+
+#ifndef CEP_SPDLOG_MODIFIED
+template<typename ConsoleMutex>
+#endif
+SPDLOG_INLINE size_t stdout_sink_base
+#ifndef CEP_SPDLOG_MODIFIED
+    <ConsoleMutex>
+#endif
+    ::delivered_messages()
+{
+#ifdef CEP_SPDLOG_MODIFIED
+#ifdef CEP_SPDLOG_USE_MUTEX
+    cep::Lock_Guard lock{mutex_};
+#endif
+#else
+    std::lock_guard<mutex_t> lock(mutex_);
+#endif
+    return batches_ ? batches_->delivered() : 0;
+}
+
+// called under delivery_mutex_
+#ifndef CEP_SPDLOG_MODIFIED
+template<typename ConsoleMutex>
+#endif
+SPDLOG_INLINE void stdout_sink_base
+#ifndef CEP_SPDLOG_MODIFIED
+    <ConsoleMutex>
+#endif
+    ::deliver_(const batch_log_handler &handler)
+{
+    if (!handler || (delivering_.ends.empty() && delivering_.dropped == 0))
+    {
+        return;
+    }
+    delivering_.to_batch(batch_);
+    SPDLOG_TRY
+    {
+        handler(batch_);
+    }
+    SPDLOG_CATCH_ALL() {} // the handler reports its own errors, never let it kill the delivering thread
+}
+
 // stdout sink
 #ifndef CEP_SPDLOG_MODIFIED
 template<typename ConsoleMutex>
@@ -3,10 +3,17 @@
 
 #pragma once
 
+#include <spdlog/details/batch_queue.h>
+#include <spdlog/details/console_buffer.h>
 #include <spdlog/details/console_globals.h>
 #include <spdlog/details/synchronous_factory.h>
 #include <spdlog/sinks/sink.h>
+#ifndef CEP_SPDLOG_MODIFIED
+#include <spdlog/details/periodic_worker.h>
+#endif
+#include <chrono>
 #include <cstdio>
+#include <mutex>
 
 namespace spdlog {
 
@@ -27,7 +34,7 @@ public:
 #endif
 
     explicit stdout_sink_base(FILE *file);
-    ~stdout_sink_base() override = default;
+    ~stdout_sink_base() override;
 
     stdout_sink_base(const stdout_sink_base &other) = delete;
     stdout_sink_base(stdout_sink_base &&other) = delete;
@@ -41,6 +48,27 @@ public:
 
     void set_formatter(std::unique_ptr<spdlog::formatter> sink_formatter) override;
 
+    // Line (default) or block buffering (see console_buffering).
+    // In block mode the mt sinks flush the pending messages every max_latency from a background thread,
+    // the st sinks on the next message only.
+    void set_buffering(console_buffering mode, std::chrono::milliseconds max_latency = std::chrono::milliseconds(100),
+        size_t block_size = details::console_buffer::default_block_size);
+
+    // Deliver the formatted messages in batches to handler (on another thread) instead of writing them to the file.
+    // At most max_lines / max_bytes are queued between deliveries, the messages that don't fit are dropped and counted.
+    // The batches are delivered every interval from a background thread (in the modified build, which has no
+    // background threads, by the application calling deliver_batches()), and on flush().
+    // A null handler restores the normal output.
+    void set_batch_handler(batch_log_handler handler, std::chrono::milliseconds interval = std::chrono::milliseconds(50),
+        size_t max_lines = 4096, size_t max_bytes = 1024 * 1024);
+
+    // deliver the queued messages to the batch handler on the calling thread
+    void deliver_batches();
+
+    // totals since the batch handler was set
+    size_t dropped_messages();
+    size_t delivered_messages();
+
 #ifdef CEP_SPDLOG_MODIFIED
     void set_custom_logger(log_handler custom_log_handler);
 #endif
@@ -57,7 +85,27 @@ protected:
     log_handler custom_log_handler_;
 #endif
     FILE *file_;
+    details::console_buffer buffer_;
     std::unique_ptr<spdlog::formatter> formatter_;
+#ifndef CEP_SPDLOG_MODIFIED
+    std::unique_ptr<details::periodic_worker> flusher_;
+#endif
+
+    // batch delivery: the queue is guarded by mutex_, the handler and the delivered batch by delivery_mutex_
+    // (always taken before mutex_).
+    void deliver_(const batch_log_handler &handler);
+    std::unique_ptr<details::batch_queue> batches_;
+    batch_log_handler batch_handler_;
+    details::batch_queue::storage delivering_;
+    log_batch batch_;
+#ifdef CEP_SPDLOG_MODIFIED
+#ifdef CEP_SPDLOG_USE_MUTEX
+    cep::Mutex delivery_mutex_;
+#endif
+#else
+    std::mutex delivery_mutex_;
+    std::unique_ptr<details::periodic_worker> deliverer_;
+#endif
 };
 
 #ifndef CEP_SPDLOG_MODIFIED
@@ -57,7 +57,7 @@ protected:
         }
 
         // Do not send source location if not available
-        if (msg.source.empty())
+        if (msg.source == nullptr)
         {
             // Note: function call inside '()' to avoid macro expansion
             err = (sd_journal_send)("MESSAGE=%.*s", static_cast<int>(length), msg.payload.data(), "PRIORITY=%d", syslog_level(msg.level),
@@ -67,7 +67,7 @@ protected:
         {
             err = (sd_journal_send)("MESSAGE=%.*s", static_cast<int>(length), msg.payload.data(), "PRIORITY=%d", syslog_level(msg.level),
                 "SYSLOG_IDENTIFIER=%.*s", static_cast<int>(msg.logger_name.size()), msg.logger_name.data(), "CODE_FILE=%s",
-                msg.source.filename, "CODE_LINE=%d", msg.source.line, "CODE_FUNC=%s", msg.source.funcname, nullptr);
+                msg.source->filename(), "CODE_LINE=%d", msg.source->line(), "CODE_FUNC=%s", msg.source->funcname(), nullptr);
         }
 
         if (err)
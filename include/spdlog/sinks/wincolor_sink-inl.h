@@ -52,6 +52,7 @@ template<typename ConsoleMutex>
 void SPDLOG_INLINE wincolor_sink<ConsoleMutex>::log(const details::log_msg &msg)
 {
     std::lock_guard<mutex_t> lock(mutex_);
+    SPDLOG_PROFILE_SINK_SCOPE(profile_);
     msg.color_range_start = 0;
     msg.color_range_end = 0;
     memory_buf_t formatted;
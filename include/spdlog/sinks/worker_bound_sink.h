@@ -0,0 +1,95 @@
+// Copyright(c) 2015-present, Gabi Melman & spdlog contributors.
+// Distributed under the MIT License (http://opensource.org/licenses/MIT)
+
+#pragma once
+
+#include <spdlog/common.h>
+#include <spdlog/details/thread_pool.h>
+#include <spdlog/sinks/sink.h>
+
+#include <memory>
+#include <string>
+
+// Sink bound to the worker thread of an async thread pool (lock elision for single consumer pipelines).
+//
+// The target sink is used by the single worker thread of the pool only, so it can be a _st sink:
+// the messages of the async loggers of the pool reach it without taking any lock.
+// flush(), set_pattern() and set_formatter() called from other threads are posted to the pool queue
+// as control messages and run by the worker, in order with the messages posted before them
+// (a control message is never discarded, even by a logger of the pool using async_overflow_policy::overrun_oldest).
+//
+// Use it with async loggers of the given pool only: log() must not be called from other threads.
+
+namespace spdlog {
+namespace sinks {
+
+class worker_bound_sink final : public sink
+{
+public:
+    worker_bound_sink(sink_ptr target, const std::shared_ptr<details::thread_pool> &tp)
+        : target_(std::move(target))
+        , thread_pool_(tp)
+    {
+        if (tp->threads_count() != 1)
+        {
+            throw_spdlog_ex("worker_bound_sink: the thread pool must have a single worker thread");
+        }
+    }
+
+    worker_bound_sink(const worker_bound_sink &) = delete;
+    worker_bound_sink &operator=(const worker_bound_sink &) = delete;
+
+    void log(const details::log_msg &msg) override
+    {
+        if (target_->should_log(msg.level))
+        {
+            target_->log(msg);
+        }
+    }
+
+    void flush() override
+    {
+        auto target = target_;
+        run_on_worker_([target] { target->flush(); });
+    }
+
+    void set_pattern(const std::string &pattern) override
+    {
+        auto target = target_;
+        run_on_worker_([target, pattern] { target->set_pattern(pattern); });
+    }
+
+    void set_formatter(std::unique_ptr<spdlog::formatter> sink_formatter) override
+    {
+        // std::function must be copyable
+        auto target = target_;
+        auto formatter = std::make_shared<std::unique_ptr<spdlog::formatter>>(std::move(sink_formatter));
+        run_on_worker_([target, formatter] { target->set_formatter(std::move(*formatter)); });
+    }
+
+    const sink_ptr &target() const
+    {
+        return target_;
+    }
+
+private:
+    // run fn now if called by the worker (or if the pool is gone), post it to the worker otherwise
+    void run_on_worker_(std::function<void()> fn)
+    {
+        auto pool_ptr = thread_pool_.lock();
+        if (!pool_ptr || pool_ptr->is_worker_thread())
+        {
+            fn();
+        }
+        else
+        {
+            pool_ptr->post_control(std::move(fn));
+        }
+    }
+
+    sink_ptr target_;
+    std::weak_ptr<details::thread_pool> thread_pool_;
+};
+
+} // namespace sinks
+} // namespace spdlog
@@ -8,7 +8,11 @@
 #endif
 
 #include <spdlog/common.h>
+#include <spdlog/details/os.h>
 #include <spdlog/pattern_formatter.h>
+#include <spdlog/sinks/sink.h>
+
+#include <algorithm>
 
 namespace spdlog {
 
@@ -22,6 +26,25 @@ SPDLOG_INLINE std::shared_ptr<logger> get(const std::string &name)
     return details::registry::instance().get(name);
 }
 
+SPDLOG_INLINE logger_handle::logger_handle(std::string name)
+    : name_(std::move(name))
+    , generation_(details::registry::instance().generation())
+    , logger_(details::registry::instance().get(name_))
+{}
+
+SPDLOG_INLINE const std::shared_ptr<logger> &logger_handle::get()
+{
+    auto &registry = details::registry::instance();
+    auto generation = registry.generation();
+    if (generation != generation_)
+    {
+        // read the generation before the lookup, so a concurrent change is seen by the next call
+        generation_ = generation;
+        logger_ = registry.get(name_);
+    }
+    return logger_;
+}
+
 SPDLOG_INLINE void set_formatter(std::unique_ptr<spdlog::formatter> formatter)
 {
     details::registry::instance().set_formatter(std::move(formatter));
@@ -62,6 +85,21 @@ SPDLOG_INLINE void flush_every(std::chrono::seconds interval)
     details::registry::instance().flush_every(interval);
 }
 
+SPDLOG_INLINE void flush_every(std::shared_ptr<logger> logger, std::chrono::milliseconds interval)
+{
+    details::registry::instance().flush_every(std::move(logger), interval);
+}
+
+SPDLOG_INLINE void flush_every(sink_ptr sink, std::chrono::milliseconds interval)
+{
+    details::registry::instance().flush_every(std::move(sink), interval, nullptr);
+}
+
+SPDLOG_INLINE void set_clock_source(clock_source source, std::chrono::seconds resync_interval)
+{
+    details::registry::instance().set_clock_source(source, resync_interval);
+}
+
 SPDLOG_INLINE void set_error_handler(void (*handler)(const std::string &msg))
 {
     details::registry::instance().set_error_handler(handler);
@@ -97,6 +135,61 @@ SPDLOG_INLINE void set_automatic_registration(bool automatic_registration)
     details::registry::instance().set_automatic_registration(automatic_registration);
 }
 
+SPDLOG_INLINE void set_thread_name(string_view_t name)
+{
+    details::os::set_thread_name(name);
+}
+
+SPDLOG_INLINE size_t set_callsites_by_file(const std::string &file_glob, bool enabled, level::level_enum max_level)
+{
+    return details::callsite::set_enabled_by_file(file_glob, enabled, max_level);
+}
+
+SPDLOG_INLINE size_t set_callsites_by_function(const std::string &funcname_glob, bool enabled, level::level_enum max_level)
+{
+    return details::callsite::set_enabled_by_function(funcname_glob, enabled, max_level);
+}
+
+SPDLOG_INLINE void reset_callsites()
+{
+    details::callsite::reset_all();
+}
+
+#ifdef SPDLOG_ENABLE_PROFILING
+SPDLOG_INLINE std::string dump_profiles()
+{
+    memory_buf_t buf;
+    std::vector<const sinks::sink *> seen; // sinks shared by several loggers are dumped once
+    details::registry::instance().apply_all([&](const std::shared_ptr<logger> l) {
+        l->profile().dump(l->name(), buf);
+        size_t i = 0;
+        for (auto &s : static_cast<const logger &>(*l).sinks())
+        {
+            if (std::find(seen.begin(), seen.end(), s.get()) == seen.end())
+            {
+                seen.push_back(s.get());
+                s->profile().dump(fmt::format("{}/sink#{}", l->name(), i), buf);
+            }
+            ++i;
+        }
+    });
+    details::profiling::unattributed_profile().dump("unattributed", buf);
+    return fmt::to_string(buf);
+}
+
+SPDLOG_INLINE void reset_profiles()
+{
+    details::registry::instance().apply_all([](const std::shared_ptr<logger> l) {
+        l->profile().reset();
+        for (auto &s : static_cast<const logger &>(*l).sinks())
+        {
+            s->profile().reset();
+        }
+    });
+    details::profiling::unattributed_profile().reset();
+}
+#endif
+
 SPDLOG_INLINE std::shared_ptr<spdlog::logger> default_logger()
 {
     return details::registry::instance().default_logger();
@@ -10,6 +10,7 @@
 #pragma once
 
 #include <spdlog/common.h>
+#include <spdlog/details/callsite.h>
 #include <spdlog/details/registry.h>
 #include <spdlog/logger.h>
 #include <spdlog/version.h>
@@ -51,6 +52,32 @@ SPDLOG_API void initialize_logger(std::shared_ptr<logger> logger);
 // example: spdlog::get("my_logger")->info("hello {}", "world");
 SPDLOG_API std::shared_ptr<logger> get(const std::string &name);
 
+// Cached result of spdlog::get(name), for hot code paths.
+// The lookup is repeated only if loggers were registered or dropped since the previous call,
+// so get() costs a single atomic load most of the time.
+// A handle is not thread safe - each thread should use its own handle.
+// example:
+//   static thread_local spdlog::logger_handle handle("my_logger");
+//   handle->info("hello {}", "world");
+class SPDLOG_API logger_handle
+{
+public:
+    explicit logger_handle(std::string name);
+
+    // Return the logger, or nullptr if a logger with such name doesn't exist.
+    const std::shared_ptr<logger> &get();
+
+    logger *operator->()
+    {
+        return get().get();
+    }
+
+private:
+    std::string name_;
+    uint64_t generation_;
+    std::shared_ptr<logger> logger_;
+};
+
 // Set global formatter. Each sink in each logger will get a clone of this object
 SPDLOG_API void set_formatter(std::unique_ptr<spdlog::formatter> formatter);
 
@@ -77,6 +104,22 @@ SPDLOG_API void flush_on(level::level_enum log_level);
 // Warning: Use only if all your loggers are thread safe!
 SPDLOG_API void flush_every(std::chrono::seconds interval);
 
+// Flush the sinks of the given logger written since their last flush, every interval (millisecond granularity).
+// Async loggers are flushed by their thread pool. Calling it again replaces the interval, a zero interval stops it.
+// All the periodic flushes share one thread (a timer wheel, see details/flush_scheduler.h).
+// Use sink->set_max_unflushed_bytes() to also flush a sink as soon as enough data is unflushed.
+SPDLOG_API void flush_every(std::shared_ptr<logger> logger, std::chrono::milliseconds interval);
+
+// Flush the given sink every interval if it was written since its last flush, from the flusher thread.
+// For a sink used by async loggers, see flush_every(sink, interval, thread_pool) in async.h.
+SPDLOG_API void flush_every(sink_ptr sink, std::chrono::milliseconds interval);
+
+// Select the clock of the messages timestamps (see clock_source).
+// clock_source::tsc reads the cpu time stamp counter (about 10ns instead of 25ns for clock_gettime()),
+// and resyncs it with the system clock every resync_interval in a background thread.
+// The clock is calibrated when selected, which takes about 10ms.
+SPDLOG_API void set_clock_source(clock_source source, std::chrono::seconds resync_interval = std::chrono::seconds(1));
+
 // Set global error handler
 SPDLOG_API void set_error_handler(void (*handler)(const std::string &msg));
 
@@ -100,12 +143,43 @@ SPDLOG_API void shutdown();
 // Automatic registration of loggers when using spdlog::create() or spdlog::create_async
 SPDLOG_API void set_automatic_registration(bool automatic_registration);
 
+// Set a short name (up to 15 chars) for the calling thread, shown by the %N pattern flag.
+SPDLOG_API void set_thread_name(string_view_t name);
+
+// Enable/disable the log macros call sites (SPDLOG_DEBUG, SPDLOG_LOGGER_INFO, ..) of the source files
+// matching the given glob (e.g. "*/net/*.cpp"), whose level is at most max_level.
+// A disabled site returns before evaluating its arguments, whatever the logger level.
+// The rules also apply to the sites that are reached for the first time later.
+// Return the number of matching sites reached so far.
+// example (debug messages of the net module only):
+//   spdlog::set_level(spdlog::level::debug);
+//   spdlog::set_callsites_by_file("*", false, spdlog::level::debug);
+//   spdlog::set_callsites_by_file("*/net/*", true);
+SPDLOG_API size_t set_callsites_by_file(const std::string &file_glob, bool enabled, level::level_enum max_level = level::critical);
+
+// Same as set_callsites_by_file(), but match the function name (e.g. "handle_*").
+SPDLOG_API size_t set_callsites_by_function(
+    const std::string &funcname_glob, bool enabled, level::level_enum max_level = level::critical);
+
+// Remove all the call sites rules and enable all the call sites.
+SPDLOG_API void reset_callsites();
+
+#ifdef SPDLOG_ENABLE_PROFILING
+// Dump the pipeline stages histograms (in cycles) of all the registered loggers and of their sinks,
+// one line per stage: "<logger>[/sink#i] <stage> count=.. mean=.. p50=.. p99=.. p99.9=.. max=..".
+// see details/profiler.h for the stages.
+SPDLOG_API std::string dump_profiles();
+
+// Clear the histograms of all the registered loggers and of their sinks.
+SPDLOG_API void reset_profiles();
+#endif
+
 // API for using default logger (stdout_color_mt),
 // e.g: spdlog::info("Message {}", 1);
 //
 // The default logger object can be accessed using the spdlog::default_logger():
 // For example, to add another sink to it:
-// spdlog::default_logger()->sinks()->push_back(some_sink);
+// spdlog::default_logger()->add_sink(some_sink);
 //
 // The default logger can replaced using spdlog::set_default_logger(new_logger).
 // For example, to replace it with a file logger.
@@ -232,7 +306,18 @@ inline void critical(const T &msg)
 // SPDLOG_LEVEL_OFF
 //
 
-#define SPDLOG_LOGGER_CALL(logger, level, ...) (logger)->log(spdlog::source_loc{__FILE__, __LINE__, SPDLOG_FUNCTION}, level, __VA_ARGS__)
+// Each call site owns a static descriptor (constant initialized), which can be disabled at runtime
+// (see spdlog::set_callsites_by_file). The logged messages refer to the descriptor instead of copying the source location.
+// Unlike logger->log(), neither the logger nor the arguments are evaluated if the site is disabled.
+#define SPDLOG_LOGGER_CALL(logger, level, ...)                                                                                             \
+    do                                                                                                                                     \
+    {                                                                                                                                      \
+        static spdlog::details::callsite spdlog_callsite{__FILE__, __LINE__};                                                              \
+        if (spdlog_callsite.enabled(SPDLOG_FUNCTION, level))                                                                               \
+        {                                                                                                                                  \
+            (logger)->log(spdlog::source_loc{__FILE__, __LINE__, SPDLOG_FUNCTION, &spdlog_callsite}, level, __VA_ARGS__);                  \
+        }                                                                                                                                  \
+    } while (0)
 
 #if SPDLOG_ACTIVE_LEVEL <= SPDLOG_LEVEL_TRACE
 #define SPDLOG_LOGGER_TRACE(logger, ...) SPDLOG_LOGGER_CALL(logger, spdlog::level::trace, __VA_ARGS__)
@@ -108,6 +108,15 @@
 // #define SPDLOG_ACTIVE_LEVEL SPDLOG_LEVEL_INFO
 ///////////////////////////////////////////////////////////////////////////////
 
+///////////////////////////////////////////////////////////////////////////////
+// Uncomment to record the cpu cycles spent in each stage of the logging pipeline
+// (formatting, enqueue, queue wait, pattern formatting and file writes) in per logger
+// and per sink histograms. See spdlog::dump_profiles().
+// Zero cost when not defined.
+//
+// #define SPDLOG_ENABLE_PROFILING
+///////////////////////////////////////////////////////////////////////////////
+
 ///////////////////////////////////////////////////////////////////////////////
 // Uncomment (and change if desired) macro to use for function names.
 // This is compiler dependent.
@@ -7,6 +7,7 @@
 
 #include <spdlog/async.h>
 #include <spdlog/async_logger-inl.h>
+#include <spdlog/details/flush_scheduler-inl.h>
 #include <spdlog/details/periodic_worker-inl.h>
 #include <spdlog/details/thread_pool-inl.h>
 
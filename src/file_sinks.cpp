@@ -7,6 +7,7 @@
 
 #include <spdlog/details/null_mutex.h>
 #include <spdlog/details/file_helper-inl.h>
+#include <spdlog/details/group_commit-inl.h>
 #include <spdlog/sinks/basic_file_sink-inl.h>
 #include <spdlog/sinks/base_sink-inl.h>
 
@@ -17,4 +18,11 @@ template class SPDLOG_API spdlog::sinks::basic_file_sink<spdlog::details::null_m
 
 #include <spdlog/sinks/rotating_file_sink-inl.h>
 template class SPDLOG_API spdlog::sinks::rotating_file_sink<std::mutex>;
-template class SPDLOG_API spdlog::sinks::rotating_file_sink<spdlog::details::null_mutex>;
\ No newline at end of file
+template class SPDLOG_API spdlog::sinks::rotating_file_sink<spdlog::details::null_mutex>;
+#include <spdlog/details/lz4_block-inl.h>
+#include <spdlog/sinks/compressed_rotating_file_sink-inl.h>
+template class SPDLOG_API spdlog::sinks::compressed_rotating_file_sink<std::mutex>;
+template class SPDLOG_API spdlog::sinks::compressed_rotating_file_sink<spdlog::details::null_mutex>;
+
+#include <spdlog/details/task_worker-inl.h>
+#include <spdlog/details/file_archiver-inl.h>
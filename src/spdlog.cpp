@@ -8,11 +8,17 @@
 #include <spdlog/spdlog-inl.h>
 #include <spdlog/common-inl.h>
 #include <spdlog/details/backtracer-inl.h>
+#include <spdlog/details/callsite-inl.h>
 #include <spdlog/details/registry-inl.h>
 #include <spdlog/details/os-inl.h>
+#include <spdlog/details/profiler-inl.h>
+#include <spdlog/details/tsc_clock-inl.h>
 #include <spdlog/pattern_formatter-inl.h>
 #include <spdlog/details/log_msg-inl.h>
 #include <spdlog/details/log_msg_buffer-inl.h>
+#include <spdlog/details/thread_buffer-inl.h>
+#include <spdlog/memory_resource-inl.h>
+#include <spdlog/details/numa-inl.h>
 #include <spdlog/logger-inl.h>
 #include <spdlog/sinks/sink-inl.h>
 #include <spdlog/sinks/base_sink-inl.h>
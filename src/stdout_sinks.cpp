@@ -9,6 +9,8 @@
 
 #include <spdlog/details/null_mutex.h>
 #include <spdlog/async.h>
+#include <spdlog/details/batch_queue-inl.h>
+#include <spdlog/details/console_buffer-inl.h>
 #include <spdlog/sinks/stdout_sinks-inl.h>
 
 template class SPDLOG_API spdlog::sinks::stdout_sink_base<spdlog::details::console_mutex>;
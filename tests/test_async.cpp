@@ -1,6 +1,9 @@
 #include "includes.h"
 #include "spdlog/async.h"
 #include "spdlog/sinks/basic_file_sink.h"
+#include "spdlog/sinks/numa_node_sink.h"
+#include "spdlog/sinks/queued_sink.h"
+#include "spdlog/sinks/worker_bound_sink.h"
 #include "test_sink.h"
 
 TEST_CASE("basic async test ", "[async]")
@@ -93,6 +96,28 @@ TEST_CASE("async periodic flush", "[async]")
     spdlog::drop_all();
 }
 
+TEST_CASE("async periodic flush dirty", "[async]")
+{
+    auto test_sink = std::make_shared<spdlog::sinks::test_sink_st>();
+    auto tp = std::make_shared<spdlog::details::thread_pool>(128, 1);
+    auto logger = std::make_shared<spdlog::async_logger>("as", test_sink, tp);
+
+    // the logger flushes through the pool, the sink is flushed by the worker
+    spdlog::flush_every(logger, std::chrono::milliseconds(10));
+    spdlog::flush_every(test_sink, std::chrono::milliseconds(10), tp);
+    std::this_thread::sleep_for(std::chrono::milliseconds(100));
+    REQUIRE(test_sink->flush_counter() == 0);
+
+    logger->info("Test message");
+    std::this_thread::sleep_for(std::chrono::milliseconds(100));
+    REQUIRE(test_sink->flush_counter() >= 1);
+    REQUIRE(test_sink->flush_counter() <= 2);
+    REQUIRE_FALSE(test_sink->dirty());
+
+    spdlog::flush_every(logger, std::chrono::milliseconds(0));
+    spdlog::flush_every(test_sink, std::chrono::milliseconds(0));
+}
+
 TEST_CASE("tp->wait_empty() ", "[async]")
 {
     auto test_sink = std::make_shared<spdlog::sinks::test_sink_mt>();
@@ -186,3 +211,261 @@ TEST_CASE("to_file multi-workers", "[async]")
 
     require_message_count(filename, messages);
 }
+
+TEST_CASE("worker bound sink", "[async]")
+{
+    auto test_sink = std::make_shared<spdlog::sinks::test_sink_st>();
+    test_sink->set_delay(std::chrono::milliseconds(1));
+    {
+        auto tp = std::make_shared<spdlog::details::thread_pool>(128, 1);
+        auto bound_sink = std::make_shared<spdlog::sinks::worker_bound_sink>(test_sink, tp);
+        auto logger = std::make_shared<spdlog::async_logger>("as", bound_sink, tp, spdlog::async_overflow_policy::block);
+        bound_sink->set_pattern("1 %v");
+        for (int i = 0; i < 10; i++)
+        {
+            logger->info("message {}", i);
+        }
+        // control messages: run by the worker, after the messages posted before
+        bound_sink->set_pattern("2 %v");
+        logger->info("message 10");
+        bound_sink->set_formatter(spdlog::details::make_unique<spdlog::pattern_formatter>("3 %v"));
+        logger->info("message 11");
+        bound_sink->flush();
+    }
+    REQUIRE(test_sink->msg_counter() == 12);
+    REQUIRE(test_sink->flush_counter() == 1);
+    auto lines = test_sink->lines();
+    REQUIRE(lines[9] == "1 message 9");
+    REQUIRE(lines[10] == "2 message 10");
+    REQUIRE(lines[11] == "3 message 11");
+}
+
+TEST_CASE("worker bound sink target level", "[async]")
+{
+    auto test_sink = std::make_shared<spdlog::sinks::test_sink_st>();
+    test_sink->set_level(spdlog::level::warn);
+    {
+        auto tp = std::make_shared<spdlog::details::thread_pool>(128, 1);
+        auto bound_sink = std::make_shared<spdlog::sinks::worker_bound_sink>(test_sink, tp);
+        auto logger = std::make_shared<spdlog::async_logger>("as", bound_sink, tp, spdlog::async_overflow_policy::block);
+        logger->info("filtered by the target");
+        logger->warn("logged");
+    }
+    REQUIRE(test_sink->msg_counter() == 1);
+}
+
+TEST_CASE("control messages not overrun", "[async]")
+{
+    auto test_sink = std::make_shared<spdlog::sinks::test_sink_mt>();
+    std::atomic<bool> release{false};
+    std::atomic<int> runs{0};
+    {
+        auto tp = std::make_shared<spdlog::details::thread_pool>(4, 1);
+        auto logger = std::make_shared<spdlog::async_logger>("as", test_sink, tp, spdlog::async_overflow_policy::overrun_oldest);
+        // keep the worker busy while the queue fills up
+        tp->post_control([&release] {
+            while (!release)
+            {
+                std::this_thread::sleep_for(std::chrono::milliseconds(1));
+            }
+        });
+        for (int i = 0; i < 3; i++)
+        {
+            tp->post_control([&runs] { runs++; });
+        }
+        std::thread releaser([&release] {
+            std::this_thread::sleep_for(std::chrono::milliseconds(20));
+            release = true;
+        });
+        for (int i = 0; i < 20; i++)
+        {
+            logger->info("message {}", i);
+        }
+        releaser.join();
+    }
+    REQUIRE(runs == 3);
+}
+
+#ifndef SPDLOG_NO_EXCEPTIONS
+TEST_CASE("worker bound sink multi-workers", "[async]")
+{
+    auto tp = std::make_shared<spdlog::details::thread_pool>(128, 2);
+    auto test_sink = std::make_shared<spdlog::sinks::test_sink_st>();
+    REQUIRE_THROWS_AS(std::make_shared<spdlog::sinks::worker_bound_sink>(test_sink, tp), spdlog::spdlog_ex);
+}
+#endif
+
+TEST_CASE("queued sinks", "[async]")
+{
+    auto fast_sink = std::make_shared<spdlog::sinks::test_sink_mt>();
+    auto slow_sink = std::make_shared<spdlog::sinks::test_sink_mt>();
+    slow_sink->set_delay(std::chrono::milliseconds(50));
+    size_t messages = 20;
+    {
+        auto tp = std::make_shared<spdlog::details::thread_pool>(128, 1);
+        auto fast = std::make_shared<spdlog::sinks::queued_sink>(fast_sink, 128);
+        auto slow = std::make_shared<spdlog::sinks::queued_sink>(slow_sink, 128);
+        auto logger = std::make_shared<spdlog::async_logger>("as", spdlog::sinks_init_list{slow, fast}, tp);
+        for (size_t i = 0; i < messages; i++)
+        {
+            logger->info("Hello message #{}", i);
+        }
+        logger->flush();
+
+        // the slow sink doesn't delay the fast one
+        for (int i = 0; i < 500 && fast_sink->flush_counter() == 0; i++)
+        {
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+        REQUIRE(fast_sink->msg_counter() == messages);
+        REQUIRE(slow_sink->msg_counter() < messages);
+    }
+    // the remaining messages are logged on destruction
+    REQUIRE(slow_sink->msg_counter() == messages);
+    REQUIRE(slow_sink->flush_counter() == 1);
+}
+
+TEST_CASE("queued sink target level", "[async]")
+{
+    auto test_sink = std::make_shared<spdlog::sinks::test_sink_mt>();
+    test_sink->set_level(spdlog::level::warn);
+    {
+        auto queued = std::make_shared<spdlog::sinks::queued_sink>(test_sink, 16);
+        spdlog::logger logger("queued", queued);
+        logger.info("filtered by the target");
+        logger.warn("logged");
+        logger.flush();
+        for (int i = 0; i < 500 && test_sink->flush_counter() == 0; i++)
+        {
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+        REQUIRE(queued->logged() == 1);
+    }
+    REQUIRE(test_sink->msg_counter() == 1);
+}
+
+TEST_CASE("queued sink overrun", "[async]")
+{
+    auto fast_sink = std::make_shared<spdlog::sinks::test_sink_mt>();
+    auto slow_sink = std::make_shared<spdlog::sinks::test_sink_mt>();
+    slow_sink->set_delay(std::chrono::milliseconds(2));
+    size_t messages = 256;
+    size_t dropped = 0;
+    size_t logged = 0;
+    {
+        auto tp = std::make_shared<spdlog::details::thread_pool>(16, 1);
+        auto fast = std::make_shared<spdlog::sinks::queued_sink>(fast_sink, 16);
+        auto slow = std::make_shared<spdlog::sinks::queued_sink>(slow_sink, 4, spdlog::async_overflow_policy::overrun_oldest);
+        {
+            auto logger = std::make_shared<spdlog::async_logger>("as", spdlog::sinks_init_list{slow, fast}, tp);
+            for (size_t i = 0; i < messages; i++)
+            {
+                logger->info("Hello message #{}", i);
+            }
+        }
+        tp.reset();
+        fast.reset();
+        dropped = slow->dropped();
+        REQUIRE(fast_sink->msg_counter() == messages);
+        slow.reset();
+        logged = slow_sink->msg_counter();
+    }
+    REQUIRE(dropped > 0);
+    REQUIRE(logged + dropped == messages);
+}
+
+TEST_CASE("numa topology", "[async]")
+{
+    using spdlog::details::numa_topology;
+    REQUIRE(numa_topology::parse_cpu_list("0-3,8,10-11\n") == std::vector<int>{0, 1, 2, 3, 8, 10, 11});
+    REQUIRE(numa_topology::parse_cpu_list("5") == std::vector<int>{5});
+    REQUIRE(numa_topology::parse_cpu_list("").empty());
+
+    numa_topology two_nodes({{0, 1, 4, 5}, {2, 3, 6, 7}});
+    REQUIRE(two_nodes.nodes_count() == 2);
+    REQUIRE(two_nodes.node_of_cpu(5) == 0);
+    REQUIRE(two_nodes.node_of_cpu(6) == 1);
+    REQUIRE(two_nodes.node_of_cpu(100) == 0);
+
+    auto &machine = numa_topology::instance();
+    REQUIRE(machine.nodes_count() >= 1);
+    REQUIRE(!machine.node_cpus(0).empty());
+    REQUIRE(machine.current_node() < machine.nodes_count());
+}
+
+TEST_CASE("numa per node thread pool", "[async]")
+{
+    auto &topology = spdlog::details::numa_topology::instance();
+    std::vector<std::shared_ptr<spdlog::sinks::test_sink_mt>> node_sinks;
+    auto split = std::make_shared<spdlog::sinks::numa_node_sink>([&node_sinks](size_t) {
+        node_sinks.push_back(std::make_shared<spdlog::sinks::test_sink_mt>());
+        return node_sinks.back();
+    });
+    REQUIRE(node_sinks.size() == topology.nodes_count());
+
+    auto merged_sink = std::make_shared<spdlog::sinks::test_sink_mt>();
+    size_t messages = 256;
+    size_t threads_count = 4;
+    {
+        auto tp = std::make_shared<spdlog::details::thread_pool>(64, 2, [] {}, nullptr, spdlog::numa_policy::per_node);
+        REQUIRE(tp->queues_count() == topology.nodes_count());
+        REQUIRE(tp->threads_count() == 2 * topology.nodes_count());
+        auto logger = std::make_shared<spdlog::async_logger>("as", spdlog::sinks_init_list{split, merged_sink}, tp);
+
+        std::vector<std::thread> threads;
+        for (size_t t = 0; t < threads_count; t++)
+        {
+            threads.emplace_back([&logger, messages, threads_count] {
+                for (size_t i = 0; i < messages / threads_count; i++)
+                {
+                    logger->info("Hello message #{}", i);
+                }
+            });
+        }
+        for (auto &t : threads)
+        {
+            t.join();
+        }
+        logger->flush();
+    }
+
+    size_t split_messages = 0;
+    for (auto &node_sink : node_sinks)
+    {
+        split_messages += node_sink->msg_counter();
+    }
+    REQUIRE(split_messages == messages);
+    REQUIRE(merged_sink->msg_counter() == messages);
+    REQUIRE(node_sinks[0]->flush_counter() == 1);
+}
+
+TEST_CASE("numa per node control messages", "[async]")
+{
+    auto test_sink = std::make_shared<spdlog::sinks::test_sink_mt>();
+    test_sink->set_pattern("%v");
+    size_t messages = 100;
+    std::atomic<size_t> logged_before_control{0};
+    std::atomic<int> control_runs{0};
+    {
+        auto tp = std::make_shared<spdlog::details::thread_pool>(16, 1, [] {}, nullptr, spdlog::numa_policy::per_node);
+        auto logger = std::make_shared<spdlog::async_logger>("as", test_sink, tp);
+        for (size_t i = 0; i < messages; i++)
+        {
+            logger->info("Hello message #{}", i);
+        }
+        // run once, after the messages posted to any node
+        tp->post_control([&] {
+            logged_before_control = test_sink->msg_counter();
+            control_runs++;
+        });
+        logger->flush();
+    }
+    REQUIRE(control_runs == 1);
+    REQUIRE(logged_before_control == messages);
+    REQUIRE(test_sink->flush_counter() == 1);
+    auto lines = test_sink->lines();
+    for (size_t i = 0; i < messages; i++)
+    {
+        REQUIRE(lines[i] == fmt::format("Hello message #{}", i));
+    }
+}
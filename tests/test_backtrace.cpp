@@ -1,6 +1,7 @@
 #include "includes.h"
 #include "test_sink.h"
 #include "spdlog/async.h"
+#include "spdlog/fmt/ostr.h"
 
 TEST_CASE("bactrace1", "[bactrace]")
 {
@@ -63,3 +64,121 @@ TEST_CASE("bactrace-async", "[bactrace]")
     REQUIRE(test_sink->lines()[6] == "debug message 99");
     REQUIRE(test_sink->lines()[7] == "****************** Backtrace End ********************");
 }
+
+struct backtrace_custom_type
+{
+    int value;
+};
+
+template<typename OStream>
+OStream &operator<<(OStream &os, const backtrace_custom_type &t)
+{
+    return os << "custom " << t.value;
+}
+
+TEST_CASE("bactrace-deferred", "[bactrace]")
+{
+    using spdlog::sinks::test_sink_st;
+    auto test_sink = std::make_shared<test_sink_st>();
+
+    spdlog::logger logger("test-backtrace", test_sink);
+    logger.set_pattern("%v");
+    logger.enable_backtrace(10);
+
+    static_assert(spdlog::details::are_deferrable_args<int, double, char, std::string, const char *, char[4]>::value, "");
+    static_assert(!spdlog::details::are_deferrable_args<int, backtrace_custom_type>::value, "");
+
+    // the messages below the logger level are stored with copies of their arguments, and formatted on dump
+    std::string str = "string";
+    const char *c_str = "c string";
+    logger.debug("{} {} {} {:.1f} {}", str, spdlog::string_view_t(str), c_str, 1.5, 'x');
+    str = "modified";
+    logger.debug("{} {}", "literal", 42);
+    logger.debug(std::string("runtime format {}"), true);
+    logger.debug("{}", backtrace_custom_type{7}); // formatted right away
+    REQUIRE(test_sink->lines().empty());
+
+    logger.dump_backtrace();
+    REQUIRE(test_sink->lines().size() == 6);
+    REQUIRE(test_sink->lines()[1] == "string string c string 1.5 x");
+    REQUIRE(test_sink->lines()[2] == "literal 42");
+    REQUIRE(test_sink->lines()[3] == "runtime format true");
+    REQUIRE(test_sink->lines()[4] == "custom 7");
+}
+
+TEST_CASE("bactrace-deferred-overflow", "[bactrace]")
+{
+    using spdlog::sinks::test_sink_st;
+    auto test_sink = std::make_shared<test_sink_st>();
+
+    spdlog::logger logger("test-backtrace", test_sink);
+    logger.set_pattern("%v");
+    logger.enable_backtrace(10);
+
+    // arguments that don't fit in a deferred_payload: formatted right away
+    std::string long_str(spdlog::details::deferred_payload::capacity, 'x');
+    logger.debug("long {}", long_str);
+    logger.debug("{}{}{}{}{}{}{}{}{}{}{}{}{}{}{}{}{}", 0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 0, 1, 2, 3, 4, 5, 6);
+    spdlog::details::deferred_payload payload;
+    REQUIRE(!payload.assign("long {}", long_str));
+    REQUIRE(payload.assign("short {} {}", 1, "two"));
+
+    logger.dump_backtrace();
+    REQUIRE(test_sink->lines().size() == 4);
+    REQUIRE(test_sink->lines()[1] == "long " + long_str);
+    REQUIRE(test_sink->lines()[2] == "01234567890123456");
+
+    spdlog::memory_buf_t formatted;
+    payload.format_to(formatted);
+    REQUIRE(fmt::to_string(formatted) == "short 1 two");
+}
+
+TEST_CASE("bactrace-multi-threads", "[bactrace]")
+{
+    using spdlog::sinks::test_sink_mt;
+    auto test_sink = std::make_shared<test_sink_mt>();
+    size_t backtrace_size = 50;
+
+    spdlog::logger logger("test-backtrace-mt", test_sink);
+    logger.set_pattern("%E%F %v");
+    logger.enable_backtrace(backtrace_size);
+
+    std::vector<std::thread> threads;
+    for (int t = 0; t < 4; t++)
+    {
+        threads.emplace_back([&logger, t] {
+            for (int i = 0; i < 100; i++)
+            {
+                logger.debug("thread {} message {}", t, i);
+            }
+        });
+    }
+    for (auto &t : threads)
+    {
+        t.join();
+    }
+    logger.debug("last message");
+
+    logger.dump_backtrace();
+    auto lines = test_sink->lines();
+    REQUIRE(lines.size() == backtrace_size + 2);
+    REQUIRE(lines[backtrace_size].find("last message") != std::string::npos);
+
+    // merged by time, and in order for each thread
+    std::vector<int> last_index(4, -1);
+    for (size_t i = 1; i < backtrace_size; i++)
+    {
+        if (i > 1)
+        {
+            REQUIRE(lines[i - 1].substr(0, lines[i - 1].find(' ')) <= lines[i].substr(0, lines[i].find(' ')));
+        }
+        int t = 0, index = 0;
+        REQUIRE(std::sscanf(lines[i].c_str() + lines[i].find(' '), " thread %d message %d", &t, &index) == 2);
+        REQUIRE(index > last_index[t]);
+        last_index[t] = index;
+    }
+
+    // the rings were emptied
+    logger.dump_backtrace();
+    REQUIRE(test_sink->lines().size() == backtrace_size + 4);
+}
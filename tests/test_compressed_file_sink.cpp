@@ -0,0 +1,134 @@
+/*
+ * This content is released under the MIT License as specified in https://raw.githubusercontent.com/gabime/spdlog/master/LICENSE
+ */
+#include "includes.h"
+#include "spdlog/details/lz4_block.h"
+
+static std::string decompress_file(const std::string &filename)
+{
+    auto compressed = file_contents(filename);
+    REQUIRE(compressed.size() >= 4);
+    spdlog::memory_buf_t header;
+    spdlog::details::lz4::append_le32(spdlog::details::lz4::legacy_magic, header);
+    REQUIRE(compressed.compare(0, 4, header.data(), 4) == 0);
+
+    spdlog::memory_buf_t out;
+    REQUIRE(spdlog::details::lz4::decompress_frame(compressed.data() + 4, compressed.size() - 4, out));
+    return std::string(out.data(), out.size());
+}
+
+TEST_CASE("lz4_roundtrip", "[lz4]")
+{
+    std::string input;
+    for (int i = 0; i < 1000; ++i)
+    {
+        input += fmt::format("[2020-01-01 00:00:{:02}] [info] Test message number {}\n", i % 60, i);
+    }
+    // some incompressible data and a long run of the same byte
+    for (int i = 0; i < 300; ++i)
+    {
+        input.push_back(static_cast<char>((i * 7919) % 251));
+    }
+    input += std::string(1000, 'x');
+
+    spdlog::memory_buf_t compressed;
+    auto size = spdlog::details::lz4::compress_block(input.data(), input.size(), compressed);
+    REQUIRE(size == compressed.size());
+    REQUIRE(size < input.size() / 4);
+
+    spdlog::memory_buf_t out;
+    REQUIRE(spdlog::details::lz4::decompress_block(compressed.data(), compressed.size(), out));
+    REQUIRE(std::string(out.data(), out.size()) == input);
+
+    // malformed input
+    spdlog::memory_buf_t bad;
+    REQUIRE_FALSE(spdlog::details::lz4::decompress_block(compressed.data(), compressed.size() / 2, bad));
+}
+
+TEST_CASE("lz4_small_inputs", "[lz4]")
+{
+    for (size_t len = 0; len < 20; ++len)
+    {
+        std::string input(len, 'a');
+        spdlog::memory_buf_t compressed;
+        spdlog::details::lz4::compress_block(input.data(), input.size(), compressed);
+        spdlog::memory_buf_t out;
+        REQUIRE(spdlog::details::lz4::decompress_block(compressed.data(), compressed.size(), out));
+        REQUIRE(std::string(out.data(), out.size()) == input);
+    }
+}
+
+TEST_CASE("compressed_file_logger", "[compressed_rotating_logger]")
+{
+    prepare_logdir();
+    std::string basename = "test_logs/compressed_log.lz4";
+    auto logger = spdlog::compressed_rotating_logger_mt("logger", basename, 1024 * 1024, 2);
+    logger->set_pattern("%v");
+
+    for (int i = 0; i < 100; ++i)
+    {
+        logger->info("Test message {}", i);
+    }
+    logger->flush();
+    logger->info("Test message {}", 100);
+    logger->flush();
+
+    auto contents = decompress_file(basename);
+    using spdlog::details::os::default_eol;
+    REQUIRE(contents.find(fmt::format("Test message 0{}Test message 1{}", default_eol, default_eol)) == 0);
+    REQUIRE(contents.find(fmt::format("Test message 100{}", default_eol)) != std::string::npos);
+    REQUIRE(get_filesize(basename) < contents.size());
+}
+
+TEST_CASE("compressed_file_logger_rotate", "[compressed_rotating_logger]")
+{
+    prepare_logdir();
+    std::string basename = "test_logs/compressed_log.lz4";
+    size_t max_size = 512;
+    auto logger = spdlog::compressed_rotating_logger_mt("logger", basename, max_size, 2, 128);
+    logger->set_pattern("%v");
+
+    for (int i = 0; i < 1000; ++i)
+    {
+        logger->info("Test message {}", i);
+    }
+    logger->flush();
+
+    REQUIRE(get_filesize(basename) <= max_size);
+    REQUIRE(get_filesize("test_logs/compressed_log.1.lz4") <= max_size);
+    REQUIRE(get_filesize("test_logs/compressed_log.2.lz4") <= max_size);
+    REQUIRE(count_files("test_logs") == 3);
+
+    // the newest messages are in the current file, every file is a valid frame
+    using spdlog::details::os::default_eol;
+    REQUIRE(ends_with(decompress_file(basename), fmt::format("Test message 999{}", default_eol)));
+    REQUIRE(!decompress_file("test_logs/compressed_log.1.lz4").empty());
+    REQUIRE(!decompress_file("test_logs/compressed_log.2.lz4").empty());
+}
+
+#ifndef SPDLOG_NO_EXCEPTIONS
+TEST_CASE("compressed_file_logger_rotate_failure", "[compressed_rotating_logger]")
+{
+    prepare_logdir();
+    std::string basename = "test_logs/compressed_log.lz4";
+    // a non empty directory in place of the first rotated file: the rotation fails
+    REQUIRE(spdlog::details::os::create_dir(SPDLOG_FILENAME_T("test_logs/compressed_log.1.lz4/dir")));
+    spdlog::sinks::compressed_rotating_file_sink_st sink(basename, 512, 2, 128);
+    sink.set_pattern("%v");
+
+    auto log_messages = [&sink](int count) {
+        for (int i = 0; i < count; ++i)
+        {
+            auto payload = fmt::format("Test message {}", i);
+            sink.log(spdlog::details::log_msg{"logger", spdlog::level::info, payload});
+        }
+    };
+    REQUIRE_THROWS_AS(log_messages(1000), spdlog::spdlog_ex);
+
+    // the truncated file starts with the header again: the next blocks make a valid frame
+    log_messages(10);
+    sink.flush();
+    using spdlog::details::os::default_eol;
+    REQUIRE(ends_with(decompress_file(basename), fmt::format("Test message 9{}", default_eol)));
+}
+#endif
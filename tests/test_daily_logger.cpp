@@ -146,4 +146,123 @@ TEST_CASE("daily_logger rotate", "[daily_file_sink]")
     test_rotate(days_to_run, 10, 10);
     test_rotate(days_to_run, 11, 10);
     test_rotate(days_to_run, 20, 10);
-}
\ No newline at end of file
+}
+TEST_CASE("daily_logger archiver", "[daily_file_sink]")
+{
+    using spdlog::sinks::daily_file_sink_st;
+
+    prepare_logdir();
+    std::string basename = "test_logs/daily_rotate.txt";
+
+    spdlog::details::archive_policy policy;
+    policy.compress = false;
+    policy.max_total_bytes = 100;
+    auto archiver = std::make_shared<spdlog::details::file_archiver>(policy);
+    {
+        daily_file_sink_st sink{basename, 2, 30, true};
+        sink.set_rotation_hook(spdlog::details::file_archiver::make_hook(archiver));
+        sink.set_pattern("%v");
+
+        for (int i = 0; i < 10; i++)
+        {
+            auto offset = std::chrono::seconds{24 * 3600 * i};
+            sink.log(create_msg(offset)); // "Hello Message" + eol in each file
+        }
+    }
+    archiver->wait_idle();
+
+    // 9 previous files were handed to the archiver, which keeps at most 100 bytes of them
+    auto file_size = std::string("Hello Message").size() + std::strlen(spdlog::details::os::default_eol);
+    auto expected_archived = 100 / file_size;
+    REQUIRE(archiver->archived_files().size() == expected_archived);
+    REQUIRE(archiver->total_bytes() == expected_archived * file_size);
+    REQUIRE(count_files("test_logs") == expected_archived + 1);
+}
+
+TEST_CASE("interval_file_sink::interval_filename_calculator", "[interval_file_sink]]")
+{
+    std::tm tm{};
+    tm.tm_year = 120;
+    tm.tm_mon = 0;
+    tm.tm_mday = 31;
+    tm.tm_hour = 13;
+    tm.tm_min = 15;
+    auto filename = spdlog::sinks::interval_filename_calculator::calc_filename("logs/app_%Y-%m-%d_%H-%M.txt", tm);
+    REQUIRE(filename == "logs/app_2020-01-31_13-15.txt");
+}
+
+static void test_interval_rotate(int intervals_to_run, uint16_t max_files, size_t expected_n_files)
+{
+    using spdlog::sinks::interval_file_sink_st;
+
+    prepare_logdir();
+
+    interval_file_sink_st sink{"test_logs/interval_%Y-%m-%d_%H-%M.txt", std::chrono::minutes(15), true, max_files};
+
+    // simulate messages with 15 minutes intervals
+    for (int i = 0; i < intervals_to_run; i++)
+    {
+        auto offset = std::chrono::seconds{15 * 60 * i};
+        sink.log(create_msg(offset));
+    }
+
+    REQUIRE(count_files("test_logs") == expected_n_files);
+}
+
+TEST_CASE("interval_logger rotate", "[interval_file_sink]")
+{
+    test_interval_rotate(1, 0, 1);
+    test_interval_rotate(1, 3, 1);
+    test_interval_rotate(10, 0, 10);
+    test_interval_rotate(10, 1, 1);
+    test_interval_rotate(10, 3, 3);
+    test_interval_rotate(10, 20, 10);
+}
+
+TEST_CASE("interval_logger coarse template", "[interval_file_sink]")
+{
+    using spdlog::sinks::interval_file_sink_st;
+    using spdlog::sinks::interval_filename_calculator;
+
+    prepare_logdir();
+    std::string filename_template = "test_logs/coarse_%Y-%m-%d_%H.txt";
+
+    // tomorrow 10:00 local time
+    auto tomorrow = spdlog::details::os::localtime(spdlog::log_clock::to_time_t(spdlog::log_clock::now() + std::chrono::hours(24)));
+    tomorrow.tm_hour = 10;
+    tomorrow.tm_min = 0;
+    tomorrow.tm_sec = 0;
+    tomorrow.tm_isdst = -1;
+    auto ten = spdlog::log_clock::from_time_t(std::mktime(&tomorrow));
+    auto ten_filename = interval_filename_calculator::calc_filename(filename_template, tomorrow);
+    {
+        // the hourly file is shared by four 15 minutes intervals: neither truncated nor deleted at their boundaries
+        interval_file_sink_st sink{filename_template, std::chrono::minutes(15), true, 2};
+        sink.set_pattern("%v");
+        for (int i = 0; i < 5; i++)
+        {
+            spdlog::details::log_msg msg{"test", spdlog::level::info, "Hello Message"};
+            msg.time = ten + std::chrono::minutes(15 * i);
+            sink.log(msg);
+            if (i == 3)
+            {
+                REQUIRE(sink.filename() == ten_filename);
+            }
+        }
+    }
+
+    // the file of the sink creation was deleted when rotating to 11:00
+    REQUIRE(count_files("test_logs") == 2);
+    auto eol_size = std::strlen(spdlog::details::os::default_eol);
+    REQUIRE(get_filesize(ten_filename) == 4 * (std::string("Hello Message").size() + eol_size));
+}
+
+TEST_CASE("interval_logger invalid interval", "[interval_file_sink]")
+{
+#ifndef SPDLOG_NO_EXCEPTIONS
+    prepare_logdir();
+    using spdlog::sinks::interval_file_sink_st;
+    REQUIRE_THROWS_AS(interval_file_sink_st("test_logs/interval_%H.txt", std::chrono::hours(0)), spdlog::spdlog_ex);
+    REQUIRE_THROWS_AS(interval_file_sink_st("test_logs/interval_%H.txt", std::chrono::hours(25)), spdlog::spdlog_ex);
+#endif
+}
@@ -2,6 +2,7 @@
  * This content is released under the MIT License as specified in https://raw.githubusercontent.com/gabime/spdlog/master/LICENSE
  */
 #include "includes.h"
+#include "spdlog/details/lz4_block.h"
 
 TEST_CASE("simple_file_logger", "[simple_logger]]")
 {
@@ -96,3 +97,126 @@ TEST_CASE("rotating_file_logger2", "[rotating_logger]]")
     auto filename1 = basename + ".1";
     REQUIRE(get_filesize(filename1) <= max_size);
 }
+
+TEST_CASE("rotating_file_logger_archiver", "[rotating_logger]]")
+{
+    prepare_logdir();
+    size_t max_size = 1024;
+    std::string basename = "test_logs/rotating_log.txt";
+
+    spdlog::details::archive_policy policy;
+    policy.max_files = 3;
+    auto archiver = std::make_shared<spdlog::details::file_archiver>(policy);
+
+    auto sink = std::make_shared<spdlog::sinks::rotating_file_sink_mt>(basename, max_size, 1);
+    sink->set_rotation_hook(spdlog::details::file_archiver::make_hook(archiver));
+    auto logger = std::make_shared<spdlog::logger>("logger", sink);
+    logger->set_pattern("%v");
+    for (int i = 0; i < 200; ++i)
+    {
+        logger->info("Test message {}", i);
+    }
+    logger->flush();
+    archiver->wait_idle();
+
+    // the current file plus the 3 most recent compressed files
+    REQUIRE(get_filesize(basename) <= max_size);
+    auto archived = archiver->archived_files();
+    REQUIRE(archived.size() == 3);
+    REQUIRE(count_files("test_logs") == 4);
+
+    size_t total = 0;
+    for (const auto &filename : archived)
+    {
+        REQUIRE(ends_with(filename, ".txt.lz4"));
+        auto compressed = file_contents(filename);
+        total += compressed.size();
+        spdlog::memory_buf_t decompressed;
+        REQUIRE(spdlog::details::lz4::decompress_frame(compressed.data() + 4, compressed.size() - 4, decompressed));
+        REQUIRE(decompressed.size() > 0);
+        REQUIRE(decompressed.size() <= max_size);
+    }
+    REQUIRE(archiver->total_bytes() == total);
+}
+
+TEST_CASE("rotating_file_logger_async_rotation", "[rotating_logger]]")
+{
+    size_t max_size = 1024;
+    std::string basename = "test_logs/rotating_log.txt";
+
+    for (auto precreate : {true, false})
+    {
+        prepare_logdir();
+        {
+            auto sink = std::make_shared<spdlog::sinks::rotating_file_sink_mt>(basename, max_size, 2);
+            sink->enable_async_rotation(precreate);
+            auto logger = std::make_shared<spdlog::logger>("logger", sink);
+            for (int i = 0; i < 1000; ++i)
+            {
+                logger->info("Test message {}", i);
+            }
+            logger->flush();
+            REQUIRE(get_filesize(basename) <= max_size);
+        } // the sink destructor waits for the pending rotations and removes the pre-created file
+
+        REQUIRE(get_filesize(basename) <= max_size);
+        REQUIRE(get_filesize("test_logs/rotating_log.1.txt") <= max_size);
+        REQUIRE(get_filesize("test_logs/rotating_log.2.txt") <= max_size);
+        REQUIRE(count_files("test_logs") == 3);
+        REQUIRE(ends_with(file_contents(basename), fmt::format("Test message 999{}", spdlog::details::os::default_eol)));
+    }
+}
+
+TEST_CASE("durable_file_logger", "[simple_logger]]")
+{
+    prepare_logdir();
+    std::string filename = "test_logs/simple_log";
+
+    auto sink = std::make_shared<spdlog::sinks::basic_file_sink_mt>(filename);
+    sink->enable_durability(std::chrono::microseconds(200));
+    auto logger = std::make_shared<spdlog::logger>("logger", sink);
+    logger->set_pattern("%v");
+
+    // each message is on disk when log() returns, without flush()
+    logger->info("Test message {}", 1);
+    REQUIRE(count_lines(filename) == 1);
+
+    size_t n_threads = 4;
+    size_t messages = 200;
+    std::vector<std::thread> threads;
+    for (size_t t = 0; t < n_threads; t++)
+    {
+        threads.emplace_back([&logger, messages] {
+            for (size_t i = 0; i < messages; i++)
+            {
+                logger->info("Test message {}", i);
+            }
+        });
+    }
+    for (auto &t : threads)
+    {
+        t.join();
+    }
+    REQUIRE(count_lines(filename) == 1 + n_threads * messages);
+}
+
+TEST_CASE("durable_rotating_file_logger", "[rotating_logger]]")
+{
+    prepare_logdir();
+    size_t max_size = 1024;
+    std::string basename = "test_logs/rotating_log.txt";
+
+    auto sink = std::make_shared<spdlog::sinks::rotating_file_sink_mt>(basename, max_size, 2);
+    sink->enable_durability();
+    auto logger = std::make_shared<spdlog::logger>("logger", sink);
+    for (int i = 0; i < 100; ++i)
+    {
+        logger->info("Test message {}", i);
+    }
+
+    // the pending data is written to the file being rotated, not to the new one
+    REQUIRE(get_filesize(basename) <= max_size);
+    REQUIRE(get_filesize("test_logs/rotating_log.1.txt") <= max_size);
+    REQUIRE(get_filesize("test_logs/rotating_log.1.txt") > max_size / 2);
+    REQUIRE(ends_with(file_contents(basename), fmt::format("Test message 99{}", spdlog::details::os::default_eol)));
+}
@@ -0,0 +1,121 @@
+#include "includes.h"
+#include "spdlog/sinks/lockfree_ringbuffer_sink.h"
+
+#include <thread>
+
+TEST_CASE("lockfree_ringbuffer basic", "[lockfree_ringbuffer]")
+{
+    auto sink = std::make_shared<spdlog::sinks::lockfree_ringbuffer_sink>(4096);
+    sink->set_pattern("%n %l %v");
+    spdlog::logger logger("ring", sink);
+
+    REQUIRE(sink->last_formatted().empty());
+    for (int i = 0; i < 3; i++)
+    {
+        logger.info("message {}", i);
+    }
+
+    auto lines = sink->last_formatted();
+    REQUIRE(lines.size() == 3);
+    REQUIRE(lines[0] == std::string("ring info message 0") + spdlog::details::os::default_eol);
+    REQUIRE(lines[2] == std::string("ring info message 2") + spdlog::details::os::default_eol);
+
+    lines = sink->last_formatted(1);
+    REQUIRE(lines.size() == 1);
+    REQUIRE(lines[0] == std::string("ring info message 2") + spdlog::details::os::default_eol);
+}
+
+TEST_CASE("lockfree_ringbuffer wrap around", "[lockfree_ringbuffer]")
+{
+    auto sink = std::make_shared<spdlog::sinks::lockfree_ringbuffer_sink>(4096);
+    spdlog::logger logger("ring", sink);
+    for (int i = 0; i < 1000; i++)
+    {
+        logger.warn("message number {}", i);
+    }
+
+    spdlog::sinks::lockfree_ringbuffer_sink::snapshot_type snap;
+    sink->snapshot(snap);
+    auto &records = snap.records();
+    REQUIRE(records.size() > 10);
+    REQUIRE(records.size() < 1000);
+
+    // the newest records, in order
+    auto first = 1000 - static_cast<int>(records.size());
+    for (size_t i = 0; i < records.size(); i++)
+    {
+        REQUIRE(records[i].level == spdlog::level::warn);
+        REQUIRE(records[i].logger_name == "ring");
+        REQUIRE(fmt::to_string(records[i].payload) == fmt::format("message number {}", first + static_cast<int>(i)));
+    }
+}
+
+TEST_CASE("lockfree_ringbuffer truncate", "[lockfree_ringbuffer]")
+{
+    auto sink = std::make_shared<spdlog::sinks::lockfree_ringbuffer_sink>(8192);
+    spdlog::logger logger("ring", sink);
+    logger.info(std::string(5000, 'x'));
+    logger.info("after");
+
+    spdlog::sinks::lockfree_ringbuffer_sink::snapshot_type snap;
+    sink->snapshot(snap);
+    REQUIRE(snap.records().size() == 2);
+    REQUIRE(snap.records()[0].payload.size() < 8192 / 8);
+    REQUIRE(snap.records()[1].payload == "after");
+}
+
+TEST_CASE("lockfree_ringbuffer concurrent", "[lockfree_ringbuffer]")
+{
+    auto sink = std::make_shared<spdlog::sinks::lockfree_ringbuffer_sink>(16384);
+    auto logger = std::make_shared<spdlog::logger>("ring", sink);
+    const int n_threads = 4;
+    const int n_messages = 20000;
+    std::atomic<int> running{n_threads};
+
+    std::vector<std::thread> threads;
+    for (int t = 0; t < n_threads; t++)
+    {
+        threads.emplace_back([&, t] {
+            for (int i = 0; i < n_messages; i++)
+            {
+                logger->info("{:02} {:08}", t, i);
+            }
+            running--;
+        });
+    }
+
+    // every record of every snapshot is intact, and the messages of each thread are in order
+    spdlog::sinks::lockfree_ringbuffer_sink::snapshot_type snap;
+    size_t snapshots = 0;
+    bool intact = true;
+    do
+    {
+        sink->snapshot(snap);
+        int last[n_threads] = {-1, -1, -1, -1};
+        for (auto &r : snap.records())
+        {
+            auto payload = fmt::to_string(r.payload);
+            intact = intact && payload.size() == 11 && r.logger_name == "ring";
+            if (!intact)
+            {
+                break;
+            }
+            auto t = std::stoi(payload.substr(0, 2));
+            auto i = std::stoi(payload.substr(3));
+            intact = t >= 0 && t < n_threads && i > last[t];
+            last[t] = i;
+        }
+        snapshots++;
+    } while (intact && running > 0);
+
+    for (auto &t : threads)
+    {
+        t.join();
+    }
+    REQUIRE(intact);
+    REQUIRE(snapshots > 0);
+
+    sink->snapshot(snap);
+    REQUIRE(!snap.records().empty());
+    REQUIRE(fmt::to_string(snap.records().back().payload).substr(3) == fmt::format("{:08}", n_messages - 1));
+}
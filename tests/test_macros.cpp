@@ -3,6 +3,7 @@
  */
 
 #include "includes.h"
+#include "test_sink.h"
 
 #if SPDLOG_ACTIVE_LEVEL != SPDLOG_LEVEL_DEBUG
 #error "Invalid SPDLOG_ACTIVE_LEVEL in test. Should be SPDLOG_LEVEL_DEBUG"
@@ -58,3 +59,85 @@ TEST_CASE("pass logger pointer", "[macros]")
 //    SPDLOG_LOGGER_DEBUG(logger, "Test message {}", ++x);
 //    REQUIRE(x == 0);
 //}
+
+static void callsite_test_function(const std::shared_ptr<spdlog::logger> &logger)
+{
+    SPDLOG_LOGGER_DEBUG(logger, "from function");
+}
+
+TEST_CASE("callsites", "[macros]")
+{
+    using spdlog::sinks::test_sink_st;
+    auto test_sink = std::make_shared<test_sink_st>();
+    auto logger = std::make_shared<spdlog::logger>("callsites", test_sink);
+    logger->set_pattern("%v");
+    logger->set_level(spdlog::level::debug);
+
+    int evaluated = 0;
+    auto log_all = [&] {
+        SPDLOG_LOGGER_DEBUG(logger, "debug {}", ++evaluated);
+        SPDLOG_LOGGER_INFO(logger, "info");
+        callsite_test_function(logger);
+    };
+
+    log_all();
+    REQUIRE(test_sink->lines().size() == 3);
+    REQUIRE(evaluated == 1);
+
+    // disable the debug sites of this file: their arguments are not evaluated
+    REQUIRE(spdlog::set_callsites_by_file("*test_macros.cpp", false, spdlog::level::debug) >= 2);
+    log_all();
+    REQUIRE(test_sink->lines().size() == 4);
+    REQUIRE(test_sink->lines()[3] == "info");
+    REQUIRE(evaluated == 1);
+
+    // enable back by function name
+    REQUIRE(spdlog::set_callsites_by_function("callsite_test_*", true) == 1);
+    log_all();
+    REQUIRE(test_sink->lines().size() == 6);
+    REQUIRE(test_sink->lines()[5] == "from function");
+
+    spdlog::reset_callsites();
+    log_all();
+    REQUIRE(test_sink->lines().size() == 9);
+    REQUIRE(evaluated == 2);
+
+    REQUIRE(spdlog::details::callsite::glob_match("a*b?d*", "axxbcdyy"));
+    REQUIRE_FALSE(spdlog::details::callsite::glob_match("a*b?d", "axxbcdyy"));
+}
+
+TEST_CASE("callsite evaluation", "[macros]")
+{
+    using spdlog::sinks::test_sink_st;
+    auto test_sink = std::make_shared<test_sink_st>();
+    auto logger = std::make_shared<spdlog::logger>("callsite_evaluation", test_sink);
+    logger->set_pattern("%v");
+    logger->set_level(spdlog::level::debug);
+
+    int logger_evaluated = 0;
+    int args_evaluated = 0;
+    auto get_logger = [&] {
+        ++logger_evaluated;
+        return logger;
+    };
+    auto log_once = [&] { SPDLOG_LOGGER_DEBUG(get_logger(), "debug {}", ++args_evaluated); };
+
+    log_once();
+    REQUIRE(logger_evaluated == 1);
+    REQUIRE(args_evaluated == 1);
+
+    // disabled site: neither the logger nor the arguments are evaluated
+    REQUIRE(spdlog::set_callsites_by_file("*test_macros.cpp", false, spdlog::level::debug) >= 1);
+    log_once();
+    REQUIRE(logger_evaluated == 1);
+    REQUIRE(args_evaluated == 1);
+    spdlog::reset_callsites();
+
+    // a single statement, e.g. as the body of an if without braces
+    if (args_evaluated == 1)
+        SPDLOG_LOGGER_INFO(logger, "if");
+    else
+        SPDLOG_LOGGER_INFO(logger, "else");
+    REQUIRE(test_sink->lines().size() == 2);
+    REQUIRE(test_sink->lines()[1] == "if");
+}
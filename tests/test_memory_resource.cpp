@@ -0,0 +1,163 @@
+/*
+ * This content is released under the MIT License as specified in https://raw.githubusercontent.com/gabime/spdlog/master/LICENSE
+ */
+#include "includes.h"
+#include "test_sink.h"
+#include "spdlog/memory_resource.h"
+#include "spdlog/details/circular_q.h"
+
+#include <atomic>
+
+// new/delete resource counting its allocations and the bytes in use
+class counting_resource final : public spdlog::memory_resource
+{
+public:
+    std::atomic<size_t> allocations{0};
+    std::atomic<size_t> bytes_in_use{0};
+
+private:
+    void *do_allocate(size_t bytes, size_t alignment) override
+    {
+        allocations++;
+        bytes_in_use += bytes;
+        return spdlog::new_delete_resource()->allocate(bytes, alignment);
+    }
+
+    void do_deallocate(void *p, size_t bytes, size_t alignment) override
+    {
+        bytes_in_use -= bytes;
+        spdlog::new_delete_resource()->deallocate(p, bytes, alignment);
+    }
+
+    bool do_is_equal(const spdlog::memory_resource &other) const SPDLOG_NOEXCEPT override
+    {
+        return this == &other;
+    }
+};
+
+static spdlog::details::log_msg make_msg(spdlog::string_view_t payload)
+{
+    return spdlog::details::log_msg{"memory_resource", spdlog::level::info, payload};
+}
+
+TEST_CASE("log_msg_buffer", "[memory_resource]")
+{
+    counting_resource resource;
+    std::string long_payload(1000, 'x'); // longer than the inline storage
+    {
+        spdlog::details::log_msg_buffer buffer{make_msg(long_payload), &resource};
+        REQUIRE(buffer.resource() == &resource);
+        REQUIRE(resource.allocations == 1);
+        REQUIRE(std::string(buffer.payload.data(), buffer.payload.size()) == long_payload);
+
+        // copies use the resource of the original, moves take it along
+        spdlog::details::log_msg_buffer copy{buffer};
+        REQUIRE(copy.resource() == &resource);
+        REQUIRE(resource.allocations == 2);
+        spdlog::details::log_msg_buffer moved{std::move(copy)};
+        REQUIRE(moved.resource() == &resource);
+        REQUIRE(resource.allocations == 2);
+
+        // assign reuses the capacity
+        moved.assign(make_msg("short"));
+        REQUIRE(std::string(moved.payload.data(), moved.payload.size()) == "short");
+        REQUIRE(resource.allocations == 2);
+
+        spdlog::details::log_msg_buffer short_buffer{make_msg("short"), &resource};
+        REQUIRE(resource.allocations == 2);
+    }
+    REQUIRE(resource.bytes_in_use == 0);
+
+    spdlog::details::log_msg_buffer default_buffer{make_msg("default")};
+    REQUIRE(default_buffer.resource() == spdlog::get_default_resource());
+}
+
+TEST_CASE("circular_q", "[memory_resource]")
+{
+    counting_resource resource;
+    {
+        spdlog::details::circular_q<int> q{10, &resource};
+        REQUIRE(resource.allocations == 1);
+        REQUIRE(resource.bytes_in_use == 11 * sizeof(int));
+        q.push_back(1);
+
+        // moving the queue doesn't reallocate its items
+        spdlog::details::circular_q<int> moved;
+        moved = std::move(q);
+        REQUIRE(resource.allocations == 1);
+        REQUIRE(moved.size() == 1);
+        REQUIRE(moved.front() == 1);
+    }
+    REQUIRE(resource.bytes_in_use == 0);
+}
+
+TEST_CASE("pattern_formatter", "[memory_resource]")
+{
+    counting_resource resource;
+    std::string pattern = "[%n] [%l] %v %8!n %%";
+    spdlog::details::log_msg msg = make_msg("message");
+    {
+        spdlog::pattern_formatter formatter(pattern, spdlog::pattern_time_type::local, "\n", {}, &resource);
+        auto compiled_bytes = resource.bytes_in_use.load();
+        REQUIRE(compiled_bytes > 0);
+
+        auto cloned = formatter.clone();
+        REQUIRE(resource.bytes_in_use == 2 * compiled_bytes);
+
+        spdlog::pattern_formatter default_formatter(pattern, spdlog::pattern_time_type::local, "\n");
+        spdlog::memory_buf_t formatted;
+        spdlog::memory_buf_t cloned_formatted;
+        spdlog::memory_buf_t default_formatted;
+        formatter.format(msg, formatted);
+        cloned->format(msg, cloned_formatted);
+        default_formatter.format(msg, default_formatted);
+        REQUIRE(fmt::to_string(formatted) == "[memory_resource] [info] message memory_r %\n");
+        REQUIRE(fmt::to_string(cloned_formatted) == fmt::to_string(formatted));
+        REQUIRE(fmt::to_string(default_formatted) == fmt::to_string(formatted));
+
+        formatter.set_pattern("%v");
+        REQUIRE(resource.bytes_in_use < 2 * compiled_bytes);
+    }
+    REQUIRE(resource.bytes_in_use == 0);
+}
+
+TEST_CASE("async queue", "[memory_resource]")
+{
+    counting_resource resource;
+    auto test_sink = std::make_shared<spdlog::sinks::test_sink_mt>();
+    std::string long_payload(1000, 'x');
+    size_t messages = 100;
+    {
+        auto tp = std::make_shared<spdlog::details::thread_pool>(16, 1, [] {}, &resource);
+        REQUIRE(tp->resource() == &resource);
+        auto queue_allocations = resource.allocations.load();
+        REQUIRE(queue_allocations == 1);
+
+        auto logger = std::make_shared<spdlog::async_logger>("as", test_sink, tp, spdlog::async_overflow_policy::block);
+        for (size_t i = 0; i < messages; i++)
+        {
+            logger->info("{} #{}", long_payload, i);
+        }
+        logger->flush();
+        REQUIRE(resource.allocations == queue_allocations + messages);
+    }
+    REQUIRE(test_sink->msg_counter() == messages);
+    REQUIRE(resource.bytes_in_use == 0);
+}
+
+TEST_CASE("default resource", "[memory_resource]")
+{
+    counting_resource resource;
+    REQUIRE(spdlog::get_default_resource() == spdlog::new_delete_resource());
+    REQUIRE(spdlog::set_default_resource(&resource) == spdlog::new_delete_resource());
+    {
+        spdlog::details::log_msg_buffer buffer{make_msg(std::string(1000, 'x'))};
+        REQUIRE(buffer.resource() == &resource);
+        REQUIRE(resource.allocations == 1);
+        spdlog::pattern_formatter formatter;
+        REQUIRE(resource.allocations > 1);
+    }
+    REQUIRE(spdlog::set_default_resource(nullptr) == &resource);
+    REQUIRE(spdlog::get_default_resource() == spdlog::new_delete_resource());
+    REQUIRE(resource.bytes_in_use == 0);
+}
@@ -1,6 +1,7 @@
 #include "includes.h"
 #include "test_sink.h"
 #include "spdlog/fmt/bin_to_hex.h"
+#include "spdlog/fmt/ostr.h"
 
 template<class T>
 std::string log_info(const T &what, spdlog::level::level_enum logger_level = spdlog::level::info)
@@ -44,6 +45,104 @@ TEST_CASE("log_levels", "[log_levels]")
     REQUIRE(log_info("Hello", spdlog::level::trace) == "Hello");
 }
 
+// counts how many times it was formatted
+struct format_counter
+{
+    int *count;
+};
+
+std::ostream &operator<<(std::ostream &os, const format_counter &c)
+{
+    (*c.count)++;
+    return os << "counted";
+}
+
+TEST_CASE("sink_levels", "[log_levels]")
+{
+    int formatted = 0;
+    auto info_sink = std::make_shared<spdlog::sinks::test_sink_st>();
+    info_sink->set_level(spdlog::level::info);
+    spdlog::logger logger("test", info_sink);
+    logger.set_level(spdlog::level::trace);
+
+    // rejected by every sink: not even formatted
+    logger.debug("{}", format_counter{&formatted});
+    REQUIRE(formatted == 0);
+    logger.info("{}", format_counter{&formatted});
+    REQUIRE(formatted == 1);
+    REQUIRE(info_sink->msg_counter() == 1);
+
+    // the minimum sink level follows the sink levels
+    info_sink->set_level(spdlog::level::debug);
+    logger.debug("{}", format_counter{&formatted});
+    REQUIRE(formatted == 2);
+    REQUIRE(info_sink->msg_counter() == 2);
+
+    // and the sinks of the logger
+    auto trace_sink = std::make_shared<spdlog::sinks::test_sink_st>();
+    logger.sinks().push_back(trace_sink);
+    logger.trace("{}", format_counter{&formatted});
+    REQUIRE(formatted == 3);
+    REQUIRE(trace_sink->msg_counter() == 1);
+    REQUIRE(info_sink->msg_counter() == 2);
+}
+
+TEST_CASE("sink_levels add and remove sinks", "[log_levels]")
+{
+    auto info_sink = std::make_shared<spdlog::sinks::test_sink_st>();
+    info_sink->set_level(spdlog::level::info);
+    auto debug_sink = std::make_shared<spdlog::sinks::test_sink_st>();
+    debug_sink->set_level(spdlog::level::debug);
+    spdlog::logger logger("test", info_sink);
+    logger.set_level(spdlog::level::trace);
+
+    logger.debug("rejected");
+    logger.add_sink(debug_sink);
+    logger.debug("accepted");
+    REQUIRE(debug_sink->msg_counter() == 1);
+
+    REQUIRE(logger.remove_sink(debug_sink));
+    REQUIRE_FALSE(logger.remove_sink(debug_sink));
+    REQUIRE(logger.sinks().size() == 1);
+    logger.debug("rejected");
+    REQUIRE(debug_sink->msg_counter() == 1);
+    REQUIRE(info_sink->msg_counter() == 0);
+}
+
+TEST_CASE("sink_levels mutable sinks", "[log_levels]")
+{
+    auto info_sink = std::make_shared<spdlog::sinks::test_sink_st>();
+    info_sink->set_level(spdlog::level::info);
+    auto debug_sink = std::make_shared<spdlog::sinks::test_sink_st>();
+    debug_sink->set_level(spdlog::level::debug);
+    spdlog::logger logger("test", info_sink);
+    logger.set_level(spdlog::level::trace);
+
+    // a message logged between sinks() and the change doesn't hide the new sink
+    auto &sinks = logger.sinks();
+    logger.debug("rejected");
+    sinks.push_back(debug_sink);
+    logger.debug("accepted");
+    REQUIRE(debug_sink->msg_counter() == 1);
+    REQUIRE(info_sink->msg_counter() == 0);
+}
+
+TEST_CASE("sink_levels flush_on", "[log_levels]")
+{
+    auto info_sink = std::make_shared<spdlog::sinks::test_sink_st>();
+    info_sink->set_level(spdlog::level::info);
+    spdlog::logger logger("test", info_sink);
+    logger.set_level(spdlog::level::trace);
+    logger.flush_on(spdlog::level::debug);
+
+    // rejected by every sink, but still flushes
+    logger.trace("no flush");
+    REQUIRE(info_sink->flush_counter() == 0);
+    logger.debug("flush");
+    REQUIRE(info_sink->msg_counter() == 0);
+    REQUIRE(info_sink->flush_counter() == 1);
+}
+
 TEST_CASE("level_to_string_view", "[convert_to_string_view")
 {
     REQUIRE(spdlog::level::to_string_view(spdlog::level::trace) == "trace");
@@ -92,6 +191,87 @@ TEST_CASE("periodic flush", "[periodic_flush]")
     spdlog::drop_all();
 }
 
+TEST_CASE("periodic flush dirty", "[periodic_flush]")
+{
+    using spdlog::sinks::test_sink_mt;
+    auto test_sink = std::make_shared<test_sink_mt>();
+    auto logger = std::make_shared<spdlog::logger>("periodic_flush_dirty", test_sink);
+
+    spdlog::flush_every(logger, std::chrono::milliseconds(10));
+    std::this_thread::sleep_for(std::chrono::milliseconds(100));
+    REQUIRE(test_sink->flush_counter() == 0);
+
+    logger->info("Test message");
+    REQUIRE(logger->dirty());
+    std::this_thread::sleep_for(std::chrono::milliseconds(100));
+    REQUIRE(test_sink->flush_counter() == 1);
+    REQUIRE_FALSE(logger->dirty());
+    std::this_thread::sleep_for(std::chrono::milliseconds(100));
+    REQUIRE(test_sink->flush_counter() == 1);
+
+    spdlog::flush_every(logger, std::chrono::milliseconds(0));
+    logger->info("Test message");
+    std::this_thread::sleep_for(std::chrono::milliseconds(100));
+    REQUIRE(test_sink->flush_counter() == 1);
+}
+
+TEST_CASE("max unflushed bytes", "[periodic_flush]")
+{
+    auto test_sink = std::make_shared<spdlog::sinks::test_sink_st>();
+    test_sink->set_max_unflushed_bytes(10);
+    spdlog::logger logger("test", test_sink);
+
+    logger.info("12345");
+    REQUIRE(test_sink->flush_counter() == 0);
+    REQUIRE(test_sink->unflushed_bytes() == 6);
+    logger.info("12345");
+    REQUIRE(test_sink->flush_counter() == 1);
+    REQUIRE_FALSE(test_sink->dirty());
+
+    logger.flush_dirty();
+    REQUIRE(test_sink->flush_counter() == 1);
+    logger.info("");
+    logger.flush_dirty();
+    REQUIRE(test_sink->flush_counter() == 2);
+}
+
+TEST_CASE("flush_scheduler", "[periodic_flush]")
+{
+    std::atomic<int> fast_runs{0};
+    std::atomic<int> slow_runs{0};
+    std::atomic<int> once_runs{0};
+    {
+        spdlog::details::flush_scheduler scheduler;
+        scheduler.add(
+            [&] {
+                fast_runs++;
+                return true;
+            },
+            std::chrono::milliseconds(2));
+        auto slow_id = scheduler.add(
+            [&] {
+                slow_runs++;
+                return true;
+            },
+            std::chrono::milliseconds(1500)); // due in the second turn of the wheel
+        scheduler.add(
+            [&] {
+                once_runs++;
+                return false;
+            },
+            std::chrono::milliseconds(1));
+        REQUIRE(scheduler.size() == 3);
+
+        std::this_thread::sleep_for(std::chrono::milliseconds(200));
+        REQUIRE(scheduler.size() == 2);
+        scheduler.remove(slow_id);
+        REQUIRE(scheduler.size() == 1);
+    }
+    REQUIRE(fast_runs > 10);
+    REQUIRE(slow_runs == 0);
+    REQUIRE(once_runs == 1);
+}
+
 TEST_CASE("clone-logger", "[clone]")
 {
     using spdlog::sinks::test_sink_mt;
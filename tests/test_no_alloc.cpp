@@ -0,0 +1,159 @@
+/*
+ * This content is released under the MIT License as specified in https://raw.githubusercontent.com/gabime/spdlog/master/LICENSE
+ */
+#include "includes.h"
+#include "spdlog/sinks/dist_sink.h"
+#include "spdlog/sinks/dup_filter_sink.h"
+#include "spdlog/sinks/ringbuffer_sink.h"
+#include "spdlog/sinks/stdout_sinks.h"
+
+#include <atomic>
+#include <cstdlib>
+#include <new>
+
+// Count the allocations of the calling thread while armed (replaces the global operator new of the test program).
+// The direct malloc() calls are not counted: spdlog only makes them through stdio, when a file is first written.
+static thread_local bool count_allocations = false;
+static std::atomic<size_t> allocations{0};
+
+// operator new/delete are implemented with malloc/free: gcc warns on each delete inlined in this file
+#if defined(__GNUC__) && !defined(__clang__) && __GNUC__ >= 11
+#pragma GCC diagnostic ignored "-Wmismatched-new-delete"
+#endif
+
+void *operator new(std::size_t size)
+{
+    if (count_allocations)
+    {
+        allocations++;
+    }
+    if (void *p = std::malloc(size == 0 ? 1 : size))
+    {
+        return p;
+    }
+    throw std::bad_alloc();
+}
+
+void *operator new[](std::size_t size)
+{
+    return ::operator new(size);
+}
+
+void operator delete(void *p) SPDLOG_NOEXCEPT
+{
+    std::free(p);
+}
+
+void operator delete[](void *p) SPDLOG_NOEXCEPT
+{
+    std::free(p);
+}
+
+template<typename Fn>
+static size_t allocations_in(Fn fn)
+{
+    allocations = 0;
+    count_allocations = true;
+    fn();
+    count_allocations = false;
+    return allocations.load();
+}
+
+static size_t allocations_after_warmup(spdlog::sink_ptr sink)
+{
+    spdlog::logger logger("no_alloc", std::move(sink));
+    std::string long_arg(1000, 'x'); // longer than the inline storage of memory_buf_t
+    auto log_messages = [&logger, &long_arg]() {
+        for (int i = 0; i < 10; i++)
+        {
+            logger.info("short message {}", i);
+            logger.warn("long message {} {} {}", long_arg, i, 3.14);
+            logger.debug("disabled message {}", long_arg);
+        }
+    };
+    log_messages(); // warm-up
+    return allocations_in(log_messages);
+}
+
+TEST_CASE("no allocation after warm-up", "[no_alloc]")
+{
+    prepare_logdir();
+    using namespace spdlog::sinks;
+
+    REQUIRE(allocations_after_warmup(std::make_shared<null_sink_mt>()) == 0);
+    REQUIRE(allocations_after_warmup(std::make_shared<basic_file_sink_mt>("test_logs/no_alloc_basic.txt")) == 0);
+    REQUIRE(allocations_after_warmup(std::make_shared<rotating_file_sink_mt>("test_logs/no_alloc_rotating.txt", 1024 * 1024, 2)) == 0);
+    REQUIRE(allocations_after_warmup(std::make_shared<daily_file_sink_mt>("test_logs/no_alloc_daily.txt", 0, 0)) == 0);
+    REQUIRE(allocations_after_warmup(std::make_shared<ringbuffer_sink_mt>(5)) == 0);
+    REQUIRE(allocations_after_warmup(std::make_shared<dup_filter_sink_mt>(std::chrono::seconds(5))) == 0);
+
+    std::ofstream ofs("test_logs/no_alloc_ostream.txt");
+    REQUIRE(allocations_after_warmup(std::make_shared<ostream_sink_mt>(ofs)) == 0);
+
+    auto dist = std::make_shared<dist_sink_mt>();
+    dist->add_sink(std::make_shared<null_sink_st>());
+    dist->add_sink(std::make_shared<basic_file_sink_st>("test_logs/no_alloc_dist.txt"));
+    REQUIRE(allocations_after_warmup(dist) == 0);
+
+    auto file = std::fopen("test_logs/no_alloc_console.txt", "wb");
+    REQUIRE(file != nullptr);
+    using spdlog::details::console_mutex;
+    REQUIRE(allocations_after_warmup(std::make_shared<stdout_sink_base<console_mutex>>(file)) == 0);
+    REQUIRE(allocations_after_warmup(std::make_shared<ansicolor_sink<console_mutex>>(file, spdlog::color_mode::always)) == 0);
+    std::fclose(file);
+}
+
+TEST_CASE("no allocation in deferred backtrace", "[no_alloc]")
+{
+    spdlog::logger logger("no_alloc", std::make_shared<spdlog::sinks::null_sink_mt>());
+    logger.set_level(spdlog::level::info);
+    logger.enable_backtrace(16);
+    std::string str_arg = "string argument";
+    auto log_messages = [&logger, &str_arg]() {
+        for (int i = 0; i < 32; i++)
+        {
+            logger.debug("backtrace only message {} {} {} {}", str_arg, i, 3.14, "literal");
+        }
+    };
+    log_messages(); // warm-up: fills the ring
+    REQUIRE(allocations_in(log_messages) == 0);
+}
+
+TEST_CASE("no allocation in deferred backtrace after a dump", "[no_alloc]")
+{
+    spdlog::logger logger("no_alloc", std::make_shared<spdlog::sinks::null_sink_mt>());
+    logger.set_level(spdlog::level::info);
+    logger.enable_backtrace(16);
+    for (int i = 0; i < 32; i++) // warm-up: fills the ring
+    {
+        logger.debug("backtrace only message {}", i);
+    }
+    logger.dump_backtrace();
+    // the ring of this (live) thread is kept by the dump, and its spare message is reused
+    REQUIRE(allocations_in([&logger]() { logger.debug("backtrace only message {}", 32); }) == 0);
+}
+
+TEST_CASE("thread_buffer nesting", "[no_alloc]")
+{
+    using spdlog::details::thread_buffer;
+    spdlog::memory_buf_t *slot_buf;
+    {
+        thread_buffer outer(thread_buffer::payload);
+        slot_buf = &outer.get();
+        fmt::format_to(outer.get(), "outer");
+        {
+            // nested use of the same slot: gets its own buffer
+            thread_buffer inner(thread_buffer::payload);
+            REQUIRE(&inner.get() != slot_buf);
+            fmt::format_to(inner.get(), "inner");
+            thread_buffer sink(thread_buffer::sink);
+            REQUIRE(sink.get().size() == 0);
+        }
+        REQUIRE(std::string(outer.get().data(), outer.get().size()) == "outer");
+    }
+
+    // the slot is free again, and cleared
+    thread_buffer again(thread_buffer::payload);
+    REQUIRE(&again.get() == slot_buf);
+    REQUIRE(again.get().size() == 0);
+}
@@ -1,6 +1,12 @@
 #include "includes.h"
 #include "test_sink.h"
 
+#include <thread>
+#ifndef _WIN32
+#include <sys/wait.h>
+#include <unistd.h>
+#endif
+
 using spdlog::memory_buf_t;
 
 // log to str and return it
@@ -406,6 +412,45 @@ TEST_CASE("full filename formatter", "[pattern_formatter]")
     REQUIRE(fmt::to_string(formatted) == test_path);
 }
 
+TEST_CASE("callsite descriptors", "[pattern_formatter]")
+{
+    // an explicit location gets an interned descriptor, with copies of its names
+    std::string path_copy = test_path;
+    spdlog::source_loc loc{path_copy.c_str(), 123, "some_func()"};
+    spdlog::details::log_msg msg(loc, "logger-name", spdlog::level::info, "Hello");
+    REQUIRE(msg.source != nullptr);
+    REQUIRE(msg.source->filename() != path_copy.c_str());
+    REQUIRE(msg.source->line() == 123);
+    REQUIRE(spdlog::details::source_filename(*msg.source) == spdlog::string_view_t(test_path));
+    REQUIRE(spdlog::details::source_short_filename(*msg.source) == spdlog::string_view_t("myfile.cpp"));
+    REQUIRE(spdlog::details::source_funcname(*msg.source) == spdlog::string_view_t("some_func()"));
+    spdlog::details::log_msg same_loc_msg(loc, "logger-name", spdlog::level::info, "Hello again");
+    REQUIRE(same_loc_msg.source == msg.source);
+    path_copy.assign(path_copy.size(), 'x');
+    REQUIRE(spdlog::details::source_short_filename(*msg.source) == spdlog::string_view_t("myfile.cpp"));
+
+    spdlog::details::log_msg no_loc_msg(spdlog::source_loc{}, "logger-name", spdlog::level::info, "Hello");
+    REQUIRE(no_loc_msg.source == nullptr);
+
+    // log macros refer to their static descriptor
+    auto test_sink = std::make_shared<spdlog::sinks::test_sink_st>();
+    auto logger = std::make_shared<spdlog::logger>("callsite", test_sink);
+    logger->set_pattern("%s:%#|%v");
+    int line = 0;
+    for (int i = 0; i < 2; i++)
+    {
+        line = __LINE__ + 1;
+        SPDLOG_LOGGER_INFO(logger, "message {}", i);
+    }
+    REQUIRE(test_sink->lines().size() == 2);
+    REQUIRE(test_sink->lines()[0] == fmt::format("test_pattern_formatter.cpp:{}|message 0", line));
+    REQUIRE(test_sink->lines()[1] == fmt::format("test_pattern_formatter.cpp:{}|message 1", line));
+
+    // the names of an explicit location are formatted the same way
+    logger->log(loc, spdlog::level::info, "explicit");
+    REQUIRE(test_sink->lines()[2] == "myfile.cpp:123|explicit");
+}
+
 TEST_CASE("custom flags", "[pattern_formatter]")
 {
     auto formatter = std::make_shared<spdlog::pattern_formatter>();
@@ -441,3 +486,60 @@ TEST_CASE("custom flags-exception", "[pattern_formatter]")
     spdlog::details::log_msg msg(spdlog::source_loc{}, "logger-name", spdlog::level::info, "some message");
     CHECK_THROWS_AS(formatter->format(msg, formatted), spdlog::spdlog_ex);
 }
+
+TEST_CASE("thread name", "[pattern_formatter]")
+{
+    spdlog::set_thread_name("main");
+    REQUIRE(log_to_str("Some message", "[%N] %v", spdlog::pattern_time_type::local, "\n") == "[main] Some message\n");
+    REQUIRE(log_to_str("Some message", "[%6N] %v", spdlog::pattern_time_type::local, "\n") == "[  main] Some message\n");
+
+    // names are per thread, and truncated to max_thread_name_len
+    std::string unnamed_result;
+    std::string other_result;
+    std::thread other([&unnamed_result, &other_result] {
+        unnamed_result = log_to_str("Some message", "[%N] %v", spdlog::pattern_time_type::local, "\n");
+        spdlog::set_thread_name("a_very_long_thread_name");
+        other_result = log_to_str("Some message", "[%N] %v", spdlog::pattern_time_type::local, "\n");
+    });
+    other.join();
+    REQUIRE(unnamed_result == "[] Some message\n");
+    REQUIRE(other_result == "[a_very_long_thr] Some message\n");
+
+    // the name is copied by log_msg_buffer (e.g. for async loggers and backtraces)
+    spdlog::set_thread_name("other");
+    spdlog::details::log_msg named_msg(spdlog::source_loc{}, "logger-name", spdlog::level::info, "some message");
+    spdlog::details::log_msg_buffer named_buffer{named_msg};
+    spdlog::set_thread_name("");
+    REQUIRE(std::string(named_buffer.thread_name.data(), named_buffer.thread_name.size()) == "other");
+}
+
+TEST_CASE("pid", "[pattern_formatter]")
+{
+    auto pid = std::to_string(spdlog::details::os::pid());
+    REQUIRE(log_to_str("Some message", "[%P] %v", spdlog::pattern_time_type::local, "\n") == "[" + pid + "] Some message\n");
+#ifndef _WIN32
+    REQUIRE(spdlog::details::os::pid() == static_cast<int>(::getpid()));
+#endif
+}
+
+#ifndef _WIN32
+TEST_CASE("pid after fork", "[pattern_formatter]")
+{
+    auto parent_pid = spdlog::details::os::pid(); // cached in the parent
+    pid_t child = ::fork();
+    REQUIRE(child >= 0);
+    if (child == 0)
+    {
+        // no Catch assertions in the child: report through the exit status
+        auto expected = "[" + std::to_string(::getpid()) + "] Some message\n";
+        bool ok = spdlog::details::os::pid() == static_cast<int>(::getpid()) && spdlog::details::os::pid() != parent_pid &&
+                  log_to_str("Some message", "[%P] %v", spdlog::pattern_time_type::local, "\n") == expected;
+        ::_exit(ok ? 0 : 1);
+    }
+    int status = 0;
+    REQUIRE(::waitpid(child, &status, 0) == child);
+    REQUIRE(WIFEXITED(status));
+    REQUIRE(WEXITSTATUS(status) == 0);
+    REQUIRE(spdlog::details::os::pid() == parent_pid);
+}
+#endif
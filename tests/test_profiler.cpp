@@ -0,0 +1,93 @@
+#include "includes.h"
+#include "spdlog/details/profiler.h"
+#include "test_sink.h"
+
+using spdlog::details::profiling::histogram;
+
+TEST_CASE("histogram buckets", "[profiler]")
+{
+    // contiguous and increasing bucket bounds
+    for (size_t i = 1; i < histogram::n_buckets; i++)
+    {
+        REQUIRE(histogram::bucket_lower_bound(i) > histogram::bucket_lower_bound(i - 1));
+        REQUIRE(histogram::bucket_index(histogram::bucket_lower_bound(i)) == i);
+        REQUIRE(histogram::bucket_index(histogram::bucket_lower_bound(i) - 1) == i - 1);
+    }
+    REQUIRE(histogram::bucket_index(0) == 0);
+    REQUIRE(histogram::bucket_index(UINT64_MAX) == histogram::n_buckets - 1);
+}
+
+TEST_CASE("histogram percentiles", "[profiler]")
+{
+    histogram h;
+    REQUIRE(h.percentile(0.5) == 0);
+    for (uint64_t i = 1; i <= 1000; i++)
+    {
+        h.record(i);
+    }
+    REQUIRE(h.count() == 1000);
+    REQUIRE(h.sum() == 500500);
+    REQUIRE(h.max() == 1000);
+
+    // at most 25% error
+    auto p50 = h.percentile(0.5);
+    auto p99 = h.percentile(0.99);
+    REQUIRE(p50 >= 375);
+    REQUIRE(p50 <= 625);
+    REQUIRE(p99 >= 742);
+    REQUIRE(p99 <= 1238);
+
+    h.reset();
+    REQUIRE(h.count() == 0);
+    REQUIRE(h.max() == 0);
+}
+
+#ifdef SPDLOG_ENABLE_PROFILING
+using spdlog::details::profiling::stage;
+
+TEST_CASE("profile sync logger", "[profiler]")
+{
+    prepare_logdir();
+    auto logger = spdlog::basic_logger_mt("profiled", "test_logs/profiler.txt", true);
+    for (int i = 0; i < 10; i++)
+    {
+        logger->info("Hello {}", i);
+    }
+
+    auto &sink = logger->sinks()[0];
+    REQUIRE(logger->profile().get(stage::format).count() == 10);
+    REQUIRE(logger->profile().get(stage::enqueue).count() == 0);
+    REQUIRE(sink->profile().get(stage::pattern_format).count() == 10);
+    REQUIRE(sink->profile().get(stage::sink_write).count() == 10);
+
+    auto dump = spdlog::dump_profiles();
+    REQUIRE(dump.find("profiled format count=10 ") != std::string::npos);
+    REQUIRE(dump.find("profiled/sink#0 sink_write count=10 ") != std::string::npos);
+
+    spdlog::reset_profiles();
+    REQUIRE(logger->profile().get(stage::format).count() == 0);
+    REQUIRE(sink->profile().get(stage::sink_write).count() == 0);
+    spdlog::drop_all();
+}
+
+TEST_CASE("profile async logger", "[profiler]")
+{
+    auto test_sink = std::make_shared<spdlog::sinks::test_sink_mt>();
+    auto tp = std::make_shared<spdlog::details::thread_pool>(128, 1);
+    auto logger = std::make_shared<spdlog::async_logger>("as", test_sink, tp, spdlog::async_overflow_policy::block);
+    for (int i = 0; i < 10; i++)
+    {
+        logger->info("Hello {}", i);
+    }
+    logger->flush();
+    while (test_sink->flush_counter() == 0)
+    {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+
+    REQUIRE(logger->profile().get(stage::format).count() == 10);
+    REQUIRE(logger->profile().get(stage::enqueue).count() == 11); // including the flush
+    REQUIRE(logger->profile().get(stage::queue_wait).count() == 10);
+    REQUIRE(test_sink->profile().get(stage::pattern_format).count() == 10);
+}
+#endif
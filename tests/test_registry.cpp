@@ -114,3 +114,57 @@ TEST_CASE("disable automatic registration", "[registry]")
     spdlog::set_level(spdlog::level::info);
     spdlog::set_automatic_registration(true);
 }
+
+TEST_CASE("logger_handle", "[registry]")
+{
+    spdlog::drop_all();
+    spdlog::logger_handle handle(tested_logger_name);
+    REQUIRE_FALSE(handle.get());
+
+    auto logger = spdlog::create<spdlog::sinks::null_sink_mt>(tested_logger_name);
+    REQUIRE(handle.get() == logger);
+    REQUIRE(handle->name() == tested_logger_name);
+
+    // not affected by other loggers
+    spdlog::create<spdlog::sinks::null_sink_mt>(tested_logger_name2);
+    REQUIRE(handle.get() == logger);
+
+    spdlog::drop(tested_logger_name);
+    REQUIRE_FALSE(handle.get());
+    spdlog::drop_all();
+}
+
+TEST_CASE("get while registering", "[registry]")
+{
+    spdlog::drop_all();
+    auto logger = spdlog::create<spdlog::sinks::null_sink_mt>(tested_logger_name);
+
+    std::atomic<bool> done{false};
+    std::atomic<size_t> misses{0};
+    std::vector<std::thread> readers;
+    for (int i = 0; i < 2; i++)
+    {
+        readers.emplace_back([&] {
+            while (!done)
+            {
+                if (spdlog::get(tested_logger_name) != logger)
+                {
+                    ++misses;
+                }
+                spdlog::get(tested_logger_name2);
+            }
+        });
+    }
+    for (int i = 0; i < 200; i++)
+    {
+        spdlog::create<spdlog::sinks::null_sink_mt>(tested_logger_name2);
+        spdlog::drop(tested_logger_name2);
+    }
+    done = true;
+    for (auto &t : readers)
+    {
+        t.join();
+    }
+    REQUIRE(misses == 0);
+    spdlog::drop_all();
+}
@@ -79,6 +79,165 @@ TEST_CASE("stderr_color_mt", "[stderr]")
     spdlog::drop_all();
 }
 
+static FILE *open_console_file(const char *filename)
+{
+    prepare_logdir();
+    spdlog::details::os::create_dir(SPDLOG_FILENAME_T("test_logs"));
+    return fopen(filename, "wb");
+}
+
+TEST_CASE("console_buffering line", "[stdout]")
+{
+    const char *filename = "test_logs/console_line.txt";
+    FILE *file = open_console_file(filename);
+    REQUIRE(file != nullptr);
+    {
+        auto sink = std::make_shared<spdlog::sinks::stdout_sink_base<spdlog::details::console_mutex>>(file);
+        sink->set_pattern("%v");
+        spdlog::logger l("test", sink);
+        l.info("line 1");
+        REQUIRE(file_contents(filename) == std::string("line 1") + spdlog::details::os::default_eol);
+    }
+    fclose(file);
+}
+
+TEST_CASE("console_buffering block", "[stdout]")
+{
+    const char *filename = "test_logs/console_block.txt";
+    FILE *file = open_console_file(filename);
+    REQUIRE(file != nullptr);
+    {
+        auto sink = std::make_shared<spdlog::sinks::stdout_sink_base<spdlog::details::console_nullmutex>>(file);
+        sink->set_pattern("%v");
+        sink->set_buffering(spdlog::console_buffering::block, std::chrono::hours(1), 16);
+        spdlog::logger l("test", sink);
+        l.info("line 1");
+        REQUIRE(get_filesize(filename) == 0);
+        l.info("line 2");
+        l.info("line 3");
+        // the block size was reached: the 3 lines are written at once
+        REQUIRE(count_lines(filename) == 3);
+        l.info("line 4");
+        REQUIRE(count_lines(filename) == 3);
+        l.flush();
+        REQUIRE(count_lines(filename) == 4);
+        l.info("line 5");
+    }
+    // the pending lines are written on destruction
+    REQUIRE(count_lines(filename) == 5);
+    fclose(file);
+}
+
+TEST_CASE("console_buffering automatic", "[stdout]")
+{
+    const char *filename = "test_logs/console_automatic.txt";
+    FILE *file = open_console_file(filename);
+    REQUIRE(file != nullptr);
+    {
+        // not a terminal: block buffered, flushed within max_latency by the background flusher
+        auto sink = std::make_shared<spdlog::sinks::stdout_sink_base<spdlog::details::console_mutex>>(file);
+        sink->set_buffering(spdlog::console_buffering::automatic, std::chrono::milliseconds(20));
+        spdlog::logger l("test", sink);
+        l.info("line 1");
+        for (int i = 0; i < 500 && get_filesize(filename) == 0; i++)
+        {
+            std::this_thread::sleep_for(std::chrono::milliseconds(10));
+        }
+        REQUIRE(count_lines(filename) == 1);
+    }
+    fclose(file);
+}
+
+#ifndef _WIN32
+TEST_CASE("console_buffering color", "[stdout]")
+{
+    const char *filename = "test_logs/console_color.txt";
+    FILE *file = open_console_file(filename);
+    REQUIRE(file != nullptr);
+    {
+        auto sink = std::make_shared<spdlog::sinks::ansicolor_sink<spdlog::details::console_mutex>>(file, spdlog::color_mode::always);
+        sink->set_pattern("[%^%l%$] %v");
+        sink->set_buffering(spdlog::console_buffering::block, std::chrono::hours(1));
+        spdlog::logger l("test", sink);
+        l.info("line 1");
+        l.warn("line 2");
+        REQUIRE(get_filesize(filename) == 0);
+        l.flush();
+        auto expected = fmt::format("[{}info{}] line 1{}[{}warning{}] line 2{}", sink->green, sink->reset, spdlog::details::os::default_eol,
+            sink->yellow_bold, sink->reset, spdlog::details::os::default_eol);
+        REQUIRE(file_contents(filename) == expected);
+    }
+    fclose(file);
+}
+#endif
+
+TEST_CASE("batch_handler", "[stdout]")
+{
+    using sink_type = spdlog::sinks::stdout_sink_base<spdlog::details::console_mutex>;
+    std::vector<std::string> lines;
+    size_t batches = 0;
+    size_t dropped = 0;
+    auto sink = std::make_shared<sink_type>(stdout);
+    sink->set_pattern("%v");
+    sink->set_batch_handler(
+        [&](const spdlog::log_batch &batch) {
+            batches++;
+            dropped += batch.dropped;
+            for (auto &line : batch.lines)
+            {
+                lines.push_back(fmt::to_string(line));
+            }
+        },
+        std::chrono::hours(1), 3);
+    spdlog::logger l("test", sink);
+
+    for (int i = 0; i < 5; i++)
+    {
+        l.info("message {}", i);
+    }
+    REQUIRE(batches == 0);
+    l.flush();
+    REQUIRE(batches == 1);
+    REQUIRE(lines.size() == 3);
+    REQUIRE(lines[2] == std::string("message 2") + spdlog::details::os::default_eol);
+    REQUIRE(dropped == 2);
+    REQUIRE(sink->dropped_messages() == 2);
+    REQUIRE(sink->delivered_messages() == 3);
+
+    // the queue is empty again
+    l.info("message 5");
+    l.flush();
+    REQUIRE(batches == 2);
+    REQUIRE(lines.back() == std::string("message 5") + spdlog::details::os::default_eol);
+    REQUIRE(dropped == 2);
+
+    // the remaining messages go to the previous handler
+    l.info("message 6");
+    sink->set_batch_handler(nullptr);
+    REQUIRE(batches == 3);
+    REQUIRE(lines.size() == 5);
+}
+
+TEST_CASE("batch_handler background", "[stdout]")
+{
+    using sink_type = spdlog::sinks::stdout_sink_base<spdlog::details::console_mutex>;
+    std::atomic<size_t> received{0};
+    auto sink = std::make_shared<sink_type>(stdout);
+    sink->set_batch_handler(
+        [&](const spdlog::log_batch &batch) { received += batch.lines.size(); }, std::chrono::milliseconds(10));
+    spdlog::logger l("test", sink);
+    for (int i = 0; i < 10; i++)
+    {
+        l.info("message {}", i);
+    }
+    for (int i = 0; i < 500 && received < 10; i++)
+    {
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+    REQUIRE(received == 10);
+    REQUIRE(sink->dropped_messages() == 0);
+}
+
 #ifdef SPDLOG_WCHAR_TO_UTF8_SUPPORT
 
 TEST_CASE("wchar_api", "[stdout]")
@@ -34,3 +34,42 @@ TEST_CASE("time_point1", "[time_point log_msg]")
     REQUIRE(lines[8] != lines[9]);
     spdlog::drop_all();
 }
+
+TEST_CASE("tsc_clock", "[time_point]")
+{
+    using std::chrono::duration_cast;
+    using std::chrono::milliseconds;
+
+    spdlog::details::tsc_clock clock;
+    auto prev = clock.now();
+    for (int i = 0; i < 1000; i++)
+    {
+        auto tp = clock.now();
+        REQUIRE(tp >= prev);
+        prev = tp;
+    }
+    auto diff = duration_cast<milliseconds>(clock.now() - spdlog::log_clock::now()).count();
+    REQUIRE(std::abs(diff) < 10);
+
+    std::this_thread::sleep_for(milliseconds(20));
+    auto before_resync = clock.now();
+    clock.resync();
+    REQUIRE(clock.now() >= before_resync);
+    diff = duration_cast<milliseconds>(clock.now() - spdlog::log_clock::now()).count();
+    REQUIRE(std::abs(diff) < 10);
+}
+
+TEST_CASE("clock_source", "[time_point]")
+{
+    using std::chrono::duration_cast;
+    using std::chrono::milliseconds;
+
+    for (auto source : {spdlog::clock_source::tsc, spdlog::clock_source::coarse, spdlog::clock_source::system})
+    {
+        spdlog::set_clock_source(source);
+        REQUIRE(spdlog::details::os::get_clock_source() == source);
+        spdlog::details::log_msg msg{spdlog::source_loc{}, "test_logger", spdlog::level::info, "message"};
+        auto diff = duration_cast<milliseconds>(msg.time - spdlog::log_clock::now()).count();
+        REQUIRE(std::abs(diff) < 50);
+    }
+}